@@ -0,0 +1,134 @@
+/***************************************************************************************************
+ * @brief Arena for objects that all have the same lifetime
+ * @file Arena.h
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#ifndef ARENA_H_
+#define ARENA_H_
+
+#include <vector>
+#include <new>
+#include <stddef.h>
+#include <stdint.h>
+
+//! Default size of the blocks the arena gets from the heap
+#define ARENA_BLOCK_SIZE (1 << 20)
+
+/**
+ * Memory for objects that die together, for example all samples of one episode. Allocation bumps a
+ * pointer in the current block, and when that one is full the next block is taken. Individual objects
+ * are never freed and their destructors are not called. Release() makes all memory available again at
+ * once, in O(1), and keeps the blocks for the next episode. So, objects in the arena should only own
+ * memory that is also in the arena.
+ *
+ * A path that is itself created in the arena, with arena.New<SensorimotorPath>(ArenaAllocator<
+ * SensationActionPair*>(&arena)), is never destructed, so not even its list is traversed at the end.
+ */
+class Arena {
+public:
+	Arena(size_t block_size = ARENA_BLOCK_SIZE);
+
+	//! Returns the blocks to the heap
+	~Arena();
+
+	//! Memory for size bytes, aligned at align (a power of two)
+	inline void *Allocate(size_t size, size_t align = sizeof(void*)) {
+		uintptr_t p = (current + align - 1) & ~(uintptr_t)(align - 1);
+		if (p + size > end) return Grow(size, align);
+		current = p + size;
+		return (void*)p;
+	}
+
+	//! Construct an object in the arena
+	template<typename T>
+	inline T *New() { return new (Allocate(sizeof(T), __alignof__(T))) T(); }
+
+	//! Construct an object with one argument for its constructor
+	template<typename T, typename A>
+	inline T *New(const A &arg) { return new (Allocate(sizeof(T), __alignof__(T))) T(arg); }
+
+	//! Forget about everything that has been allocated, the blocks are reused
+	void Release();
+
+	//! Number of bytes in the blocks
+	size_t getCapacity() const;
+protected:
+	//! Continue in the next block, get one from the heap if there is none
+	void *Grow(size_t size, size_t align);
+private:
+	//! The blocks, and their sizes
+	std::vector<char*> blocks;
+	std::vector<size_t> block_sizes;
+
+	//! Index of the block in use
+	size_t block;
+
+	//! Next free byte in the block in use, and its end
+	uintptr_t current, end;
+
+	//! Size of a new block (unless a larger object is requested)
+	size_t block_size;
+};
+
+/**
+ * Allocator for the standard containers. If it is constructed without arena (the default) it falls back
+ * to operator new and delete, so containers that do not care about arenas can ignore it. With an arena,
+ * deallocation does nothing, the memory comes back with Arena::Release().
+ */
+template<typename T>
+class ArenaAllocator {
+public:
+	typedef T value_type;
+	typedef T* pointer;
+	typedef const T* const_pointer;
+	typedef T& reference;
+	typedef const T& const_reference;
+	typedef size_t size_type;
+	typedef ptrdiff_t difference_type;
+
+	template<typename U>
+	struct rebind { typedef ArenaAllocator<U> other; };
+
+	ArenaAllocator(Arena *arena = NULL): arena(arena) {}
+
+	template<typename U>
+	ArenaAllocator(const ArenaAllocator<U> &other): arena(other.getArena()) {}
+
+	inline T *allocate(size_t n) {
+		if (arena != NULL) return (T*)arena->Allocate(n * sizeof(T), __alignof__(T));
+		return (T*)::operator new(n * sizeof(T));
+	}
+
+	inline void deallocate(T *p, size_t) {
+		if (arena == NULL) ::operator delete(p);
+	}
+
+	inline Arena *getArena() const { return arena; }
+
+	template<typename U>
+	inline bool operator==(const ArenaAllocator<U> &other) const { return arena == other.getArena(); }
+
+	template<typename U>
+	inline bool operator!=(const ArenaAllocator<U> &other) const { return arena != other.getArena(); }
+private:
+	Arena *arena;
+};
+
+#endif /* ARENA_H_ */
@@ -0,0 +1,81 @@
+/***************************************************************************************************
+ * @brief Values of many instances of an environment, stored channel by channel
+ * @file Batch.h
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#ifndef BATCH_H_
+#define BATCH_H_
+
+#include <vector>
+#include <assert.h>
+#include <stddef.h>
+
+//! The channels of a batch do not overlap. Loops over the instances that read one channel and
+//! write another are only vectorized if the compiler knows that, through restricted pointers.
+#if defined(__GNUC__)
+#define RESTRICT __restrict__
+#else
+#define RESTRICT
+#endif
+
+/**
+ * The values of one channel (a sensor, actuator or state value) for M instances, for a number of
+ * channels, in structure-of-arrays form: the M values of a channel are contiguous. A loop over the
+ * instances then reads and writes consecutive memory and can be vectorized.
+ */
+template<typename T>
+class Batch {
+public:
+	Batch(size_t nof_instances = 0, size_t nof_channels = 0) {
+		resize(nof_instances, nof_channels);
+	}
+
+	//! All values are reset to T()
+	inline void resize(size_t nof_instances, size_t nof_channels) {
+		this->nof_instances = nof_instances;
+		this->nof_channels = nof_channels;
+		values.assign(nof_instances * nof_channels, T());
+	}
+
+	//! Number of instances
+	inline size_t size() const { return nof_instances; }
+
+	inline size_t getNofChannels() const { return nof_channels; }
+
+	//! The values of channel c, one per instance
+	inline T *channel(size_t c) { assert (c < nof_channels); return &values[c * nof_instances]; }
+
+	inline const T *channel(size_t c) const {
+		assert (c < nof_channels); return &values[c * nof_instances]; }
+
+	//! Value of channel c for instance m
+	inline T & operator()(size_t m, size_t c) { return values[c * nof_instances + m]; }
+
+	inline const T & operator()(size_t m, size_t c) const { return values[c * nof_instances + m]; }
+private:
+	//! Channel after channel
+	std::vector<T> values;
+
+	size_t nof_instances;
+
+	size_t nof_channels;
+};
+
+#endif /* BATCH_H_ */
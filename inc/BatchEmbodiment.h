@@ -0,0 +1,159 @@
+/***************************************************************************************************
+ * @brief Many instances of an environment and its systems, stepped in lockstep
+ * @file BatchEmbodiment.h
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#ifndef BATCHEMBODIMENT_H_
+#define BATCHEMBODIMENT_H_
+
+#include <Structs.h>
+#include <Batch.h>
+
+#include <vector>
+#include <assert.h>
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * A system that acts in M instances of an environment at once. There is one virtual call per tick
+ * for all instances, the loops over the instances are up to the implementation.
+ */
+template<typename T>
+class BatchSystem {
+public:
+	virtual ~BatchSystem() {}
+
+	//! Act in every instance, the observations and actions have a channel per value, the rewards
+	//! are one per instance. If done is set for an instance, it has just started a new episode.
+	virtual void Tick(const Batch<T> &observations, const AP_TYPE *rewards, const uint8_t *done,
+			Batch<T> &actions) = 0;
+
+	//! Restart all instances
+	virtual void Restart(size_t nof_instances) = 0;
+};
+
+/**
+ * M independent instances of an environment with the same systems in each of them, stepped in one
+ * call. The observations, actions and rewards are batches with one entry per system. Every instance
+ * should draw from its own random stream. An instance of which the episode has ended is reset in the
+ * same tick: its done flag is set and its observations are the first of the next episode.
+ */
+template<typename T>
+class BatchEnvironment {
+public:
+	virtual ~BatchEnvironment() {}
+
+	//! Number of observation values per system
+	virtual size_t getObservationSize() const = 0;
+
+	//! Number of action values per system
+	virtual size_t getActionSize() const = 0;
+
+	//! Start all instances, there is a batch of observations for every system
+	virtual void Init(size_t nof_instances, std::vector<Batch<T> > &observations) = 0;
+
+	//! Step all instances, rewards has a channel per system
+	virtual void Tick(const std::vector<Batch<T> > &actions, std::vector<Batch<T> > &observations,
+			Batch<AP_TYPE> &rewards, uint8_t *done) = 0;
+};
+
+/**
+ * The sensorimotor loop of the Embodiment, for a batch of instances. The buffers are allocated when
+ * coupling, not while ticking.
+ */
+template<typename T>
+class BatchEmbodiment {
+public:
+	BatchEmbodiment(): environment(NULL), nof_instances(0), t(0) {}
+
+	//! Couple the systems with M instances of the environment and restart
+	void Couple(BatchEnvironment<T> &env, const std::vector<BatchSystem<T>*> &systems,
+			size_t nof_instances) {
+		assert (nof_instances > 0);
+		environment = &env;
+		this->systems = systems;
+		this->nof_instances = nof_instances;
+		observations.assign(systems.size(), Batch<T>(nof_instances, env.getObservationSize()));
+		actions.assign(systems.size(), Batch<T>(nof_instances, env.getActionSize()));
+		rewards.resize(nof_instances, systems.size());
+		done.assign(nof_instances, 0);
+		Restart();
+	}
+
+	//! The systems act in all instances, then all instances are stepped
+	void Tick() {
+		for (size_t i = 0; i < systems.size(); ++i) {
+			systems[i]->Tick(observations[i], rewards.channel(i), &done[0], actions[i]);
+		}
+		environment->Tick(actions, observations, rewards, &done[0]);
+		++t;
+	}
+
+	//! Restart all instances of the environment and the systems
+	void Restart() {
+		environment->Init(nof_instances, observations);
+		for (size_t i = 0; i < systems.size(); ++i) {
+			systems[i]->Restart(nof_instances);
+		}
+		rewards.resize(nof_instances, systems.size());
+		done.assign(nof_instances, 0);
+		t = 0;
+	}
+
+	inline size_t getNofInstances() const { return nof_instances; }
+
+	//! The observations system i will receive at the next tick
+	inline const Batch<T> & GetObservations(int i) const { return observations[i]; }
+
+	//! The last actions of system i
+	inline const Batch<T> & GetActions(int i) const { return actions[i]; }
+
+	//! The last rewards, a channel per system
+	inline const Batch<AP_TYPE> & GetRewards() const { return rewards; }
+
+	//! Per instance if it has been reset at the last tick
+	inline const uint8_t * GetDone() const { return &done[0]; }
+
+	//! Number of ticks since the last restart
+	inline long int GetTime() const { return t; }
+private:
+	BatchEnvironment<T> *environment;
+
+	std::vector<BatchSystem<T>*> systems;
+
+	size_t nof_instances;
+
+	//! Per system, all instances
+	std::vector<Batch<T> > observations;
+
+	//! Per system, all instances
+	std::vector<Batch<T> > actions;
+
+	//! A channel per system
+	Batch<AP_TYPE> rewards;
+
+	//! Per instance
+	std::vector<uint8_t> done;
+
+	//! Number of ticks since the last restart
+	long int t;
+};
+
+#endif /* BATCHEMBODIMENT_H_ */
@@ -0,0 +1,178 @@
+/***************************************************************************************************
+ * @brief Sensorimotor path with contiguous storage
+ * @file ColumnarPath.h
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#ifndef COLUMNARPATH_H_
+#define COLUMNARPATH_H_
+
+#include <Structs.h>
+
+#include <array>
+#include <vector>
+#include <assert.h>
+#include <stddef.h>
+
+/**
+ * A read-only view on samples in row-major matrices, owned by someone else (a ColumnarPath or a
+ * TraceRecorder). It is only valid as long as the owner does not change.
+ */
+class ColumnarView {
+public:
+	ColumnarView(): observations(NULL), actions(NULL), times(NULL), nof_samples(0),
+			observation_size(0), action_size(0) {}
+
+	ColumnarView(const AP_TYPE *observations, const AP_TYPE *actions, const long int *times,
+			size_t size, int observation_size, int action_size): observations(observations),
+			actions(actions), times(times), nof_samples(size), observation_size(observation_size),
+			action_size(action_size) {}
+
+	inline int getObservationSize() const { return observation_size; }
+
+	inline int getActionSize() const { return action_size; }
+
+	inline size_t size() const { return nof_samples; }
+
+	inline bool empty() const { return !nof_samples; }
+
+	inline const AP_TYPE *observation(size_t i) const { return observations + i * observation_size; }
+
+	inline const AP_TYPE *action(size_t i) const { return actions + i * action_size; }
+
+	inline long int time(size_t i) const { return times[i]; }
+
+	inline const AP_TYPE *getObservations() const { return observations; }
+
+	inline const AP_TYPE *getActions() const { return actions; }
+
+	inline const long int *getTimes() const { return times; }
+private:
+	const AP_TYPE *observations;
+
+	const AP_TYPE *actions;
+
+	const long int *times;
+
+	size_t nof_samples;
+
+	int observation_size;
+
+	int action_size;
+};
+
+/**
+ * The same information as a SensorimotorPath, but instead of a list of pointers to pairs, each with
+ * two vectors of its own, there is one matrix with all observations, one with all actions, and one
+ * column with the time stamps. The matrices are row-major, so the observation at time index i is
+ * contiguous, and the values of one sensor are "getObservationSize()" apart. For the estimators
+ * this means no pointer chasing, and per sample there is no overhead at all.
+ *
+ * The dimensions of observations and actions are fixed for the entire path.
+ */
+class ColumnarPath {
+public:
+	ColumnarPath(int observation_size = 0, int action_size = 0);
+
+	~ColumnarPath();
+
+	//! Set the dimensions, this also clears the path
+	void setDimensions(int observation_size, int action_size);
+
+	inline int getObservationSize() const { return observation_size; }
+
+	inline int getActionSize() const { return action_size; }
+
+	//! Append a sample, observation and action should have the dimensions of the path
+	inline void push_back(const AP_TYPE *observation, const AP_TYPE *action, long int t) {
+		observations.insert(observations.end(), observation, observation + observation_size);
+		actions.insert(actions.end(), action, action + action_size);
+		times.push_back(t);
+	}
+
+	void push_back(const Observation &observation, const Action &action, long int t);
+
+	//! Append a sample of fixed dimensions
+	template<size_t O, size_t A>
+	inline void push_back(const std::array<AP_TYPE, O> &observation,
+			const std::array<AP_TYPE, A> &action, long int t) {
+		assert (observation_size == (int)O && action_size == (int)A);
+		push_back(observation.data(), action.data(), t);
+	}
+
+	void push_back(const SensationActionPair &pair);
+
+	//! Replace the content by that of a list-based path (dimensions are taken from its front)
+	void assign(const SensorimotorPath &path);
+
+	//! Room for n samples without reallocation
+	void reserve(size_t n);
+
+	//! Make room for exactly n samples, to be filled through the matrices
+	void resize(size_t n);
+
+	void clear();
+
+	inline size_t size() const { return times.size(); }
+
+	inline bool empty() const { return times.empty(); }
+
+	//! The observation at index i
+	inline const AP_TYPE *observation(size_t i) const {
+		return observations.data() + i * observation_size; }
+
+	//! The action at index i
+	inline const AP_TYPE *action(size_t i) const { return actions.data() + i * action_size; }
+
+	//! The time at index i
+	inline long int time(size_t i) const { return times[i]; }
+
+	//! The observation matrix, size() rows of getObservationSize() values
+	inline const AP_TYPE *getObservations() const { return observations.data(); }
+
+	//! The action matrix, size() rows of getActionSize() values
+	inline const AP_TYPE *getActions() const { return actions.data(); }
+
+	//! The time column
+	inline const long int *getTimes() const { return times.data(); }
+
+	//! The matrices and the time column to be written to
+	inline AP_TYPE *getObservations() { return observations.data(); }
+
+	inline AP_TYPE *getActions() { return actions.data(); }
+
+	inline long int *getTimes() { return times.data(); }
+
+	//! A view on all samples, till the next change of the path
+	inline ColumnarView getView() const {
+		return ColumnarView(observations.data(), actions.data(), times.data(), size(),
+				observation_size, action_size); }
+private:
+	int observation_size;
+
+	int action_size;
+
+	std::vector<AP_TYPE> observations;
+
+	std::vector<AP_TYPE> actions;
+
+	std::vector<long int> times;
+};
+
+#endif /* COLUMNARPATH_H_ */
@@ -0,0 +1,137 @@
+/***************************************************************************************************
+ * @brief Open-addressing hash table that counts 64-bit keys
+ * @file CountTable.h
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#ifndef COUNTTABLE_H_
+#define COUNTTABLE_H_
+
+#include <Structs.h>
+
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+//! All bits set is never a valid key, it marks an empty slot
+#define COUNTTABLE_EMPTY_KEY UINT64_MAX
+
+/**
+ * A histogram over a huge alphabet, of which only a fraction of the symbols occurs. Keys and counts
+ * are stored in two flat arrays, the capacity is a power of two and collisions are resolved by
+ * linear probing. So, an increment is a multiplication, a shift, and in most cases a single cache
+ * line. The table doubles when it gets more than half full. Entries are never removed, only the
+ * entire table can be cleared.
+ */
+class CountTable {
+public:
+	CountTable() { Clear(16); }
+
+	//! Empty the table, with room for at least "expected" keys without growing
+	void Clear(size_t expected = 16) {
+		size_t capacity = 16;
+		shift = 60;
+		while (capacity < 2 * expected) {
+			capacity <<= 1;
+			--shift;
+		}
+		keys.assign(capacity, COUNTTABLE_EMPTY_KEY);
+		counts.assign(capacity, 0);
+		mask = capacity - 1;
+		nof_keys = 0;
+	}
+
+	//! Count key once
+	inline void Increment(uint64_t key) {
+		size_t i = Find(key);
+		if (keys[i] == COUNTTABLE_EMPTY_KEY) {
+			keys[i] = key;
+			if (++nof_keys * 2 > keys.size()) {
+				++counts[i];
+				Grow();
+				return;
+			}
+		}
+		++counts[i];
+	}
+
+	//! The count of key, 0 if it did not occur
+	inline FREQ_TYPE Count(uint64_t key) const {
+		size_t i = Find(key);
+		return (keys[i] == COUNTTABLE_EMPTY_KEY) ? 0 : counts[i];
+	}
+
+	//! Number of distinct keys
+	inline size_t size() const { return nof_keys; }
+
+	//! Append all keys and their counts (in no particular order)
+	void Export(std::vector<uint64_t> &out_keys, std::vector<FREQ_TYPE> &out_counts) const {
+		for (size_t i = 0; i < keys.size(); ++i) {
+			if (keys[i] == COUNTTABLE_EMPTY_KEY) continue;
+			out_keys.push_back(keys[i]);
+			out_counts.push_back(counts[i]);
+		}
+	}
+protected:
+	//! Fibonacci hashing, the upper bits of the product are well mixed
+	inline size_t Slot(uint64_t key) const {
+		return (size_t)((key * 0x9e3779b97f4a7c15ULL) >> shift);
+	}
+
+	//! The slot with key, or the empty slot where it should go
+	inline size_t Find(uint64_t key) const {
+		size_t i = Slot(key);
+		while (keys[i] != key && keys[i] != COUNTTABLE_EMPTY_KEY) {
+			i = (i + 1) & mask;
+		}
+		return i;
+	}
+
+	//! Double the capacity and reinsert everything
+	void Grow() {
+		std::vector<uint64_t> old_keys;
+		std::vector<FREQ_TYPE> old_counts;
+		old_keys.swap(keys);
+		old_counts.swap(counts);
+		keys.assign(2 * old_keys.size(), COUNTTABLE_EMPTY_KEY);
+		counts.assign(2 * old_keys.size(), 0);
+		mask = keys.size() - 1;
+		--shift;
+		for (size_t j = 0; j < old_keys.size(); ++j) {
+			if (old_keys[j] == COUNTTABLE_EMPTY_KEY) continue;
+			size_t i = Find(old_keys[j]);
+			keys[i] = old_keys[j];
+			counts[i] = old_counts[j];
+		}
+	}
+private:
+	std::vector<uint64_t> keys;
+
+	std::vector<FREQ_TYPE> counts;
+
+	//! Capacity - 1
+	size_t mask;
+
+	//! 64 - log2(capacity)
+	int shift;
+
+	size_t nof_keys;
+};
+
+#endif /* COUNTTABLE_H_ */
@@ -0,0 +1,117 @@
+/***************************************************************************************************
+ * @brief Counter-based random numbers, a stream per seed, instance and stream number
+ * @file CounterRandom.h
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#ifndef COUNTERRANDOM_H_
+#define COUNTERRANDOM_H_
+
+#include <Structs.h>
+
+#include <stdint.h>
+
+//! Constants of Philox4x32-10, from "Parallel random numbers: as easy as 1, 2, 3", by Salmon,
+//! Moraes, Dror and Shaw (2011)
+#define PHILOX_M0 0xD2511F53U
+#define PHILOX_M1 0xCD9E8D57U
+#define PHILOX_W0 0x9E3779B9U
+#define PHILOX_W1 0xBB67AE85U
+#define PHILOX_ROUNDS 10
+
+/**
+ * Philox4x32-10: the four counter words c0..c3 are replaced by four random words, with the key
+ * (k0, k1). Every block of output is a function of the counter and the key only, there is no
+ * state in between. It takes only multiplications, xors and adds on 32-bit words, without
+ * branches, so a loop over arrays of counters and keys is vectorized.
+ */
+inline void philox(uint32_t &c0, uint32_t &c1, uint32_t &c2, uint32_t &c3, uint32_t k0, uint32_t k1) {
+	for (int r = 0; r < PHILOX_ROUNDS; ++r) {
+		uint64_t p0 = (uint64_t)PHILOX_M0 * c0;
+		uint64_t p1 = (uint64_t)PHILOX_M1 * c2;
+		c0 = (uint32_t)(p1 >> 32) ^ c1 ^ k0;
+		c2 = (uint32_t)(p0 >> 32) ^ c3 ^ k1;
+		c1 = (uint32_t)p1;
+		c3 = (uint32_t)p0;
+		k0 += PHILOX_W0;
+		k1 += PHILOX_W1;
+	}
+}
+
+/**
+ * A stream of random numbers that belongs to one instance, e.g. of an environment, instead of to
+ * the process like drand48. The key is (seed, instance), and the n-th block of four numbers of a
+ * stream is Philox of the counter (n, stream). So instances with the same seed get independent
+ * numbers that do not depend on the order in which they draw, or on the thread, and skipping
+ * ahead is O(1). It is a plain value, a copy (or snapshot) continues with the same numbers.
+ */
+class CounterRandom {
+public:
+	CounterRandom(uint32_t seed = 0, uint32_t instance = 0, uint32_t stream = 0) {
+		Seed(seed, instance, stream);
+	}
+
+	//! Start at the first number of a stream
+	inline void Seed(uint32_t seed, uint32_t instance = 0, uint32_t stream = 0) {
+		key[0] = seed;
+		key[1] = instance;
+		this->stream = stream;
+		position = 0;
+		buffered = UINT64_MAX;
+	}
+
+	//! 32 random bits
+	inline uint32_t Bits() {
+		uint64_t block = position >> 2;
+		if (block != buffered) Generate(block);
+		return words[position++ & 3];
+	}
+
+	//! Uniform in [0,1), with 32 bits of resolution
+	inline AP_TYPE Uniform() { return Bits() * (1.0 / 4294967296.0); }
+
+	//! Skip n numbers
+	inline void Skip(uint64_t n) { position += n; }
+
+	//! Number of numbers drawn (or skipped) since seeding
+	inline uint64_t getPosition() const { return position; }
+protected:
+	inline void Generate(uint64_t block) {
+		words[0] = (uint32_t)block;
+		words[1] = (uint32_t)(block >> 32);
+		words[2] = stream;
+		words[3] = 0;
+		philox(words[0], words[1], words[2], words[3], key[0], key[1]);
+		buffered = block;
+	}
+private:
+	uint32_t key[2];
+
+	uint32_t stream;
+
+	//! Next number to draw
+	uint64_t position;
+
+	//! The block that is in words
+	uint64_t buffered;
+
+	uint32_t words[4];
+};
+
+#endif /* COUNTERRANDOM_H_ */
@@ -0,0 +1,234 @@
+/***************************************************************************************************
+ * @brief Messages between systems, over bounded channels with a latency and a bandwidth
+ * @file Coupling.h
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#ifndef COUPLING_H_
+#define COUPLING_H_
+
+#include <vector>
+#include <atomic>
+#include <assert.h>
+#include <stddef.h>
+
+//! The indices of a channel are written by different threads, they are kept a cache line apart
+#define CACHE_LINE_SIZE 64
+
+/**
+ * A one-way link from one system to another. Its clock is the tick of the embodiment, a message
+ * sent at tick t can be received from tick t + latency on, at most "bandwidth" messages per tick
+ * (0 for no limit). Messages that are not received yet stay in the channel, so a link that is
+ * used above its bandwidth gets more and more delay, till it is full and messages are dropped.
+ */
+class Channel {
+public:
+	Channel(size_t sender, size_t receiver, long int latency, size_t bandwidth);
+
+	virtual ~Channel();
+
+	//! Remove all messages, only between ticks
+	virtual void Clear() = 0;
+
+	//! Index of the sending system
+	inline size_t getSender() const { return sender; }
+
+	//! Index of the receiving system
+	inline size_t getReceiver() const { return receiver; }
+
+	//! Ticks between sending and receiving, at least 1 (a lower latency is raised to 1)
+	inline long int getLatency() const { return latency; }
+
+	//! Messages that can be received per tick, 0 if not limited
+	inline size_t getBandwidth() const { return bandwidth; }
+protected:
+	friend class Coupling;
+
+	size_t sender, receiver;
+
+	long int latency;
+
+	size_t bandwidth;
+
+	//! The tick of the coupling
+	const long int *clock;
+};
+
+/**
+ * A channel for messages of type T, as a bounded single-producer single-consumer ring buffer. The
+ * sender only writes the tail and the receiver only writes the head, so neither takes a lock, and
+ * both keep a copy of the other's index so they only touch the shared one if the ring looks full
+ * or empty. Messages are copied into slots allocated once at construction.
+ *
+ * Only the sending system may call Send and only the receiving system Receive, they can be ticked
+ * on different threads at the same time. With a latency of at least one tick, a message sent
+ * during a tick is never received during the same one, so what a system receives does not depend
+ * on the order in which the systems are ticked.
+ */
+template<typename T>
+class MessageChannel: public Channel {
+public:
+	//! The capacity is rounded up to a power of two
+	MessageChannel(size_t sender, size_t receiver, size_t capacity, long int latency,
+			size_t bandwidth): Channel(sender, receiver, latency, bandwidth) {
+		size_t size = 1;
+		while (size < capacity) size <<= 1;
+		ring.resize(size);
+		mask = size - 1;
+		Clear();
+	}
+
+	//! Returns false, and drops the message, if the channel is full
+	bool Send(const T &message) {
+		size_t t = tail.load(std::memory_order_relaxed);
+		if (t - cached_head > mask) {
+			cached_head = head.load(std::memory_order_acquire);
+			if (t - cached_head > mask) {
+				++dropped;
+				return false;
+			}
+		}
+		Message &slot = ring[t & mask];
+		slot.tick = *clock;
+		slot.payload = message;
+		tail.store(t + 1, std::memory_order_release);
+		return true;
+	}
+
+	//! Returns false if no message is due, or if the bandwidth of this tick has been used
+	bool Receive(T &message) {
+		if (receive_tick != *clock) {
+			receive_tick = *clock;
+			received = 0;
+		}
+		if (bandwidth && received == bandwidth) return false;
+		size_t h = head.load(std::memory_order_relaxed);
+		if (h == cached_tail) {
+			cached_tail = tail.load(std::memory_order_acquire);
+			if (h == cached_tail) return false;
+		}
+		const Message &slot = ring[h & mask];
+		if (slot.tick + latency > *clock) return false;
+		message = slot.payload;
+		head.store(h + 1, std::memory_order_release);
+		++received;
+		return true;
+	}
+
+	//! Messages in the channel, due or not (exact only between ticks)
+	inline size_t size() const {
+		return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire); }
+
+	inline size_t getCapacity() const { return mask + 1; }
+
+	//! Messages that did not fit, counted by the sender
+	inline unsigned long int getNofDropped() const { return dropped; }
+
+	void Clear() {
+		head.store(0, std::memory_order_relaxed);
+		tail.store(0, std::memory_order_relaxed);
+		cached_head = cached_tail = 0;
+		receive_tick = -1;
+		received = 0;
+		dropped = 0;
+	}
+private:
+	struct Message {
+		//! Tick at which it was sent
+		long int tick;
+
+		T payload;
+	};
+
+	std::vector<Message> ring;
+
+	//! Capacity minus one
+	size_t mask;
+
+	//! Next message to receive, written by the receiver
+	alignas(CACHE_LINE_SIZE) std::atomic<size_t> head;
+
+	//! The receiver's copy of the tail
+	size_t cached_tail;
+
+	//! Tick of which "received" messages are counted
+	long int receive_tick;
+
+	size_t received;
+
+	//! Next free slot, written by the sender
+	alignas(CACHE_LINE_SIZE) std::atomic<size_t> tail;
+
+	//! The sender's copy of the head
+	size_t cached_head;
+
+	unsigned long int dropped;
+};
+
+/**
+ * The coupling between system and environment can e.g. be in the form of a point-wise
+ * location if the environment is a 2D or 3D world. It can be extended spatially, it can
+ * involve colors, etc. Each subsequent Action will render updating the body in the
+ * environment more involved. Hence, it is smart to keep this Coupling simple.
+ *
+ * Besides that, systems can be coupled with each other through message channels. A channel is
+ * connected before the embodiment is coupled, and the two systems get their end of it from the
+ * experimenter, e.g. by a setter. The embodiment advances the clock of the coupling before it
+ * ticks the systems, and empties the channels at a restart. The channels are owned by the
+ * coupling, which therefore cannot be copied.
+ */
+class Coupling {
+public:
+	Coupling();
+
+	~Coupling();
+
+	//! A channel from system "sender" to system "receiver", for messages of type T
+	template<typename T>
+	MessageChannel<T> & Connect(size_t sender, size_t receiver, size_t capacity = 64,
+			long int latency = 1, size_t bandwidth = 0) {
+		MessageChannel<T> *channel = new MessageChannel<T>(sender, receiver, capacity, latency,
+				bandwidth);
+		channel->clock = &tick;
+		channels.push_back(channel);
+		return *channel;
+	}
+
+	inline size_t getNofChannels() const { return channels.size(); }
+
+	inline Channel & getChannel(size_t i) { return *channels[i]; }
+
+	//! Set by the embodiment before the systems are ticked
+	inline void setTick(long int t) { tick = t; }
+
+	inline long int getTick() const { return tick; }
+
+	//! Empty all channels and reset the clock
+	void Clear();
+private:
+	Coupling(const Coupling &);
+
+	Coupling & operator=(const Coupling &);
+
+	std::vector<Channel*> channels;
+
+	long int tick;
+};
+
+#endif /* COUPLING_H_ */
@@ -27,19 +27,30 @@
 
 #include <Environment.h>
 #include <System.h>
+#include <Coupling.h>
+#include <TraceRecorder.h>
+#include <TraceFile.h>
+#include <WorkerPool.h>
 
 class System;
 class Environment;
 
 /**
- * The coupling between system and environment can e.g. be in the form of a point-wise
- * location if the environment is a 2D or 3D world. It can be extended spatially, it can
- * involve colors, etc. Each subsequent Action will render updating the body in the
- * environment more involved. Hence, it is smart to keep this Coupling simple.
- *
- * By default the coupling structure is empty
+ * What is saved of an embodiment: the environment and the systems, and what they exchange.
  */
-struct Coupling { };
+struct EmbodimentSnapshot {
+	Snapshot environment;
+
+	std::vector<Snapshot> systems;
+
+	std::vector<Observation> observations;
+
+	std::vector<Action> actions;
+
+	std::vector<State> states;
+
+	long int t;
+};
 
 //struct EmbodiedSystem {
 //	//! The embodiment system does have a last action
@@ -56,17 +67,105 @@ struct Coupling { };
  */
 class Embodiment {
 public:
+	Embodiment();
+
+	//! The observation, action and state buffers are owned by the embodiment
+	~Embodiment();
+
 	//! Embodiment ticks the system first and then the environment (just convention)
 	void Tick();
 
-	//! Couple in general the system with the environment
-	void Couple(Environment &env, AP_SYSTEMS &systems, Coupling coupling);
+	//! Couple in general the system with the environment, if the environment knows the sizes of
+	//! the observations, actions and states, the buffers get their final size here, the channels
+	//! between the systems are delivered on the clock of the embodiment
+	void Couple(Environment &env, AP_SYSTEMS &systems, Coupling &coupling);
 
+	//! Restart environment and systems, everything in the arena is released
 	void Restart();
+
+	//! The state of the environment, the systems and the last observations and actions, to branch
+	//! from, e.g. for lookahead; empty if the environment or a system does not support snapshots
+	Snapshot Save() const;
+
+	//! Go back to a saved state, also of another embodiment with an environment and systems of the
+	//! same types (a fork), false if that is not possible
+	bool Restore(const Snapshot &snapshot);
+
+	//! For samples (e.g. a SensorimotorPath) that should live as long as the current episode
+	inline Arena & getArena() { return arena; }
+
+	//! The last action of system i
+	inline const Action & GetAction(int i) const { return *actions[i]; }
+
+	//! The observation system i will receive at the next tick
+	inline const Observation & GetObservation(int i) const { return *observations[i]; }
+
+	//! Record the observation and action of every system at every tick, of the last "capacity"
+	//! ticks, 0 switches recording off
+	void SetRecording(size_t capacity);
+
+	//! The recorded observations and actions of system i
+	inline const TraceRecorder & GetTrace(int i) const { return traces[i]; }
+
+	//! Stream the observations and actions of system i to a trace file (NULL to stop), the writer
+	//! stays owned by the caller
+	void SetTraceWriter(int i, TraceWriter *writer);
+
+	//! Number of ticks since the last restart
+	inline long int GetTime() const { return t; }
+
+	//! Tick the systems in parallel on this many threads (including the calling one), 1 ticks them
+	//! one after the other. The systems should not share state they change in Tick. The results do
+	//! not depend on the number of threads. By default (0) one thread per hardware thread, which
+	//! keeps the serial path on a machine with a single hardware thread.
+	void SetThreads(size_t nof_threads = 0);
+
+	inline size_t GetThreads() const { return pool.getNofWorkers(); }
+
+	//! Step the environment on a thread of its own, at the same time as the systems act. The
+	//! environment then gets the actions of one tick earlier: while the systems act on observation
+	//! o(t), the environment steps with a(t-1). After a restart a(-1) is all zeros. This needs an
+	//! environment that gives the sizes of its buffers.
+	void SetPipelined(bool pipelined);
+
+	inline bool IsPipelined() const { return environment_thread.isRunning(); }
+protected:
+	//! Tick all systems, in order or on the worker pool
+	void TickSystems();
+
+	//! Tick system i, and record the observation and action
+	void TickSystem(size_t i);
+
+	//! Pipelined step of the environment, with the delayed actions into the next observations
+	void TickEnvironment();
+
+	//! Delete the buffers
+	void Decouple();
 private:
+	//! The job for the worker pool, a tick of every system
+	class SystemTicks: public WorkerJob {
+	public:
+		SystemTicks(Embodiment *embodiment): embodiment(embodiment) {}
+		void Execute(size_t i) { embodiment->TickSystem(i); }
+	private:
+		Embodiment *embodiment;
+	};
+
+	//! The job for the environment thread
+	class EnvironmentTick: public WorkerJob {
+	public:
+		EnvironmentTick(Embodiment *embodiment): embodiment(embodiment) {}
+		void Execute(size_t i) { embodiment->TickEnvironment(); }
+	private:
+		Embodiment *embodiment;
+	};
+
 	//! The environment is referenced through embodiment, but not part of it
 	Environment *environment;
 
+	//! The channels between the systems, if any
+	Coupling *coupling;
+
 	//! There are multiple systems in one environment
 	AP_SYSTEMS systems;
 
@@ -78,6 +177,45 @@ private:
 
 	//! And every system does have state that it cannot control
 	AP_MAS_STATE states;
+
+	//! The second set of buffers when pipelined: the actions of the previous tick, for the
+	//! environment, and the observations it is producing for the next tick
+	AP_MAS_ACTION delayed_actions;
+	AP_MAS_OBSERVATION next_observations;
+
+	//! The rewards of the last environment step, read before a tick
+	std::vector<AP_TYPE> rewards;
+
+	//! The buffers have been given their size at coupling, they are overwritten in place and never
+	//! cleared, so a tick does not allocate
+	bool fixed_buffers;
+
+	//! Memory that is released in one go at the end of an episode
+	Arena arena;
+
+	//! Number of ticks since the last restart
+	long int t;
+
+	//! Number of ticks recorded per system
+	size_t record_capacity;
+
+	//! Per system the last observations and actions
+	std::vector<TraceRecorder> traces;
+
+	//! Per system a trace file, or NULL
+	std::vector<TraceWriter*> writers;
+
+	//! Threads for the systems, none by default
+	WorkerPool pool;
+
+	//! Ticks the systems on the pool
+	SystemTicks system_ticks;
+
+	//! Steps the environment, when pipelined
+	WorkerThread environment_thread;
+
+	//! Steps the environment on its thread
+	EnvironmentTick environment_tick;
 };
 
 
@@ -0,0 +1,110 @@
+/***************************************************************************************************
+ * @brief Entropy estimators that operate on histograms of counts
+ * @file Entropy.h
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#ifndef ENTROPY_H_
+#define ENTROPY_H_
+
+#include <Structs.h>
+#include <Histogram.h>
+
+#include <stddef.h>
+
+enum EntropyEstimator {
+	EE_PLUGIN,						//< maximum likelihood estimate, biased downwards
+	EE_MILLER_MADOW,				//< plug-in estimate + (K-1)/2N correction
+	// "Entropy and inference, revisited", by Nemenman, Shafee, Bialek (2002)
+	EE_NSB,							//< Bayesian estimate, mixture of Dirichlet priors
+	EE_COUNT
+};
+
+//! The n*log(n) values for small counts are looked up, larger counts are calculated
+#define NLOGN_TABLE_SIZE 4096
+
+/**
+ * Natural logarithm over an array, y[i] = ln(x[i]). The values need to be positive and finite. The
+ * loop is written without branches so the compiler can vectorize it, it is accurate up to ~1e-12.
+ */
+void vlog(const PROB_TYPE *x, PROB_TYPE *y, size_t n);
+
+/**
+ ***************************************************************************************************
+ * The entropy of a discrete random variable, estimated from a histogram of counts. A plug-in
+ * estimate on normalized frequencies underestimates the entropy, severely so if the number of
+ * samples is not much larger than the number of bins. This is exactly the case for joint
+ * sensorimotor symbols, hence the bias corrections.
+ *
+ * The histograms can be sparse. Bins with a count of zero do not contribute to the plug-in or
+ * Miller-Madow estimates and may be left out, as long as the size of the alphabet is passed along
+ * (the NSB estimator needs it). All results are in bits.
+ ***************************************************************************************************
+ */
+class Entropy {
+public:
+	Entropy();
+
+	~Entropy();
+
+	//! Entropy of a histogram with "size" bins, "alphabet_size" is the number of possible symbols,
+	//! which can be larger than "size" if zero bins are left out (0 means equal to "size")
+	PROB_TYPE calculate(const FREQ_TYPE *counts, size_t size, size_t alphabet_size = 0);
+
+	//! Same, for a histogram in a standard container
+	PROB_TYPE calculate(const std::vector<FREQ_TYPE> &counts, size_t alphabet_size = 0);
+
+	//! Same, for a (dense or sparse) histogram
+	inline PROB_TYPE calculate(const Histogram &histogram) {
+		return calculate(histogram.counts, histogram.size, histogram.alphabet); }
+
+	//! Plug-in entropy of normalized probabilities, no bias correction is possible here
+	PROB_TYPE calculate(const Point &probabilities);
+
+	EntropyEstimator getEstimator() const;
+
+	void setEstimator(EntropyEstimator estimator);
+
+	//! Returns n*ln(n), from the table if possible (0 for n=0)
+	inline PROB_TYPE nlogn(FREQ_TYPE n) const {
+		return (n < NLOGN_TABLE_SIZE) ? nlogn_table[n] : n * log_slow(n); }
+protected:
+	friend class TestEntropy;
+
+	//! Sum over n*ln(n) and sum over n, both only over non-zero bins
+	void sumCounts(const FREQ_TYPE *counts, size_t size, PROB_TYPE &sum_nlogn, FREQ_TYPE &total,
+			size_t &nonzero);
+
+	//! The NSB estimate in nats
+	PROB_TYPE calcNSB(const FREQ_TYPE *counts, size_t size, size_t alphabet_size);
+
+	//! Not inlined, for counts that do not fit in the table
+	static PROB_TYPE log_slow(FREQ_TYPE n);
+private:
+	//! The selected estimator
+	EntropyEstimator estimator;
+
+	//! Precomputed n*ln(n) for n < NLOGN_TABLE_SIZE
+	std::vector<PROB_TYPE> nlogn_table;
+
+	//! Scratch buffer for counts that do not fit in the table
+	std::vector<PROB_TYPE> large_counts;
+};
+
+#endif /* ENTROPY_H_ */
@@ -26,6 +26,11 @@
 #define ENVIRONMENT_H_
 
 #include <Structs.h>
+#include <FixedSample.h>
+#include <Snapshot.h>
+
+#include <algorithm>
+#include <assert.h>
 
 //! The action vector over an entire multi-agent system
 typedef std::vector<Action*> AP_MAS_ACTION;
@@ -69,6 +74,26 @@ public:
 	//! Get last reward
 	inline AP_TYPE GetInstantaneousReward() { return instantaneous_reward; }
 
+	//! The reward channel of system i, by default all systems share the last reward
+	virtual AP_TYPE GetReward(int i) const { return instantaneous_reward; }
+
+	//! Number of observation values per system, if known before Init, else 0
+	virtual size_t GetObservationSize() const { return 0; }
+
+	//! Number of action values per system, if known before Init, else 0
+	virtual size_t GetActionSize() const { return 0; }
+
+	//! Number of state values per system, if known before Init, else 0
+	virtual size_t GetStateSize() const { return 0; }
+
+	//! The state of the environment, including that of its random number generator, for lookahead
+	//! from the current state; an empty snapshot if the environment does not support it
+	virtual Snapshot Save() const { return Snapshot(); }
+
+	//! Go back to a state saved by this or another environment of the same type, false if that is
+	//! not possible
+	virtual bool Restore(const Snapshot &snapshot) { return false; }
+
 	void Clear();
 
 	inline void SetVerbosity(const char verbosity) { this->verbosity = verbosity; }
@@ -87,6 +112,202 @@ protected:
 	char verbosity;
 };
 
+/**
+ * An environment of which the number of observation values O, action values A and state values S per
+ * system are fixed at compile time. The derived class implements:
+ *   void FixedInit(std::vector<FixedObservation> &observations, std::vector<FixedState> &states);
+ *   void FixedTick(const std::vector<FixedAction> &actions,
+ *       std::vector<FixedObservation> &observations, std::vector<FixedState> &states);
+ * with one array per system. They are called without virtual dispatch. The states are kept here, in
+ * arrays, between ticks; they are only copied to the vectors of the embodiment afterwards.
+ *
+ * A snapshot is a copy of the derived environment, so it should be copyable, and everything that
+ * is needed to continue from a state, e.g. a random number generator, should be a member. The
+ * arrays of the systems are shared with the snapshots copy-on-write.
+ */
+template<class Derived, size_t O, size_t A, size_t S>
+class FixedEnvironment: public Environment {
+public:
+	typedef typename Sample<O>::type FixedObservation;
+	typedef typename Sample<A>::type FixedAction;
+	typedef typename Sample<S>::type FixedState;
+
+	size_t GetObservationSize() const { return O; }
+	size_t GetActionSize() const { return A; }
+	size_t GetStateSize() const { return S; }
+
+	void Init(AP_MAS_OBSERVATION &observations, AP_MAS_STATE &states) {
+		fixed_actions.write().resize(observations.size());
+		fixed_observations.write().resize(observations.size());
+		fixed_states.write().resize(states.size());
+		static_cast<Derived*>(this)->FixedInit(fixed_observations.write(), fixed_states.write());
+		Export(observations, states);
+	}
+
+	void Tick(const AP_MAS_ACTION &actions, AP_MAS_OBSERVATION &observations, AP_MAS_STATE &states) {
+		std::vector<FixedAction> &fixed_actions = this->fixed_actions.write();
+		for (size_t i = 0; i < fixed_actions.size(); ++i) {
+			if (i < actions.size()) {
+				load(*actions[i], fixed_actions[i]);
+			} else {
+				std::fill(fixed_actions[i].begin(), fixed_actions[i].end(), 0);
+			}
+		}
+		static_cast<Derived*>(this)->FixedTick(fixed_actions, fixed_observations.write(),
+				fixed_states.write());
+		Export(observations, states);
+	}
+
+	//! A copy of the derived environment
+	Snapshot Save() const { return Snapshot(static_cast<const Derived&>(*this)); }
+
+	bool Restore(const Snapshot &snapshot) {
+		if (!snapshot.is<Derived>()) return false;
+		static_cast<Derived&>(*this) = snapshot.get<Derived>();
+		return true;
+	}
+
+	//! For a TypedEmbodiment, on its own buffers and without virtual dispatch
+	typedef FixedObservation TypedObservation;
+	typedef FixedAction TypedAction;
+	typedef FixedState TypedState;
 
+	inline void TypedInit(std::vector<FixedObservation> &observations, std::vector<FixedState> &states) {
+		static_cast<Derived*>(this)->FixedInit(observations, states);
+	}
+
+	inline void TypedTick(const std::vector<FixedAction> &actions,
+			std::vector<FixedObservation> &observations, std::vector<FixedState> &states) {
+		static_cast<Derived*>(this)->FixedTick(actions, observations, states);
+	}
+protected:
+	void Export(AP_MAS_OBSERVATION &observations, AP_MAS_STATE &states) {
+		for (size_t i = 0; i < observations.size(); ++i) {
+			store(fixed_observations.read()[i], *observations[i]);
+		}
+		for (size_t i = 0; i < states.size(); ++i) {
+			store(fixed_states.read()[i], *states[i]);
+		}
+	}
+private:
+	CopyOnWrite<std::vector<FixedAction> > fixed_actions;
+
+	CopyOnWrite<std::vector<FixedObservation> > fixed_observations;
+
+	CopyOnWrite<std::vector<FixedState> > fixed_states;
+};
+
+/**
+ * An environment with discrete observations, actions and states, O, A and S symbols of type T per
+ * system. The reward is not part of the observations, it is set in instantaneous_reward (or given
+ * per system by overriding GetReward). The derived class implements:
+ *   void DiscreteInit(std::vector<SymbolObservation> &observations,
+ *       std::vector<SymbolState> &states);
+ *   void DiscreteTick(const std::vector<SymbolAction> &actions,
+ *       std::vector<SymbolObservation> &observations, std::vector<SymbolState> &states);
+ * Coupled through an embodiment the symbols are converted to and from its vectors. Discrete systems
+ * with the same symbol type can instead be ticked directly on the symbols with Start and Step.
+ *
+ * Snapshots are copies of the derived environment, like those of a FixedEnvironment.
+ */
+template<class Derived, typename T, size_t O, size_t A, size_t S>
+class DiscreteEnvironment: public Environment {
+public:
+	typedef T Symbol;
+	typedef std::array<T, O> SymbolObservation;
+	typedef std::array<T, A> SymbolAction;
+	typedef std::array<T, S> SymbolState;
+
+	size_t GetObservationSize() const { return O; }
+	size_t GetActionSize() const { return A; }
+	size_t GetStateSize() const { return S; }
+
+	void Init(AP_MAS_OBSERVATION &observations, AP_MAS_STATE &states) {
+		assert (observations.size() == states.size());
+		Start(observations.size());
+		Export(observations, states);
+	}
+
+	void Tick(const AP_MAS_ACTION &actions, AP_MAS_OBSERVATION &observations, AP_MAS_STATE &states) {
+		std::vector<SymbolAction> &symbol_actions = this->symbol_actions.write();
+		assert (actions.size() == symbol_actions.size());
+		for (size_t i = 0; i < actions.size(); ++i) {
+			assert (actions[i]->size() == A);
+			for (size_t j = 0; j < A; ++j) {
+				symbol_actions[i][j] = (T)(*actions[i])[j];
+			}
+		}
+		static_cast<Derived*>(this)->DiscreteTick(symbol_actions, symbol_observations.write(),
+				symbol_states.write());
+		Export(observations, states);
+	}
+
+	//! Initial state for a number of systems, without an embodiment
+	void Start(size_t nof_systems) {
+		symbol_actions.write().resize(nof_systems);
+		symbol_observations.write().resize(nof_systems);
+		symbol_states.write().resize(nof_systems);
+		static_cast<Derived*>(this)->DiscreteInit(symbol_observations.write(), symbol_states.write());
+	}
+
+	//! Tick the discrete systems and then the environment, the systems get the observations and
+	//! rewards of the previous step, the number of systems should be as given to Start
+	template<class SystemType>
+	void Step(const std::vector<SystemType*> &systems) {
+		std::vector<SymbolAction> &symbol_actions = this->symbol_actions.write();
+		std::vector<SymbolObservation> &symbol_observations = this->symbol_observations.write();
+		assert (systems.size() == symbol_actions.size());
+		for (size_t i = 0; i < systems.size(); ++i) {
+			systems[i]->DiscreteTick(symbol_observations[i], GetReward(i), symbol_actions[i]);
+		}
+		static_cast<Derived*>(this)->DiscreteTick(symbol_actions, symbol_observations,
+				symbol_states.write());
+	}
+
+	//! The observations the systems will receive at the next tick
+	inline const std::vector<SymbolObservation> & getObservations() const {
+		return symbol_observations.read(); }
+
+	//! The last actions of the systems
+	inline const std::vector<SymbolAction> & getActions() const { return symbol_actions.read(); }
+
+	//! A copy of the derived environment
+	Snapshot Save() const { return Snapshot(static_cast<const Derived&>(*this)); }
+
+	bool Restore(const Snapshot &snapshot) {
+		if (!snapshot.is<Derived>()) return false;
+		static_cast<Derived&>(*this) = snapshot.get<Derived>();
+		return true;
+	}
+
+	//! For a TypedEmbodiment, on its own buffers and without virtual dispatch
+	typedef SymbolObservation TypedObservation;
+	typedef SymbolAction TypedAction;
+	typedef SymbolState TypedState;
+
+	inline void TypedInit(std::vector<SymbolObservation> &observations, std::vector<SymbolState> &states) {
+		static_cast<Derived*>(this)->DiscreteInit(observations, states);
+	}
+
+	inline void TypedTick(const std::vector<SymbolAction> &actions,
+			std::vector<SymbolObservation> &observations, std::vector<SymbolState> &states) {
+		static_cast<Derived*>(this)->DiscreteTick(actions, observations, states);
+	}
+protected:
+	void Export(AP_MAS_OBSERVATION &observations, AP_MAS_STATE &states) {
+		for (size_t i = 0; i < observations.size(); ++i) {
+			store(symbol_observations.read()[i], *observations[i]);
+		}
+		for (size_t i = 0; i < states.size(); ++i) {
+			store(symbol_states.read()[i], *states[i]);
+		}
+	}
+private:
+	CopyOnWrite<std::vector<SymbolAction> > symbol_actions;
+
+	CopyOnWrite<std::vector<SymbolObservation> > symbol_observations;
+
+	CopyOnWrite<std::vector<SymbolState> > symbol_states;
+};
 
 #endif /* ENVIRONMENT_H_ */
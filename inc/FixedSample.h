@@ -0,0 +1,98 @@
+/***************************************************************************************************
+ * @brief Observations and actions with dimensions known at compile time
+ * @file FixedSample.h
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#ifndef FIXEDSAMPLE_H_
+#define FIXEDSAMPLE_H_
+
+#include <Structs.h>
+
+#include <algorithm>
+#include <array>
+#include <vector>
+#include <assert.h>
+#include <math.h>
+#include <stddef.h>
+
+//! The dimension of a sample is only known at runtime
+#define DYNAMIC_SIZE 0
+
+/**
+ * A sample of D values. If D is known at compile time it is a std::array, which can live on the stack
+ * or in registers, and loops over it can be unrolled. With DYNAMIC_SIZE it is the vector that is used
+ * for Observation, Action and State.
+ */
+template<size_t D>
+struct Sample {
+	typedef std::array<AP_TYPE, D> type;
+};
+
+template<>
+struct Sample<DYNAMIC_SIZE> {
+	typedef std::vector<AP_TYPE> type;
+};
+
+/**
+ * Copy values into a buffer of the embodiment. If the buffer already has the right size it is
+ * overwritten in place, as it is after coupling, otherwise it gets that size.
+ */
+template<class Values, class Buffer>
+inline void store(const Values &values, Buffer &buffer) {
+	if (buffer.size() == values.size()) {
+		std::copy(values.begin(), values.end(), buffer.begin());
+	} else {
+		buffer.assign(values.begin(), values.end());
+	}
+}
+
+/**
+ * Copy the values of a buffer of the embodiment into a sample. An array of a fixed size gets at
+ * most D values, missing values are zero, so a buffer of the wrong size (e.g. an action vector
+ * given by the user) cannot write past the array. A sample of DYNAMIC_SIZE gets the size of the
+ * values.
+ */
+template<class Values, size_t D>
+inline void load(const Values &values, std::array<AP_TYPE, D> &sample) {
+	size_t n = std::min<size_t>(values.size(), D);
+	std::copy(values.begin(), values.begin() + n, sample.begin());
+	std::fill(sample.begin() + n, sample.end(), 0);
+}
+
+template<class Values>
+inline void load(const Values &values, std::vector<AP_TYPE> &sample) {
+	sample.assign(values.begin(), values.end());
+}
+
+/**
+ * Euclidean distance between two arrays. With D fixed the loop is unrolled, with DYNAMIC_SIZE the
+ * size given at runtime is used.
+ */
+template<size_t D>
+inline AP_TYPE euclideanDistance(const AP_TYPE *p0, const AP_TYPE *p1, size_t size) {
+	const size_t n = (D == DYNAMIC_SIZE) ? size : D;
+	AP_TYPE sum = 0;
+	for (size_t i = 0; i < n; ++i) {
+		sum += (p0[i] - p1[i]) * (p0[i] - p1[i]);
+	}
+	return sqrt(sum);
+}
+
+#endif /* FIXEDSAMPLE_H_ */
@@ -0,0 +1,54 @@
+/***************************************************************************************************
+ * @brief Read-only view on a histogram of counts
+ * @file Histogram.h
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#ifndef HISTOGRAM_H_
+#define HISTOGRAM_H_
+
+#include <Structs.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * A histogram does not own its counts, it points into the buffer of whoever calculated them (e.g.
+ * the RandomVariableConverter). If "symbols" is NULL the histogram is dense and the symbol of a
+ * bin is its index. Otherwise only the non-zero bins are listed, each with its symbol. In both
+ * cases the alphabet is the number of possible symbols, which is what the entropy estimators need.
+ */
+struct Histogram {
+	//! The counts per bin
+	const FREQ_TYPE *counts;
+
+	//! The symbols per bin, or NULL for a dense histogram
+	const uint64_t *symbols;
+
+	//! The number of bins in counts (and symbols)
+	size_t size;
+
+	//! The number of possible symbols, equal to size for a dense histogram
+	uint64_t alphabet;
+
+	//! Sum over all counts
+	FREQ_TYPE total;
+};
+
+#endif /* HISTOGRAM_H_ */
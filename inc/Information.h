@@ -26,6 +26,14 @@
 #define INFORMATION_H_
 
 #include <Structs.h>
+#include <Entropy.h>
+#include <Quantizer.h>
+#include <ColumnarPath.h>
+
+#include <array>
+#include <assert.h>
+#include <stdint.h>
+#include <boost/unordered_map.hpp>
 
 enum InfoType {
 	IT_EMPOWERMENT, 					// Klyubin
@@ -34,14 +42,38 @@ enum InfoType {
 	IT_FREE_ENERGY, 					// Friston, minimum bound on surprise
 	SENSORIMOTOR_ENTROPY,
 	EXCESS_ENTROPY,
+	IT_MUTUAL_INFORMATION,				// between sensor and motor symbols
 	IT_COUNT							// # of types
 };
 
+/**
+ * A histogram over symbols that keeps sum_i n_i ln(n_i) up to date. Incrementing a bin changes
+ * this sum only with (n+1)ln(n+1) - n ln(n), so the entropy can be read at any time.
+ */
+struct RunningHistogram {
+	//! Count per symbol, only symbols that occurred are stored
+	boost::unordered_map<uint64_t, FREQ_TYPE> counts;
+
+	//! The sum over n*ln(n) for all bins
+	PROB_TYPE sum_nlogn;
+
+	//! The sum over all bins
+	FREQ_TYPE total;
+
+	//! Number of possible symbols
+	uint64_t alphabet;
+};
+
 /**
  * The information metrics that can be calculated. It will need "logs" or "traces"
  * from the action values and sensor values. It is not possible to access world states
  * from the robot/system. Hence, we shouldn't use them either to calculate forms of
  * information we cannot actually access in a real system.
+ *
+ * To be used as intrinsic reward the metrics are maintained incrementally. Every new
+ * observation-action pair is binned and counted in the sensor, motor and sensorimotor
+ * histograms in O(1), after which the entropies (and mutual information) can be read
+ * in O(1) too. Only the NSB estimator needs a pass over the histograms.
  */
 class Information {
 public:
@@ -50,21 +82,120 @@ public:
 	~Information();
 
 	//! The results should be a number of bits(!)
-	int Calculate();
+	PROB_TYPE Calculate();
 
     InfoType getInfoType() const;
     void setInfoType(InfoType infoType);
 
-    inline void setSensorimotorPath(SensorimotorPath *path) {
-    	this->sensorimotor_path = path; }
+    EntropyEstimator getEstimator() const;
+    void setEstimator(EntropyEstimator estimator);
+
+    //! Attach a path, entries that are already on it are counted at the next Update()
+    void setSensorimotorPath(SensorimotorPath *path);
+
+    //! Count the entries that have been appended to the attached path since the last call
+    void Update();
+
+    //! Append a pair to the attached path and count it
+    void Append(SensationActionPair *pair);
+
+    //! Count an observation-action pair, without storing it
+    void Add(const AP_TYPE *observation, size_t observation_size, const AP_TYPE *action,
+    		size_t action_size);
+
+    inline void Add(const Observation &observation, const Action &action) {
+    	Add(observation.empty() ? NULL : &observation[0], observation.size(),
+    			action.empty() ? NULL : &action[0], action.size()); }
+
+    template<size_t O, size_t A>
+    inline void Add(const std::array<AP_TYPE, O> &observation,
+    		const std::array<AP_TYPE, A> &action) {
+    	Add(observation.data(), O, action.data(), A); }
+
+    //! Count all samples in a view, e.g. the window of a trace recorder after a Clear()
+    void Add(const ColumnarView &view);
+
+    //! Count discrete observations and actions, e.g. of SYMBOL8_TYPE, every symbol is its own bin,
+    //! so it should be smaller than the number of bins, and nothing needs to be quantized
+    template<typename T>
+    inline void AddSymbols(const T *observation, size_t observation_size, const T *action,
+    		size_t action_size) {
+    	if (!Prepare(observation_size, action_size)) return;
+    	Count(CombineSymbols(observation, observation_size), CombineSymbols(action, action_size)); }
+
+    template<typename T, size_t O, size_t A>
+    inline void AddSymbols(const std::array<T, O> &observation, const std::array<T, A> &action) {
+    	AddSymbols(observation.data(), O, action.data(), A); }
+
+    //! Forget all counts (the attached path is considered to be processed)
+    void Clear();
+
+    //! Set number of bins per sensor or actuator value, returns false once pairs have been counted
+    bool setNofBins(int nofBins);
+    int getNofBins() const;
+
+    //! Values outside of [min, max] are put in the first or last bin, returns false once pairs
+    //! have been counted
+    bool setRange(AP_TYPE min, AP_TYPE max);
+
+    //! For a range per sensor and actuator (in that order), set after the first pair is counted
+    inline Quantizer & getQuantizer() { return quantizer; }
+
+    //! The entropy of the observations in bits
+    inline PROB_TYPE getSensorEntropy() { return Uncertainty(sensor_histogram); }
+
+    //! The entropy of the actions in bits
+    inline PROB_TYPE getMotorEntropy() { return Uncertainty(motor_histogram); }
+
+    //! The joint entropy in bits
+    inline PROB_TYPE getSensorimotorEntropy() { return Uncertainty(sensorimotor_histogram); }
+
+    //! I(S;M) = H(S) + H(M) - H(S,M)
+    inline PROB_TYPE getMutualInformation() {
+    	return getSensorEntropy() + getMotorEntropy() - getSensorimotorEntropy(); }
+
+    //! Number of pairs counted
+    inline FREQ_TYPE getCount() const { return sensorimotor_histogram.total; }
 
     //! Calculate the (joint) random variables
     void CalculateJointRandomVariables();
 protected:
     int CalculateEmpowerment();
 
-    //! Random variable contains probabilities (normalized frequencies)
-    int Uncertainty(Point & var);
+    //! Random variable contains probabilities (normalized frequencies), returns bits
+    PROB_TYPE Uncertainty(Point & var);
+
+    //! Histogram of counts, bias corrected if so set in the entropy estimator, returns bits
+    PROB_TYPE Uncertainty(const std::vector<FREQ_TYPE> & counts, size_t alphabet_size = 0);
+
+    //! Entropy of a running histogram, O(1) except for the NSB estimator
+    PROB_TYPE Uncertainty(const RunningHistogram & histogram);
+
+    //! The bins of all values form one number with base nof_bins, the values are quantized as
+    //! channel first, first+1, etc. With values NULL the alphabet size, 0 if it exceeds 64 bits.
+    uint64_t GetSymbol(const AP_TYPE *values, size_t size, int first);
+
+    //! The symbols form one number with base nof_bins
+    template<typename T>
+    inline uint64_t CombineSymbols(const T *symbols, size_t size) const {
+    	uint64_t nof_bins = quantizer.getNofBins();
+    	uint64_t symbol = 0;
+    	for (size_t i = 0; i < size; ++i) {
+    		assert ((uint64_t)symbols[i] < nof_bins);
+    		symbol = symbol * nof_bins + symbols[i];
+    	}
+    	return symbol;
+    }
+
+    //! Set the alphabets when the first pair is counted, returns false if the pair cannot be
+    //! counted: the joint alphabet does not fit in 64 bits, or the sizes differ from the first pair
+    bool Prepare(size_t observation_size, size_t action_size);
+
+    //! Count a sensor and motor symbol, and their combination
+    void Count(uint64_t sensor_symbol, uint64_t motor_symbol);
+
+    //! Count the symbol and update sum over n*ln(n)
+    void Increment(RunningHistogram & histogram, uint64_t symbol);
 private:
 	InfoType info_type;
 
@@ -72,12 +203,40 @@ private:
 	//! be translated towards probabilities (by e.g. binning)
 	SensorimotorPath *sensorimotor_path;
 
+	//! Last entry of the path that has been counted
+	SensorimotorPath::iterator last_processed;
+
+	//! Number of entries of the path that have been counted
+	size_t nof_processed;
+
 	Point sensor;
 
 	Point motor;
 
 	Point sensorimotor;
 
+	//! Entropy kernels (with n*log(n) table)
+	Entropy entropy;
+
+	//! Number of bins and range per value
+	Quantizer quantizer;
+
+	//! Default range of the values
+	AP_TYPE range_min, range_max;
+
+	//! The alphabets are set for these sizes
+	bool prepared;
+
+	size_t observation_size, action_size;
+
+	//! Counts over sensor symbols
+	RunningHistogram sensor_histogram;
+
+	//! Counts over motor symbols
+	RunningHistogram motor_histogram;
+
+	//! Counts over joint sensor and motor symbols
+	RunningHistogram sensorimotor_histogram;
 };
 
 
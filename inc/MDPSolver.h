@@ -0,0 +1,124 @@
+/***************************************************************************************************
+ * @brief Value iteration, policy iteration and modified policy iteration on a transition table
+ * @file MDPSolver.h
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#ifndef MDPSOLVER_H_
+#define MDPSOLVER_H_
+
+#include <TransitionTable.h>
+
+#include <vector>
+#include <stdint.h>
+
+/**
+ * Solves a Markov decision process given as a transition table, for the discounted reward. The
+ * rows of the table are contiguous, a backup of a state is a pass over the outcomes of its actions.
+ *
+ * Value iteration sweeps over the states with Bellman backups. With Gauss-Seidel sweeps (default)
+ * a backup uses the values of the states before it in the same sweep, which converges faster and
+ * needs no second array of values. Both are contractions with factor gamma in the maximum norm,
+ * so if a sweep changes the values by at most d, they are within gamma / (1 - gamma) * d of the
+ * optimal ones. Iteration stops when this bound is below half the tolerance, the greedy policy is
+ * then tolerance-optimal. Policy iteration evaluates every policy exactly, by solving the linear
+ * system, and stops when the policy does not change. Modified policy iteration evaluates it with a
+ * few sweeps, which is often the fastest for larger problems.
+ */
+class MDPSolver {
+public:
+	MDPSolver();
+
+	//! Factor that defines in how much future reward contributes to current reward
+	inline void setDiscountFactor(AP_TYPE discount_factor) { this->discount_factor = discount_factor; }
+
+	inline AP_TYPE getDiscountFactor() const { return discount_factor; }
+
+	//! Maximum loss in value of the policy that is found
+	inline void setTolerance(AP_TYPE tolerance) { this->tolerance = tolerance; }
+
+	//! Gauss-Seidel (default) or Jacobi sweeps
+	inline void setGaussSeidel(bool gauss_seidel) { this->gauss_seidel = gauss_seidel; }
+
+	inline void setMaxIterations(int max_iterations) { this->max_iterations = max_iterations; }
+
+	//! Returns false if the maximum number of iterations has been reached first, or if the table is
+	//! not prepared or the discount factor is not in [0, 1)
+	bool ValueIteration(const TransitionTable &table);
+
+	//! Returns false if the maximum number of iterations has been reached first, or if the table is
+	//! not prepared or the discount factor is not in [0, 1)
+	bool PolicyIteration(const TransitionTable &table);
+
+	//! The same with a number of sweeps per evaluation instead of exact evaluation
+	bool ModifiedPolicyIteration(const TransitionTable &table, int sweeps = 10);
+
+	//! The values of a fixed policy, solved exactly (the number of states should be modest), returns
+	//! false if the policy does not fit the table
+	bool Evaluate(const TransitionTable &table, const std::vector<uint32_t> &policy,
+			std::vector<AP_TYPE> &values);
+
+	//! The expected discounted reward of an action, given the values of the next states
+	AP_TYPE Backup(const TransitionTable &table, const std::vector<AP_TYPE> &values, size_t state,
+			size_t action) const;
+
+	//! The value per state
+	inline const std::vector<AP_TYPE> & getValues() const { return values; }
+
+	//! The action per state
+	inline const std::vector<uint32_t> & getPolicy() const { return policy; }
+
+	//! The values are at most this far from the optimal ones (0 after policy iteration)
+	inline AP_TYPE getBound() const { return bound; }
+
+	//! Number of sweeps (or policies for policy iteration) of the last solve
+	inline int getIterations() const { return iterations; }
+protected:
+	//! Start from zero values and the first action everywhere, false for an invalid table or
+	//! discount factor
+	bool Reset(const TransitionTable &table);
+
+	//! Best action and its value, ties are broken in favor of the current action
+	AP_TYPE Improve(const TransitionTable &table, const std::vector<AP_TYPE> &values, size_t state,
+			uint32_t &action) const;
+
+	//! One sweep of Bellman backups, over all actions or with the policy, returns the largest change
+	AP_TYPE Sweep(const TransitionTable &table, bool greedy);
+private:
+	AP_TYPE discount_factor;
+
+	AP_TYPE tolerance;
+
+	bool gauss_seidel;
+
+	int max_iterations;
+
+	std::vector<AP_TYPE> values;
+
+	//! The values of the previous sweep, for Jacobi sweeps
+	std::vector<AP_TYPE> previous;
+
+	std::vector<uint32_t> policy;
+
+	AP_TYPE bound;
+
+	int iterations;
+};
+
+#endif /* MDPSOLVER_H_ */
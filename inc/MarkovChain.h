@@ -0,0 +1,95 @@
+/***************************************************************************************************
+ * @brief The Markov chain of a fixed policy: stationary distribution and exact reward curves
+ * @file MarkovChain.h
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#ifndef MARKOVCHAIN_H_
+#define MARKOVCHAIN_H_
+
+#include <TransitionTable.h>
+
+#include <vector>
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * The Markov chain that a fixed policy induces on a transition table, as a sparse matrix with a row
+ * per state (the outcomes of the action of the policy). A distribution over the states is moved a
+ * tick forward with a sparse vector-matrix product, so the expected reward at every tick follows
+ * exactly from the start, in O(ticks * outcomes) instead of by simulating many trials. The same
+ * goes for the variance of the reward, with the second moments of the rewards per state.
+ *
+ * The stationary distribution is found by power iteration on the lazy chain (I + P) / 2, which has
+ * the same stationary distribution but is not periodic, so the iteration also converges for chains
+ * that cycle. The chain should have a single closed class of states for the result to be unique.
+ */
+class MarkovChain {
+public:
+	MarkovChain();
+
+	//! The chain of a policy, an action per state, false (and an empty chain) if the table is not
+	//! prepared or the policy does not fit it
+	bool Build(const TransitionTable &table, const std::vector<uint32_t> &policy);
+
+	inline size_t size() const { return rewards.size(); }
+
+	//! The distribution a tick later
+	void Step(const std::vector<PROB_TYPE> &distribution, std::vector<PROB_TYPE> &next) const;
+
+	//! Power iteration till the distribution changes less than the tolerance (in L1 norm), starts
+	//! from the given distribution if it has the right size, else from the uniform one, false for
+	//! an empty chain
+	bool Stationary(std::vector<PROB_TYPE> &distribution, PROB_TYPE tolerance = 1e-12,
+			int max_iterations = 1000000) const;
+
+	//! Expected reward of a tick from a distribution over the states
+	AP_TYPE Mean(const std::vector<PROB_TYPE> &distribution) const;
+
+	//! Variance of the reward of a tick from a distribution over the states
+	AP_TYPE Variance(const std::vector<PROB_TYPE> &distribution) const;
+
+	//! The expected reward and its variance of "horizon" ticks: element t is that of the tick taken
+	//! from the distribution at time t, where start is the one at time 0, so element 0 is the reward
+	//! of the first tick. False if start does not have a probability per state.
+	bool RewardCurve(const std::vector<PROB_TYPE> &start, size_t horizon, std::vector<AP_TYPE> &means,
+			std::vector<AP_TYPE> &variances) const;
+
+	//! Per state the expected discounted return and its variance, till both change less than the
+	//! tolerance, false if that takes more than the maximum number of iterations or if the discount
+	//! factor is not in [0, 1)
+	bool Return(AP_TYPE discount_factor, std::vector<AP_TYPE> &values, std::vector<AP_TYPE> &variances,
+			AP_TYPE tolerance = 1e-10, int max_iterations = 1000000) const;
+
+	//! Expected reward per state
+	inline const std::vector<AP_TYPE> & getRewards() const { return rewards; }
+private:
+	//! Start of the outcomes of every state, and the end of the last one
+	std::vector<uint32_t> rows;
+
+	//! Per outcome the next state, the probability and the reward
+	std::vector<uint32_t> columns;
+	std::vector<PROB_TYPE> probabilities;
+	std::vector<AP_TYPE> outcome_rewards;
+
+	//! Per state the expected reward and the expected squared reward
+	std::vector<AP_TYPE> rewards, squared_rewards;
+};
+
+#endif /* MARKOVCHAIN_H_ */
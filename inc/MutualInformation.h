@@ -24,6 +24,12 @@
 #define MUTUALINFORMATION_H_
 
 #include <Structs.h>
+#include <ColumnarPath.h>
+#include <FixedSample.h>
+
+#include <vector>
+#include <algorithm>
+#include <assert.h>
 
 enum MIApproximation {
 	// "Estimating Mutual Information", by Kraskov, Stögbauer, Grassberger (2003)
@@ -67,6 +73,22 @@ public:
 	//! is used as a parameter
 	PROB_TYPE calculate(SensorimotorPath &path);
 
+	//! The same for samples stored in contiguous matrices, which is considerably faster
+	PROB_TYPE calculate(const ColumnarView &path);
+
+	inline PROB_TYPE calculate(const ColumnarPath &path) { return calculate(path.getView()); }
+
+	//! The same, with the number of observation values O and action values A known at compile time,
+	//! so the distance calculations are unrolled (only the kNN approximation is available)
+	template<size_t O, size_t A>
+	inline PROB_TYPE calculate(const ColumnarView &path) {
+		assert (mi_approximation == MI_K_NEAREST_NEIGHBOUR);
+		return calckNNApproximation<O, A>(path, k_in_kNN);
+	}
+
+	template<size_t O, size_t A>
+	inline PROB_TYPE calculate(const ColumnarPath &path) { return calculate<O, A>(path.getView()); }
+
 	MIApproximation getMIApproximation() const;
 
 	void setMIApproximation(MIApproximation miApproximation);
@@ -79,11 +101,18 @@ protected:
 	//! Get the kNN approximation
 	PROB_TYPE calckNNApproximation(SensorimotorPath &path, int k);
 
-	//! Calculate the distance between two points
-	AP_TYPE distance(const Point & p0, const Point & p1, DistanceMetric metric);
+	//! Get the kNN approximation, without sorting and without pointer chasing, the dimensions can be
+	//! DYNAMIC_SIZE, then those of the path are used
+	template<size_t O, size_t A>
+	PROB_TYPE calckNNApproximation(const ColumnarView &path, int k);
+
+	//! Calculate the distance between two points, for a Point and for SampleValues
+	template<typename V>
+	AP_TYPE distance(const V & p0, const V & p1, DistanceMetric metric);
 
 	//! Returns maximum distance (either between x0-x1 or between y0-y1)
-	AP_TYPE maximumNorm(const Point& x0, const Point& x1, const Point &y0, const Point &y1,
+	template<typename V>
+	AP_TYPE maximumNorm(const V& x0, const V& x1, const V &y0, const V &y1,
 			DistanceMetric metric);
 
 	//! Returns maximum distance
@@ -107,7 +136,54 @@ private:
 
 	//! The only parameter for kNN
 	int k_in_kNN;
+
+	//! Scratch buffers for the distances from one point to all others
+	std::vector<AP_TYPE> observation_distances, action_distances, joint_distances;
 };
 
+/**
+ * The same estimate as for a list-based path. For every point the distances to all other points are
+ * calculated only once, in the X and in the Y space, from contiguous rows. The distance to the k-th
+ * neighbour in the maximum norm is then selected with nth_element, in O(N) rather than sorting in
+ * O(N log N), and the neighbour counts are taken from the same buffers. The point itself is excluded
+ * by its index.
+ */
+template<size_t O, size_t A>
+PROB_TYPE MutualInformation::calckNNApproximation(const ColumnarView &path, int k) {
+	size_t N = path.size();
+	assert (k > 0 && N > (size_t)k);
+	assert (O == DYNAMIC_SIZE || path.getObservationSize() == (int)O);
+	assert (A == DYNAMIC_SIZE || path.getActionSize() == (int)A);
+	size_t observation_size = path.getObservationSize();
+	size_t action_size = path.getActionSize();
+	observation_distances.resize(N);
+	action_distances.resize(N);
+	joint_distances.resize(N - 1);
+
+	PROB_TYPE digamma_nx_ny = 0;
+	for (size_t i = 0; i < N; ++i) {
+		const AP_TYPE *x = path.observation(i);
+		const AP_TYPE *y = path.action(i);
+		for (size_t j = 0, n = 0; j < N; ++j) {
+			observation_distances[j] = euclideanDistance<O>(x, path.observation(j), observation_size);
+			action_distances[j] = euclideanDistance<A>(y, path.action(j), action_size);
+			if (j != i) {
+				joint_distances[n++] = std::max(observation_distances[j], action_distances[j]);
+			}
+		}
+		std::nth_element(joint_distances.begin(), joint_distances.begin() + (k-1),
+				joint_distances.end());
+		AP_TYPE dist = joint_distances[k-1];
+		int nx = 0, ny = 0;
+		for (size_t j = 0; j < N; ++j) {
+			// strictly less than the distance and also exclude the point itself (distance is 0)
+			nx += (observation_distances[j] < dist) && (observation_distances[j] != 0);
+			ny += (action_distances[j] < dist) && (action_distances[j] != 0);
+		}
+		digamma_nx_ny += digamma(nx+1)+digamma(ny+1);
+	}
+	digamma_nx_ny /= (PROB_TYPE)N;
+	return digamma((PROB_TYPE)k) - digamma_nx_ny + digamma((PROB_TYPE)N);
+}
 
 #endif /* MUTUALINFORMATION_H_ */
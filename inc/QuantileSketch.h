@@ -0,0 +1,97 @@
+/***************************************************************************************************
+ * @brief Streaming estimation of quantiles with bounded memory
+ * @file QuantileSketch.h
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#ifndef QUANTILESKETCH_H_
+#define QUANTILESKETCH_H_
+
+#include <Structs.h>
+
+#include <vector>
+#include <stddef.h>
+
+//! A cluster of values, represented by their mean and their number
+struct Centroid {
+	AP_TYPE mean;
+	AP_TYPE weight;
+};
+
+/**
+ ***************************************************************************************************
+ * A t-digest, see "Computing extremely accurate quantiles using t-digests" by Dunning and Ertl
+ * (2019). The values are summarized by at most a few times "compression" centroids. The centroids
+ * near the tails are kept small, so the extreme quantiles are accurate, which is what we need for
+ * heavy-tailed sensor values. New values are buffered and merged into the centroids in one sorted
+ * pass when the buffer is full.
+ *
+ * Two sketches can be merged, so a long trace can be split in shards that are summarized in
+ * parallel and combined afterwards.
+ ***************************************************************************************************
+ */
+class QuantileSketch {
+public:
+	QuantileSketch(AP_TYPE compression = 100);
+
+	~QuantileSketch();
+
+	//! Add a value (with a weight)
+	void Add(AP_TYPE value, AP_TYPE weight = 1);
+
+	//! Add a column of values, the values are "stride" apart
+	void Add(const AP_TYPE *values, size_t size, size_t stride = 1);
+
+	//! Add all values summarized by the other sketch
+	void Merge(const QuantileSketch &other);
+
+	//! The value below which a fraction q of all values lies
+	AP_TYPE Quantile(AP_TYPE q);
+
+	//! Forget everything
+	void Clear();
+
+	//! The number of values (sum over the weights)
+	inline AP_TYPE getCount() const { return total_weight; }
+
+	//! The number of centroids (after the buffer has been merged)
+	size_t getNofCentroids();
+protected:
+	//! Merge the buffer into the centroids
+	void Compress();
+
+	//! The scale function k1, the size of a centroid is limited by k(q_right) - k(q_left) <= 1
+	AP_TYPE Scale(AP_TYPE q) const;
+private:
+	AP_TYPE compression;
+
+	//! The summary, sorted by mean
+	std::vector<Centroid> centroids;
+
+	//! Values that still have to be merged
+	std::vector<Centroid> buffer;
+
+	//! The sum over all weights, also of the ones in the buffer
+	AP_TYPE total_weight;
+
+	//! The extremes, exact
+	AP_TYPE min, max;
+};
+
+#endif /* QUANTILESKETCH_H_ */
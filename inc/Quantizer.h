@@ -0,0 +1,141 @@
+/***************************************************************************************************
+ * @brief Conversion of sensor and actuator values to bin indices
+ * @file Quantizer.h
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#ifndef QUANTIZER_H_
+#define QUANTIZER_H_
+
+#include <Structs.h>
+#include <QuantileSketch.h>
+
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+//! A bin index, there can be at most MAX_NOF_BINS bins
+typedef uint16_t BIN_TYPE;
+
+#define MAX_NOF_BINS 32768
+
+enum QuantizerMode {
+	QM_EQUAL_WIDTH,			//< the range is divided in bins of equal width
+	QM_EQUAL_FREQUENCY,		//< the bin edges are quantiles, each bin gets as many values
+	QM_COUNT
+};
+
+/**
+ * Every channel (a sensor or an actuator) has its own range [min, max] which is divided in nof_bins
+ * bins of equal width. Values outside of the range are clamped, they end up in the first or last
+ * bin. The ranges can be set by hand or learned in a first pass over the data.
+ *
+ * Quantize converts an entire column of values at once. It uses SSE2 (or AVX if the compiler is
+ * allowed to) to scale, clamp and truncate several values per instruction.
+ *
+ * Equal-width bins waste resolution on heavy-tailed values. In the equal-frequency mode the bin
+ * edges are the 1/nof_bins, 2/nof_bins, ... quantiles of each channel. These are estimated in a
+ * single pass with a QuantileSketch per channel, so the data does not need to be kept or sorted.
+ * Quantizers that learned from different shards of the data can be merged.
+ */
+class Quantizer {
+public:
+	Quantizer();
+
+	~Quantizer();
+
+	//! Returns false, and keeps the bins, if the number is not in [1, MAX_NOF_BINS]
+	bool setNofBins(int nofBins);
+
+	int getNofBins() const;
+
+	void setMode(QuantizerMode mode);
+
+	inline QuantizerMode getMode() const { return mode; }
+
+	//! Set the number of channels, all with the same range, returns false for an invalid range
+	bool setChannels(int nof_channels, AP_TYPE min = 0, AP_TYPE max = 1);
+
+	inline int getNofChannels() const { return range_min.size(); }
+
+	//! Returns false, and keeps the range, if there is no such channel or max < min (or NaN)
+	bool setRange(int channel, AP_TYPE min, AP_TYPE max);
+
+	inline AP_TYPE getMin(int channel) const { return range_min[channel]; }
+
+	inline AP_TYPE getMax(int channel) const { return range_max[channel]; }
+
+	//! Set the range (or the quantiles) to that of the values in column, or extend the current
+	//! range (or quantile sketch) with them, returns false if there is no such channel or the range
+	//! is NaN
+	bool Learn(int channel, const AP_TYPE *column, size_t size, size_t stride = 1,
+			bool extend = false);
+
+	//! Add what another quantizer with the same channels learned, e.g. from another shard,
+	//! returns false if the number of channels differs
+	bool Merge(const Quantizer &other);
+
+	//! The bin edges of a channel, nof_bins-1 of them, a value equal to an edge is in the upper bin
+	inline const AP_TYPE *getEdges(int channel) const { return edges.data() + channel * (nof_bins - 1); }
+
+	//! The bin of a single value
+	inline int GetBin(int channel, AP_TYPE value) const {
+		if (mode == QM_EQUAL_FREQUENCY) return GetQuantileBin(channel, value);
+		AP_TYPE bin = (value - range_min[channel]) * scale[channel];
+		bin = (bin > 0) ? bin : 0;
+		bin = (bin < max_bin) ? bin : max_bin;
+		return (int)bin;
+	}
+
+	//! The bins of a column of values, the values are "stride" apart
+	void Quantize(int channel, const AP_TYPE *column, size_t size, BIN_TYPE *bins,
+			size_t stride = 1) const;
+protected:
+	//! The number of edges smaller than or equal to value
+	int GetQuantileBin(int channel, AP_TYPE value) const;
+
+	//! Equal-frequency version of Quantize
+	void QuantizeQuantiles(int channel, const AP_TYPE *column, size_t size, BIN_TYPE *bins,
+			size_t stride) const;
+
+	//! Derive the edges of a channel from its sketch
+	void UpdateEdges(int channel);
+private:
+	int nof_bins;
+
+	QuantizerMode mode;
+
+	//! The last bin, as floating point for clamping
+	AP_TYPE max_bin;
+
+	std::vector<AP_TYPE> range_min;
+
+	std::vector<AP_TYPE> range_max;
+
+	//! Per channel nof_bins / (max - min)
+	std::vector<AP_TYPE> scale;
+
+	//! Per channel nof_bins-1 edges, for equal-frequency bins
+	std::vector<AP_TYPE> edges;
+
+	//! Per channel a summary of the values seen by Learn
+	std::vector<QuantileSketch> sketches;
+};
+
+#endif /* QUANTIZER_H_ */
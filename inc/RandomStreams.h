@@ -0,0 +1,88 @@
+/***************************************************************************************************
+ * @brief Independent random number streams, one per instance of an environment
+ * @file RandomStreams.h
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#ifndef RANDOMSTREAMS_H_
+#define RANDOMSTREAMS_H_
+
+#include <Structs.h>
+#include <CounterRandom.h>
+
+#include <vector>
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * A counter-based stream per instance of a batch, so every instance draws its own sequence, which
+ * does not depend on the number of instances. Stream i with a seed gives the same numbers as
+ * CounterRandom(seed, i). All streams draw in lockstep: every fourth draw a block of four numbers
+ * is generated for all of them at once, in a loop over arrays of counters and keys that the
+ * compiler can vectorize, and the other draws are copies from those blocks.
+ */
+class RandomStreams {
+public:
+	RandomStreams(size_t nof_streams = 0, uint32_t seed = 0);
+
+	//! Stream i is stream 0 of instance i
+	void Seed(size_t nof_streams, uint32_t seed);
+
+	//! Restart stream i as the given stream of a seed, e.g. for a new episode, it continues at the
+	//! same place in a block as the other streams
+	void Reseed(size_t i, uint32_t seed, uint32_t stream);
+
+	inline size_t size() const { return seeds.size(); }
+
+	//! Draw from every stream, uniform in [0,1)
+	void Uniform(AP_TYPE *result);
+
+	//! Draw 32 random bits from every stream, compare them with Threshold(p) for an event with
+	//! chance p, without converting to floating point
+	void Bits(uint32_t *result);
+
+	//! Skip n draws in every stream
+	void Skip(uint64_t n);
+
+	//! The bits of a draw are below this value with probability p (up to 2^-32)
+	static uint32_t Threshold(AP_TYPE p);
+protected:
+	//! The next block of every stream
+	void Generate();
+
+	//! The next block of stream i
+	void Generate(size_t i);
+private:
+	//! Key per stream: seed and instance
+	std::vector<uint32_t> seeds, instances;
+
+	//! Stream number per stream
+	std::vector<uint32_t> numbers;
+
+	//! Next block per stream, as two 32-bit words (a 64-bit counter is not vectorized)
+	std::vector<uint32_t> counters_low, counters_high;
+
+	//! Current block of every stream, word after word
+	std::vector<uint32_t> words[4];
+
+	//! Words of the current blocks that have been drawn, 4 if none is left
+	unsigned int drawn;
+};
+
+#endif /* RANDOMSTREAMS_H_ */
@@ -26,11 +26,43 @@
 #define RANDOMVARIABLECONVERTER_H_
 
 #include <Structs.h>
-
+#include <Histogram.h>
+#include <CountTable.h>
+#include <Quantizer.h>
+#include <ColumnarPath.h>
+
+enum HistogramMode {
+	HM_AUTOMATIC,		//< dense if the estimated occupancy of the bins is high enough
+	HM_DENSE,			//< a count for every possible symbol
+	HM_SPARSE,			//< hashed counts, only for the symbols that occur
+	HM_COUNT
+};
 
 /**
  * Converts sensorimotor trajectory towards a random variable presentation. The most
  * simple way to do this conversion is by (fixed) binning.
+ *
+ * All values of an observation are binned and together form one sensor symbol, similarly
+ * for the action. The counts of the joint sensorimotor symbols and of both marginals are
+ * gathered in one pass over the path, in a single buffer. The joint counts come first and
+ * are row-major, the sensor symbol being the row and the motor symbol the column, followed
+ * by the sensor and then by the motor counts.
+ *
+ * With more than a few sensors the number of joint symbols, nof_bins^(observation size +
+ * action size), quickly becomes too large for a dense buffer. Then the bin indices of all
+ * values are packed into a 64-bit key, each in ceil(log2(nof_bins)) bits, and the keys are
+ * counted in hash tables. Afterwards the non-zero counts are copied, together with their
+ * keys, to the same kind of buffer. In automatic mode the sparse representation is chosen
+ * if less than a quarter of the dense bins can possibly be filled. A dense buffer that would be
+ * too large is never used, also not in dense mode, and when the bins do not fit in a key the keys
+ * are 64-bit hashes of the bins instead: the counts are the same, except for the rare collision,
+ * but the keys no longer tell the bins.
+ *
+ * The values are quantized channel by channel (one channel per sensor or actuator), reading
+ * them with a stride straight from the matrices of a ColumnarPath. A list-based path is first
+ * copied into such matrices. Each channel has its own range, which can be set through the
+ * quantizer or learned from the path itself. If the quantizer is set to QM_EQUAL_FREQUENCY the
+ * quantile edges are learned instead.
  */
 class RandomVariableConverter {
 public:
@@ -39,37 +71,124 @@ public:
 	~RandomVariableConverter();
 
     inline void setSensorimotorPath(SensorimotorPath *path) {
-    	this->path = path; }
+    	this->path = path; columnar_path = NULL; }
+
+    //! The same, but the path is used as is, without copying
+    inline void setSensorimotorPath(const ColumnarPath *path) {
+    	columnar_path = path; this->path = NULL; }
+
+    //! The same for a view, which should stay valid till after CalculateJointRandomVariables
+    inline void setSensorimotorPath(const ColumnarView &view) {
+    	views.assign(1, view); columnar_path = NULL; path = NULL; }
+
+    //! The same for consecutive parts of a path, e.g. the blocks of a trace file
+    inline void setSensorimotorPath(const std::vector<ColumnarView> &views) {
+    	this->views = views; columnar_path = NULL; path = NULL; }
 
 	void CalculateJointRandomVariables();
 
     int getNofBins() const;
 
+    //! Probabilities (normalized counts) over the sensor, motor and sensorimotor symbols
     Point *getMotor() const;
     Point *getSensor() const;
     Point *getSensorimotor() const;
 
-    void setNofBins(int nofBins);
+    //! The counts themselves, valid till the next call to CalculateJointRandomVariables
+    Histogram getMotorCounts() const;
+    Histogram getSensorCounts() const;
+    Histogram getSensorimotorCounts() const;
+
+    //! Returns false, and keeps the bins, if the number is not in [1, MAX_NOF_BINS]
+    bool setNofBins(int nofBins);
 //    void setSensorResolution();
+
+    //! The ranges of the sensors and actuators (in that order) can be set through the quantizer
+    inline Quantizer & getQuantizer() { return quantizer; }
+
+    //! Learn the range of every channel from the path (a first pass over every channel)
+    inline void setLearnRanges(bool learn) { learn_ranges = learn; }
+
+    HistogramMode getHistogramMode() const;
+    void setHistogramMode(HistogramMode mode);
+
+    //! If the last calculation used hashed counts
+    inline bool isSparse() const { return sparse; }
+
+    //! If the keys of the last sparse calculation were hashes of the bins
+    inline bool isHashed() const { return hashed; }
 protected:
-    int GetBin(AP_TYPE value);
+    //! Quantize the values of the path channel by channel
+    void Quantize(const std::vector<ColumnarView> & input);
+
+    //! Start of the values of a channel in a view (they are a row apart)
+    const AP_TYPE *GetColumn(const ColumnarView & view, int channel) const;
+
+    //! The bins of channels [first, last) form one number with base nof_bins
+    void GetSymbols(int first, int last, std::vector<uint64_t> & result);
+
+    //! The bins of channels [first, last) packed into a key, bits_per_bin per value
+    void GetKeys(int first, int last, std::vector<uint64_t> & result);
+
+    //! The bins of channels [first, last) hashed into a key, if they do not fit in one
+    void GetHashedKeys(int first, int last, std::vector<uint64_t> & result);
+
+    //! Count the symbols in the dense buffer
+    void CountDense(int observation_size, int action_size);
+
+    //! Count the keys in the hash tables
+    void CountSparse(int observation_size, int action_size);
+
+    //! Fill a point with normalized counts
+    void Normalize(const Histogram & histogram, Point & probabilities);
+
+    //! A view on a part of the buffer
+    Histogram GetHistogram(size_t offset, size_t size, uint64_t alphabet) const;
 private:
-    //! Set number of bins and its reciproce, the bin width
-	int nof_bins;
+	//! Per channel range and number of bins
+	Quantizer quantizer;
 
-	AP_TYPE bin_width;
+	//! Learn the ranges from the data before quantizing
+	bool learn_ranges;
 
-	//! Discrete and normalized outputs
-//	FreqVariable *sensor_bins;
+	//! Bin indices per channel, column after column
+	std::vector<BIN_TYPE> column_bins;
 
-	//! Probability of sensor values over time
-	RandomVariable *sensors_over_time;
+	//! Sensor and motor symbols (or keys) per sample
+	std::vector<uint64_t> sensor_symbols, motor_symbols;
 
-	//! Discrete and normalized outputs
-//	FreqVariable *motor_bins;
+	//! Number of bits used per bin index in a key
+	int bits_per_bin;
 
-	//! Discrete and normalized outputs
-//	FreqVariable *sensorimotor_bins;
+	//! Dense, sparse, or automatic
+	HistogramMode histogram_mode;
+
+	//! The last calculation was sparse
+	bool sparse;
+
+	//! The keys of the last sparse calculation were hashes
+	bool hashed;
+
+	//! Number of sensor symbols (rows in the joint histogram)
+	uint64_t sensor_alphabet;
+
+	//! Number of motor symbols (columns in the joint histogram)
+	uint64_t motor_alphabet;
+
+	//! Number of bins in the buffer for the joint, sensor and motor histogram
+	size_t joint_size, sensor_size, motor_size;
+
+	//! Number of pairs that have been counted
+	FREQ_TYPE nof_samples;
+
+	//! All counts: joint, sensor and motor
+	std::vector<FREQ_TYPE> bins;
+
+	//! For sparse histograms the keys that belong to the counts
+	std::vector<uint64_t> symbols;
+
+	//! Hashed counts for the sparse histograms
+	CountTable joint_table, sensor_table, motor_table;
 
 	//! Discrete and normalized outputs
 	Point *sensor;
@@ -82,6 +201,15 @@ private:
 
 	//! Input for discretization
 	SensorimotorPath *path;
+
+	//! Input for discretization, if set instead of path
+	const ColumnarPath *columnar_path;
+
+	//! Input for discretization, if neither path is set
+	std::vector<ColumnarView> views;
+
+	//! A list-based path is copied in here
+	ColumnarPath path_copy;
 };
 
 #endif /* RANDOMVARIABLECONVERTER_H_ */
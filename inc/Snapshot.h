@@ -0,0 +1,86 @@
+/***************************************************************************************************
+ * @brief Snapshots of the state of environments, systems and embodiments, shared copy-on-write
+ * @file Snapshot.h
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#ifndef SNAPSHOT_H_
+#define SNAPSHOT_H_
+
+#include <memory>
+#include <typeinfo>
+#include <assert.h>
+
+/**
+ * A value that is shared by copies, e.g. by an object and the snapshots of it, till one of them
+ * writes to it. Only then it is copied, so taking a snapshot of a large state is O(1), and so is
+ * going back to it; the price is one copy at the first write afterwards. Writing to a value that
+ * is not shared does not copy anything.
+ */
+template<typename T>
+class CopyOnWrite {
+public:
+	CopyOnWrite(): value(std::make_shared<T>()) {}
+
+	inline const T & read() const { return *value; }
+
+	//! The value, after it has been copied if it is shared
+	inline T & write() {
+		if (value.use_count() > 1) value = std::make_shared<T>(*value);
+		return *value;
+	}
+
+	//! If it is shared with a copy (and will be copied at the next write)
+	inline bool isShared() const { return value.use_count() > 1; }
+private:
+	std::shared_ptr<T> value;
+};
+
+/**
+ * The state of an object at some moment, as an immutable value of which the type is hidden. It is
+ * shared by copies of the snapshot, so one snapshot can be restored any number of times, also into
+ * other objects of the same type (a fork), on any thread. An empty snapshot means the object does
+ * not support it.
+ */
+class Snapshot {
+public:
+	Snapshot(): type(NULL) {}
+
+	//! A copy of the value, members that are CopyOnWrite are shared instead of copied
+	template<typename T>
+	explicit Snapshot(const T &state): state(std::make_shared<const T>(state)), type(&typeid(T)) {}
+
+	inline bool empty() const { return !state; }
+
+	//! If the value is of type T
+	template<typename T>
+	inline bool is() const { return type != NULL && *type == typeid(T); }
+
+	template<typename T>
+	inline const T & get() const {
+		assert (is<T>());
+		return *static_cast<const T*>(state.get());
+	}
+private:
+	std::shared_ptr<const void> state;
+
+	const std::type_info *type;
+};
+
+#endif /* SNAPSHOT_H_ */
@@ -25,14 +25,18 @@
 #ifndef STRUCTS_H_
 #define STRUCTS_H_
 
+#include <Arena.h>
+
 #include <vector>
 #include <list>
+#include <stdint.h>
 
 typedef double AP_TYPE;
 
 typedef double PROB_TYPE;
 
-//typedef int FREQ_TYPE;
+//! Frequencies (counts) in histograms
+typedef int FREQ_TYPE;
 
 //! Simple definition for Observation for now
 typedef std::vector<AP_TYPE> Observation;
@@ -43,6 +47,12 @@ typedef std::vector<AP_TYPE> Action;
 //! And a generic description for State
 typedef std::vector<AP_TYPE> State;
 
+//! Discrete sensor or actuator values (symbols), for at most 256 possible values
+typedef uint8_t SYMBOL8_TYPE;
+
+//! The same, for at most 65536 possible values
+typedef uint16_t SYMBOL16_TYPE;
+
 /***************************************************************************************************
  * A random variable is in most papers just a scalar. In our case, however, it is a vector. A sensor
  * input or motor output is most naturally represented by multiple values. Hence, a RandomVariable
@@ -51,16 +61,23 @@ typedef std::vector<AP_TYPE> State;
 typedef std::vector<PROB_TYPE> Point;
 typedef std::vector<Point*> RandomVariable;
 
-//! A observation-action pair at time=t
+//! Values of a sample on a sensorimotor path, optionally in an arena
+typedef std::vector<AP_TYPE, ArenaAllocator<AP_TYPE> > SampleValues;
+
+//! A observation-action pair at time=t, to be created with arena.New<SensationActionPair>(&arena)
+//! if it has to live as long as the arena (its values are then in the arena too)
 struct SensationActionPair {
-	Observation observation;
-	Action action;
+	SensationActionPair(Arena *arena = NULL): observation(ArenaAllocator<AP_TYPE>(arena)),
+			action(ArenaAllocator<AP_TYPE>(arena)), t(0) {}
+	SampleValues observation;
+	SampleValues action;
 	long int t;
 };
 
 //! The sequence of observations and actions, because of most often a Markovian
-//! approach it seems most naturally to use a list (but see SensorimotorContainer)
-typedef std::list<SensationActionPair*> SensorimotorPath;
+//! approach it seems most naturally to use a list (but see SensorimotorContainer). A path
+//! created with an ArenaAllocator has its nodes in the arena.
+typedef std::list<SensationActionPair*, ArenaAllocator<SensationActionPair*> > SensorimotorPath;
 
 //! The natural representation is SensorimotorPath, but to be able to use sorting we need a random
 //! access iterator for our std container, hence we copy the entire list to a container
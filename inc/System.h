@@ -29,6 +29,11 @@
 #include <queue>
 
 #include <Structs.h>
+#include <FixedSample.h>
+#include <Snapshot.h>
+
+#include <algorithm>
+#include <assert.h>
 
 class System;
 
@@ -49,12 +54,118 @@ public:
 	//! This will update the observations
 	virtual void Tick(const Observation &observation, Action &action) = 0;
 
+	//! The same, with the reward on its own channel instead of in the observation, by default the
+	//! reward is ignored
+	virtual void Tick(const Observation &observation, AP_TYPE reward, Action &action) {
+		Tick(observation, action);
+	}
+
 	//! Restart this system
 	virtual void Restart() = 0;
+
+	//! The internal state of the system, e.g. what it has learned, an empty snapshot if the system
+	//! does not support it
+	virtual Snapshot Save() const { return Snapshot(); }
+
+	//! Go back to a state saved by this or another system of the same type, false if that is not
+	//! possible
+	virtual bool Restore(const Snapshot &snapshot) { return false; }
 private:
 	//! History of observations, best represented by a FIFO queue (or deque for element-wise access)
 //	std::queue<Observation> observation;
 };
 
+/**
+ * A system of which the number of observation values O and action values A are fixed at compile time,
+ * like a robot with a given set of sensors and actuators. The derived class implements:
+ *   void FixedTick(const FixedObservation &observation, FixedAction &action);
+ * on arrays. It is called without virtual dispatch, so the compiler can inline it. The embodiment sees
+ * an ordinary System, the values are copied from and to its vectors here.
+ */
+template<class Derived, size_t O, size_t A>
+class FixedSystem: public System {
+public:
+	typedef typename Sample<O>::type FixedObservation;
+	typedef typename Sample<A>::type FixedAction;
+
+	using System::Tick;
+
+	void Tick(const Observation &observation, Action &action) {
+		load(observation, fixed_observation);
+		static_cast<Derived*>(this)->FixedTick(fixed_observation, fixed_action);
+		store(fixed_action, action);
+	}
+
+	//! For a TypedEmbodiment, on its own buffers and without virtual dispatch
+	typedef FixedObservation TypedObservation;
+	typedef FixedAction TypedAction;
+
+	inline void TypedTick(const FixedObservation &observation, AP_TYPE reward, FixedAction &action) {
+		static_cast<Derived*>(this)->FixedTick(observation, action);
+	}
+
+	//! A copy of the derived system, so it should be copyable
+	Snapshot Save() const { return Snapshot(static_cast<const Derived&>(*this)); }
+
+	bool Restore(const Snapshot &snapshot) {
+		if (!snapshot.is<Derived>()) return false;
+		static_cast<Derived&>(*this) = snapshot.get<Derived>();
+		return true;
+	}
+private:
+	FixedObservation fixed_observation;
+
+	FixedAction fixed_action;
+};
+
+/**
+ * A system with discrete sensors and actuators: O observation and A action symbols of type T, e.g.
+ * SYMBOL8_TYPE. The reward comes in separately. The derived class implements:
+ *   void DiscreteTick(const SymbolObservation &observation, AP_TYPE reward, SymbolAction &action);
+ * A discrete environment can call it directly (see DiscreteEnvironment::Step), then only a few
+ * bytes per system are passed around per tick. Through an embodiment the symbols are converted
+ * from and to its vectors.
+ */
+template<class Derived, typename T, size_t O, size_t A>
+class DiscreteSystem: public System {
+public:
+	typedef T Symbol;
+	typedef std::array<T, O> SymbolObservation;
+	typedef std::array<T, A> SymbolAction;
+
+	void Tick(const Observation &observation, Action &action) {
+		Tick(observation, AP_TYPE(0), action);
+	}
+
+	void Tick(const Observation &observation, AP_TYPE reward, Action &action) {
+		assert (observation.size() == O);
+		for (size_t i = 0; i < O; ++i) {
+			symbol_observation[i] = (T)observation[i];
+		}
+		static_cast<Derived*>(this)->DiscreteTick(symbol_observation, reward, symbol_action);
+		store(symbol_action, action);
+	}
+
+	//! For a TypedEmbodiment, on its own buffers and without virtual dispatch
+	typedef SymbolObservation TypedObservation;
+	typedef SymbolAction TypedAction;
+
+	inline void TypedTick(const SymbolObservation &observation, AP_TYPE reward, SymbolAction &action) {
+		static_cast<Derived*>(this)->DiscreteTick(observation, reward, action);
+	}
+
+	//! A copy of the derived system, so it should be copyable
+	Snapshot Save() const { return Snapshot(static_cast<const Derived&>(*this)); }
+
+	bool Restore(const Snapshot &snapshot) {
+		if (!snapshot.is<Derived>()) return false;
+		static_cast<Derived&>(*this) = snapshot.get<Derived>();
+		return true;
+	}
+private:
+	SymbolObservation symbol_observation;
+
+	SymbolAction symbol_action;
+};
 
 #endif /* SYSTEM_H_ */
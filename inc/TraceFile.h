@@ -0,0 +1,193 @@
+/***************************************************************************************************
+ * @brief Binary files with sensorimotor traces, written during a run and memory-mapped for analysis
+ * @file TraceFile.h
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#ifndef TRACEFILE_H_
+#define TRACEFILE_H_
+
+#include <Structs.h>
+#include <ColumnarPath.h>
+#include <TraceCodec.h>
+
+#include <vector>
+#include <string>
+#include <assert.h>
+#include <stdio.h>
+#include <stdint.h>
+
+//! Version of the file format, readers refuse files of any other version
+#define TRACE_VERSION 1
+
+//! Default number of samples per block
+#define TRACE_BLOCK_SIZE 65536
+
+enum TraceDataType {
+	TD_FLOAT64,						//< double, for observations and actions
+	TD_INT64,						//< long int, for the times
+	TD_COUNT
+};
+
+enum TraceEncoding {
+	TE_RAW,							//< blocks are stored as they are in memory
+	TE_COMPRESSED,					//< blocks are encoded by the TraceCodec
+	TE_COUNT
+};
+
+/**
+ * The header at the start of a trace file, 64 bytes. The header is written when the file is opened
+ * and the number of samples when it is closed, so a file that has not been closed properly reads as
+ * a trace of 0 samples.
+ */
+struct TraceHeader {
+	char magic[8];					//< "APTRACE" and a zero
+	uint32_t version;				//< TRACE_VERSION
+	uint32_t byte_order;			//< 0x01020304 as written by the machine that wrote the file
+	uint32_t observation_size;		//< values per observation
+	uint32_t action_size;			//< values per action
+	uint32_t value_type;			//< TraceDataType of the observations and actions
+	uint32_t time_type;				//< TraceDataType of the times
+	uint64_t block_size;			//< samples per block
+	uint64_t nof_samples;			//< samples in the file
+	uint32_t encoding;				//< TraceEncoding of the blocks
+	uint32_t reserved;
+	uint64_t index_offset;			//< position of the block index (compressed files only)
+};
+
+/**
+ * After the header the samples follow in blocks of block_size samples (the last block can be
+ * shorter). A block with n samples consists of the n x observation_size observation matrix, the
+ * n x action_size action matrix, and the n times, so it is exactly a ColumnarView. The writer
+ * collects a block in memory and writes it at once.
+ *
+ * Compressed blocks have different sizes. Then the file ends with an index: the position of every
+ * block and the end of the last one, so a single block can be found and decoded.
+ */
+class TraceWriter {
+public:
+	TraceWriter();
+
+	//! Closes the file if that has not been done
+	~TraceWriter();
+
+	//! Create the file, the dimensions are fixed for the entire file
+	bool Open(const std::string &filename, int observation_size, int action_size,
+			size_t block_size = TRACE_BLOCK_SIZE, TraceEncoding encoding = TE_RAW);
+
+	//! Append a sample
+	void Write(const AP_TYPE *observation, const AP_TYPE *action, long int t);
+
+	inline void Write(const Observation &observation, const Action &action, long int t) {
+		assert (observation.size() == header.observation_size);
+		assert (action.size() == header.action_size);
+		Write(observation.data(), action.data(), t); }
+
+	//! Write the last block and the number of samples
+	bool Close();
+
+	inline bool isOpen() const { return file != NULL; }
+
+	//! Huffman code the compressed blocks where that saves enough, see TraceCodec
+	inline void setHuffman(bool enable) { codec.setHuffman(enable); }
+
+	//! Number of samples written so far
+	inline uint64_t getCount() const { return header.nof_samples + block.size(); }
+protected:
+	//! Write the samples collected in memory as a block
+	bool Flush();
+private:
+	FILE *file;
+
+	TraceHeader header;
+
+	//! The block that is being filled
+	ColumnarPath block;
+
+	TraceCodec codec;
+
+	//! An encoded block
+	std::vector<uint8_t> buffer;
+
+	//! Position of every block written
+	std::vector<uint64_t> index;
+
+	//! Position in the file
+	uint64_t offset;
+};
+
+/**
+ * Maps a trace file in memory. The blocks are handed out as views on the mapping, so nothing is
+ * parsed or copied: the operating system reads the pages when the estimators touch them. Blocks of
+ * a compressed file are decoded on request, in any order.
+ */
+class TraceReader {
+public:
+	TraceReader();
+
+	//! Unmaps the file if that has not been done
+	~TraceReader();
+
+	//! Map the file, returns false if it is not a (complete) trace file of TRACE_VERSION
+	bool Open(const std::string &filename);
+
+	void Close();
+
+	inline const TraceHeader & getHeader() const { return *header; }
+
+	//! Number of samples in the file
+	inline size_t size() const { return (header != NULL) ? header->nof_samples : 0; }
+
+	inline int getObservationSize() const { return header->observation_size; }
+
+	inline int getActionSize() const { return header->action_size; }
+
+	inline size_t getNofBlocks() const { return blocks.size(); }
+
+	inline bool isCompressed() const { return header->encoding == TE_COMPRESSED; }
+
+	//! View on block b, valid till Close() (not for compressed files)
+	inline const ColumnarView & getView(size_t b) const { assert (!isCompressed()); return blocks[b]; }
+
+	//! Views on all blocks, in order (not for compressed files)
+	inline const std::vector<ColumnarView> & getViews() const {
+		assert (!isCompressed()); return blocks; }
+
+	//! View on block b of any file. A compressed block is decoded into the buffer, the view is valid
+	//! as long as the buffer does not change. Returns an empty view if the block is corrupt.
+	ColumnarView Load(size_t b, ColumnarPath &buffer);
+private:
+	//! Start of the mapping
+	char *data;
+
+	//! Size of the mapping
+	size_t length;
+
+	const TraceHeader *header;
+
+	//! Views on the blocks of a raw file
+	std::vector<ColumnarView> blocks;
+
+	//! Position of every block and the end of the last one, for a compressed file
+	const uint64_t *index;
+
+	TraceCodec codec;
+};
+
+#endif /* TRACEFILE_H_ */
@@ -0,0 +1,94 @@
+/***************************************************************************************************
+ * @brief Ring buffer with the most recent observations and actions of a system
+ * @file TraceRecorder.h
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#ifndef TRACERECORDER_H_
+#define TRACERECORDER_H_
+
+#include <Structs.h>
+#include <ColumnarPath.h>
+
+#include <vector>
+#include <stddef.h>
+
+/**
+ * Keeps the last "capacity" samples (observation, action, t) of a system. The buffer has room for
+ * twice the capacity and every sample is written twice, at slot i and at slot i + capacity. Then the
+ * last n samples, for any n up to the capacity, are always a contiguous block of rows. So a view on
+ * them can be given to the estimators without copying, while recording costs two small writes and
+ * no allocation.
+ *
+ * The dimensions are taken from the first sample. The buffers are allocated at that moment, and not
+ * again till the capacity or the dimensions change.
+ */
+class TraceRecorder {
+public:
+	TraceRecorder(size_t capacity = 0);
+
+	~TraceRecorder();
+
+	//! Set the number of samples that are kept, this also clears the recorder
+	void setCapacity(size_t capacity);
+
+	inline size_t getCapacity() const { return capacity; }
+
+	//! Store a sample, the oldest one is overwritten if the recorder is full
+	void Record(const AP_TYPE *observation, size_t observation_size, const AP_TYPE *action,
+			size_t action_size, long int t);
+
+	inline void Record(const Observation &observation, const Action &action, long int t) {
+		Record(observation.data(), observation.size(), action.data(), action.size(), t); }
+
+	//! Forget all samples (the buffers are kept)
+	void Clear();
+
+	//! Number of samples available, at most the capacity
+	inline size_t size() const { return (count < capacity) ? count : capacity; }
+
+	//! Number of samples recorded since the last Clear()
+	inline size_t getCount() const { return count; }
+
+	//! The last n samples, oldest first, valid till the next Record()
+	ColumnarView getView(size_t n) const;
+
+	//! All samples available
+	inline ColumnarView getView() const { return getView(size()); }
+private:
+	size_t capacity;
+
+	//! Number of samples recorded
+	size_t count;
+
+	int observation_size;
+
+	int action_size;
+
+	//! Observations in 2*capacity rows
+	std::vector<AP_TYPE> observations;
+
+	//! Actions in 2*capacity rows
+	std::vector<AP_TYPE> actions;
+
+	//! Times in 2*capacity rows
+	std::vector<long int> times;
+};
+
+#endif /* TRACERECORDER_H_ */
@@ -0,0 +1,124 @@
+/***************************************************************************************************
+ * @brief A tabular Markov decision process, sampled with alias tables
+ * @file TransitionTable.h
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#ifndef TRANSITIONTABLE_H_
+#define TRANSITIONTABLE_H_
+
+#include <Structs.h>
+
+#include <vector>
+#include <iostream>
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * One possible outcome of taking an action in a state: the next state, its probability and the
+ * reward that comes with it.
+ */
+struct Transition {
+	uint32_t next;
+	PROB_TYPE probability;
+	AP_TYPE reward;
+};
+
+/**
+ * The dynamics of a discrete environment as a table: for every state and action the distribution
+ * over next states, together with the rewards. The outcomes of a (state, action) pair are stored
+ * next to each other, in the order in which they are added, and the zero probabilities are left
+ * out, so a row of a sparse model is short.
+ *
+ * Every row gets an alias table (Walker, Vose), so drawing an outcome takes one uniform number, a
+ * multiplication and a comparison, whatever the number of outcomes. The same table serves exact
+ * analysis and planning: the rows can be read directly, or written to and read from a text file
+ * with lines "T: action : state : next probability reward" after "states: n" and "actions: m".
+ */
+class TransitionTable {
+public:
+	TransitionTable(size_t nof_states = 0, size_t nof_actions = 0);
+
+	//! Remove all outcomes and set the size
+	void Resize(size_t nof_states, size_t nof_actions);
+
+	//! Add an outcome to a row, before Prepare(), zero probabilities are ignored, returns false (and
+	//! a message) if the states or action are not in the table or the probability is negative or NaN
+	bool Add(size_t state, size_t action, size_t next, PROB_TYPE probability, AP_TYPE reward);
+
+	//! Build the alias tables, false (and a message) if a row does not sum to one
+	bool Prepare();
+
+	inline bool isPrepared() const { return prepared; }
+
+	inline size_t getNofStates() const { return nof_states; }
+
+	inline size_t getNofActions() const { return nof_actions; }
+
+	//! The outcomes of a row, [begin, end)
+	inline const Transition * begin(size_t state, size_t action) const {
+		return transitions.data() + rows[state * nof_actions + action]; }
+
+	inline const Transition * end(size_t state, size_t action) const {
+		return transitions.data() + rows[state * nof_actions + action + 1]; }
+
+	//! Draw an outcome with a uniform number in [0,1), the table should be prepared
+	inline const Transition & Sample(size_t state, size_t action, AP_TYPE uniform) const {
+		size_t row = state * nof_actions + action;
+		uint32_t first = rows[row];
+		AP_TYPE x = uniform * (rows[row + 1] - first);
+		uint32_t k = (uint32_t)x;
+		return transitions[(x - k < thresholds[first + k]) ? first + k : aliases[first + k]];
+	}
+
+	//! Expected reward of a row
+	AP_TYPE ExpectedReward(size_t state, size_t action) const;
+
+	//! Write the size and all outcomes, with enough digits to read back the same numbers
+	void Write(std::ostream &os) const;
+
+	//! Read a table as written by Write() and prepare it, false if it is malformed
+	bool Read(std::istream &is);
+protected:
+	//! The alias table of one row
+	void BuildAliases(size_t row);
+private:
+	size_t nof_states;
+
+	size_t nof_actions;
+
+	//! Start of the outcomes of row state * nof_actions + action, and the end of the last row
+	std::vector<uint32_t> rows;
+
+	//! All outcomes, row after row
+	std::vector<Transition> transitions;
+
+	//! Row of every outcome, while adding
+	std::vector<uint32_t> added_rows;
+
+	//! Per outcome the chance to keep it, for a draw that falls in its slot
+	std::vector<PROB_TYPE> thresholds;
+
+	//! Per outcome the (absolute) index of the outcome that is drawn otherwise
+	std::vector<uint32_t> aliases;
+
+	bool prepared;
+};
+
+#endif /* TRANSITIONTABLE_H_ */
@@ -0,0 +1,251 @@
+/***************************************************************************************************
+ * @brief An embodiment of which the environment and system types are known at compile time
+ * @file TypedEmbodiment.h
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#ifndef TYPEDEMBODIMENT_H_
+#define TYPEDEMBODIMENT_H_
+
+#include <Structs.h>
+#include <Snapshot.h>
+
+#include <vector>
+#include <tuple>
+#include <iostream>
+#include <assert.h>
+#include <stddef.h>
+
+/**
+ * The same sensorimotor loop as the Embodiment, but for an environment of type Env and groups of
+ * systems of the types in Systems, e.g. TypedEmbodiment<RecyclingRobotsBenchmark, RecyclingRobot>.
+ * Env should be a FixedEnvironment or a DiscreteEnvironment and every system type a FixedSystem
+ * or DiscreteSystem with the same observation and action types. The systems are numbered group
+ * after group.
+ *
+ * Because all types are known, there is no virtual call per tick: the environment and systems are
+ * ticked through their TypedTick, straight on the arrays in here, and the reward is read with a
+ * qualified call. With Run the compiler sees the loop over all ticks, including the observer, so
+ * it can inline the whole of it. For cheap systems the virtual calls, and the copying of values
+ * from and to vectors, are most of the time of a tick of an Embodiment.
+ *
+ * The order is the same as in an Embodiment: every system gets its observation and the reward of
+ * the previous step, then the environment gets the actions. With the same seeds the results are
+ * therefore the same.
+ *
+ * A snapshot holds those of the environment and the systems, and shares the arrays in here
+ * copy-on-write, so only the systems themselves are copied when saving and restoring, and the
+ * arrays once at the first tick afterwards. A rollout from a saved state then costs about as much
+ * as the ticks that are simulated.
+ */
+template<class Env, class... Systems>
+class TypedEmbodiment {
+public:
+	typedef typename Env::TypedObservation Observation;
+	typedef typename Env::TypedAction Action;
+	typedef typename Env::TypedState State;
+
+	TypedEmbodiment(): environment(NULL), nof_systems(0), t(0) {}
+
+	//! Couple the environment with a group of systems per system type
+	void Couple(Env &env, const std::vector<Systems*> &... groups) {
+		environment = &env;
+		systems = std::make_tuple(groups...);
+		nof_systems = 0;
+		for (size_t size: { groups.size()... }) {
+			nof_systems += size;
+		}
+		observations.write().assign(nof_systems, Observation());
+		actions.write().assign(nof_systems, Action());
+		states.write().assign(nof_systems, State());
+		environment->TypedInit(observations.write(), states.write());
+	}
+
+	//! Restart environment and systems
+	void Restart() {
+		environment->Restart();
+		RestartGroup<0>();
+		environment->TypedInit(observations.write(), states.write());
+		t = 0;
+	}
+
+	//! Tick the systems and then the environment
+	inline void Tick() {
+		std::vector<Observation> &observations = this->observations.write();
+		std::vector<Action> &actions = this->actions.write();
+		TickGroup<0>(0, observations, actions);
+		environment->TypedTick(actions, observations, states.write());
+		++t;
+	}
+
+	//! The state of the environment, the systems and the arrays, to branch from
+	Snapshot Save() const {
+		if (environment == NULL) return Snapshot();
+		TypedSnapshot state;
+		state.environment = environment->Env::Save();
+		SaveGroup<0>(state.systems);
+		GroupSizes<0>(state.group_sizes);
+		state.observations = observations;
+		state.actions = actions;
+		state.states = states;
+		state.t = t;
+		return Snapshot(state);
+	}
+
+	//! Go back to a saved state, also of another typed embodiment with the same number of systems
+	//! per group (a fork). A snapshot with other group sizes is refused before anything changes;
+	//! when the environment or a system refuses its own part, the restore stops there and the
+	//! parts before it stay restored, like Embodiment::Restore
+	bool Restore(const Snapshot &snapshot) {
+		if (environment == NULL || !snapshot.is<TypedSnapshot>()) return false;
+		const TypedSnapshot &state = snapshot.get<TypedSnapshot>();
+		std::vector<size_t> group_sizes;
+		GroupSizes<0>(group_sizes);
+		if (state.group_sizes != group_sizes || state.systems.size() != nof_systems) {
+			std::cerr << "Snapshot of other group sizes than the typed embodiment" << std::endl;
+			return false;
+		}
+		if (!environment->Env::Restore(state.environment)) return false;
+		if (!RestoreGroup<0>(state.systems, 0)) return false;
+		observations = state.observations;
+		actions = state.actions;
+		states = state.states;
+		t = state.t;
+		return true;
+	}
+
+	//! Tick "nof_ticks" times, after every tick observer(*this) is called
+	template<class Observer>
+	void Run(long int nof_ticks, Observer observer) {
+		for (long int i = 0; i < nof_ticks; ++i) {
+			Tick();
+			observer(*this);
+		}
+	}
+
+	//! The observations the systems will receive at the next tick
+	inline const std::vector<Observation> & getObservations() const { return observations.read(); }
+
+	//! The last actions of the systems
+	inline const std::vector<Action> & getActions() const { return actions.read(); }
+
+	//! The reward system i will receive at the next tick
+	inline AP_TYPE GetReward(size_t i) const { return environment->Env::GetReward(i); }
+
+	inline Env & getEnvironment() { return *environment; }
+
+	inline size_t getNofSystems() const { return nof_systems; }
+
+	inline long int GetTime() const { return t; }
+protected:
+	struct TypedSnapshot {
+		Snapshot environment;
+
+		std::vector<Snapshot> systems;
+
+		std::vector<size_t> group_sizes;
+
+		CopyOnWrite<std::vector<Observation> > observations;
+
+		CopyOnWrite<std::vector<Action> > actions;
+
+		CopyOnWrite<std::vector<State> > states;
+
+		long int t;
+	};
+
+	//! Tick the systems of group G and of the groups after it, "first" is the index of its first one
+	template<size_t G>
+	inline void TickGroup(size_t first, std::vector<Observation> &observations,
+			std::vector<Action> &actions) {
+		if constexpr (G < sizeof...(Systems)) {
+			auto &group = std::get<G>(systems);
+			for (size_t k = 0; k < group.size(); ++k) {
+				size_t i = first + k;
+				group[k]->TypedTick(observations[i], environment->Env::GetReward(i), actions[i]);
+			}
+			TickGroup<G + 1>(first + group.size(), observations, actions);
+		}
+	}
+
+	//! Save the systems of group G and after, without virtual calls
+	template<size_t G>
+	void SaveGroup(std::vector<Snapshot> &snapshots) const {
+		if constexpr (G < sizeof...(Systems)) {
+			typedef typename std::tuple_element<G, std::tuple<Systems...> >::type SystemType;
+			const std::vector<SystemType*> &group = std::get<G>(systems);
+			for (size_t k = 0; k < group.size(); ++k) {
+				snapshots.push_back(group[k]->SystemType::Save());
+			}
+			SaveGroup<G + 1>(snapshots);
+		}
+	}
+
+	//! The number of systems of group G and after
+	template<size_t G>
+	void GroupSizes(std::vector<size_t> &sizes) const {
+		if constexpr (G < sizeof...(Systems)) {
+			sizes.push_back(std::get<G>(systems).size());
+			GroupSizes<G + 1>(sizes);
+		}
+	}
+
+	//! Restore the systems of group G and after, false as soon as one of them fails
+	template<size_t G>
+	bool RestoreGroup(const std::vector<Snapshot> &snapshots, size_t first) {
+		if constexpr (G < sizeof...(Systems)) {
+			typedef typename std::tuple_element<G, std::tuple<Systems...> >::type SystemType;
+			std::vector<SystemType*> &group = std::get<G>(systems);
+			for (size_t k = 0; k < group.size(); ++k) {
+				if (!group[k]->SystemType::Restore(snapshots[first + k])) return false;
+			}
+			return RestoreGroup<G + 1>(snapshots, first + group.size());
+		}
+		return true;
+	}
+
+	template<size_t G>
+	inline void RestartGroup() {
+		if constexpr (G < sizeof...(Systems)) {
+			auto &group = std::get<G>(systems);
+			for (size_t k = 0; k < group.size(); ++k) {
+				group[k]->Restart();
+			}
+			RestartGroup<G + 1>();
+		}
+	}
+private:
+	Env *environment;
+
+	//! One group of systems per type
+	std::tuple<std::vector<Systems*>...> systems;
+
+	size_t nof_systems;
+
+	//! Shared with the snapshots till a tick writes to them
+	CopyOnWrite<std::vector<Observation> > observations;
+
+	CopyOnWrite<std::vector<Action> > actions;
+
+	CopyOnWrite<std::vector<State> > states;
+
+	long int t;
+};
+
+#endif /* TYPEDEMBODIMENT_H_ */
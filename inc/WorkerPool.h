@@ -0,0 +1,169 @@
+/***************************************************************************************************
+ * @brief Persistent pool of worker threads that execute a job over a range of items
+ * @file WorkerPool.h
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#ifndef WORKERPOOL_H_
+#define WORKERPOOL_H_
+
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <stddef.h>
+
+//! Number of times a worker checks for new work (yielding in between) before it blocks
+#define WORKER_SPIN_COUNT 2048
+
+/**
+ * Work that can be done in parallel, item by item. Items should not depend on each other.
+ */
+class WorkerJob {
+public:
+	virtual ~WorkerJob() {}
+
+	//! Do item i
+	virtual void Execute(size_t i) = 0;
+};
+
+/**
+ * A fixed number of threads that stay alive between jobs, so a job can be as small as one tick of
+ * a few systems. The calling thread is one of the workers. Item i is always executed by worker
+ * i % (number of workers), so the assignment does not depend on the timing of the threads. Run
+ * returns after all items have been executed, it is a barrier.
+ *
+ * Between jobs the workers first poll for a while, yielding the processor, and then block on a
+ * condition variable. With short jobs in a tight loop they hardly ever block.
+ */
+class WorkerPool {
+public:
+	WorkerPool();
+
+	//! Stops the threads
+	~WorkerPool();
+
+	//! Start the threads, nof_workers includes the calling thread, so 0 or 1 starts no thread
+	void Start(size_t nof_workers);
+
+	//! Stop and join the threads
+	void Stop();
+
+	//! Number of workers, including the calling thread
+	inline size_t getNofWorkers() const { return nof_workers; }
+
+	//! Execute the job for items [0, nof_items) and wait till they are done
+	void Run(WorkerJob &job, size_t nof_items);
+protected:
+	//! Loop of every thread, "seen" is the generation at the start, the thread waits for the next
+	void Work(size_t worker, unsigned long seen);
+
+	//! The items of the current job that belong to this worker
+	void Execute(size_t worker);
+private:
+	//! The threads, worker 0 is the calling thread and does not have one
+	std::vector<std::thread> threads;
+
+	//! Protects the waiting on both conditions
+	std::mutex mutex;
+
+	//! Signaled when there is a new job (or the pool stops)
+	std::condition_variable start_condition;
+
+	//! Signaled when the last thread finished its items
+	std::condition_variable done_condition;
+
+	//! Incremented for every job
+	std::atomic<unsigned long> generation;
+
+	//! Number of threads that still have to finish the current job
+	std::atomic<size_t> pending;
+
+	//! Number of threads + 1, fixed while the threads run
+	size_t nof_workers;
+
+	//! The current job
+	WorkerJob *job;
+
+	//! Number of items in the current job
+	size_t nof_items;
+
+	//! Set before the last generation, the threads return
+	bool stopping;
+};
+
+/**
+ * One thread that executes a job next to the calling thread: Post returns straight away, Wait
+ * returns when the job is done. The handoff is lock-free: a sequence number is published with
+ * release semantics and picked up with acquire semantics. Only a side that found nothing to do
+ * after polling for a while blocks; the other side notices that through a flag and wakes it up.
+ */
+class WorkerThread {
+public:
+	WorkerThread();
+
+	//! Stops the thread
+	~WorkerThread();
+
+	void Start();
+
+	//! Finish the current job and join the thread
+	void Stop();
+
+	inline bool isRunning() const { return thread.joinable(); }
+
+	//! Start executing item i of the job, the previous job should be done (waited for)
+	void Post(WorkerJob &job, size_t i = 0);
+
+	//! Wait till the posted job is done
+	void Wait();
+protected:
+	//! Loop of the thread
+	void Work();
+
+	//! Poll, and then block, till the value differs from "seen"
+	static unsigned long Await(std::atomic<unsigned long> &value, unsigned long seen,
+			std::atomic<bool> &sleeping, std::mutex &mutex, std::condition_variable &condition);
+
+	//! Publish a new value, and wake up the other side if it is blocked
+	static void Publish(std::atomic<unsigned long> &value, unsigned long update,
+			std::atomic<bool> &sleeping, std::mutex &mutex, std::condition_variable &condition);
+private:
+	std::thread thread;
+
+	//! Number of jobs posted and finished
+	std::atomic<unsigned long> posted, finished;
+
+	//! Set by a side that blocks on its condition
+	std::atomic<bool> thread_sleeping, caller_sleeping;
+
+	std::mutex mutex;
+
+	std::condition_variable posted_condition, finished_condition;
+
+	WorkerJob *job;
+
+	size_t item;
+
+	//! Set before the last post, the thread returns
+	bool stopping;
+};
+
+#endif /* WORKERPOOL_H_ */
@@ -0,0 +1,75 @@
+/***************************************************************************************************
+ * @brief Arena for objects that all have the same lifetime
+ * @file Arena.cpp
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#include <Arena.h>
+
+#include <assert.h>
+
+Arena::Arena(size_t block_size) {
+	assert (block_size > 0);
+	this->block_size = block_size;
+	block = 0;
+	current = end = 0;
+}
+
+Arena::~Arena() {
+	for (size_t i = 0; i < blocks.size(); ++i) {
+		::operator delete(blocks[i]);
+	}
+}
+
+/**
+ * The blocks are kept in the order they were used. After a Release() they are filled in that order
+ * again. A block that is too small for the request is skipped, so an object larger than the default
+ * block size gets a block for itself, inserted right after the one in use.
+ */
+void *Arena::Grow(size_t size, size_t align) {
+	assert ((align & (align - 1)) == 0);
+	size_t next = blocks.empty() ? 0 : block + 1;
+	while (next < blocks.size() && block_sizes[next] < size + align) {
+		++next;
+	}
+	if (next == blocks.size() || block_sizes[next] < size + align) {
+		size_t new_size = (size + align > block_size) ? size + align : block_size;
+		next = blocks.empty() ? 0 : block + 1;
+		blocks.insert(blocks.begin() + next, (char*)::operator new(new_size));
+		block_sizes.insert(block_sizes.begin() + next, new_size);
+	}
+	block = next;
+	current = (uintptr_t)blocks[block];
+	end = current + block_sizes[block];
+	return Allocate(size, align);
+}
+
+void Arena::Release() {
+	block = 0;
+	current = blocks.empty() ? 0 : (uintptr_t)blocks[0];
+	end = blocks.empty() ? 0 : current + block_sizes[0];
+}
+
+size_t Arena::getCapacity() const {
+	size_t capacity = 0;
+	for (size_t i = 0; i < block_sizes.size(); ++i) {
+		capacity += block_sizes[i];
+	}
+	return capacity;
+}
@@ -0,0 +1,82 @@
+/***************************************************************************************************
+ * @brief Sensorimotor path with contiguous storage
+ * @file ColumnarPath.cpp
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#include <ColumnarPath.h>
+
+#include <assert.h>
+
+ColumnarPath::ColumnarPath(int observation_size, int action_size) {
+	setDimensions(observation_size, action_size);
+}
+
+ColumnarPath::~ColumnarPath() {
+}
+
+void ColumnarPath::setDimensions(int observation_size, int action_size) {
+	assert (observation_size >= 0 && action_size >= 0);
+	this->observation_size = observation_size;
+	this->action_size = action_size;
+	clear();
+}
+
+void ColumnarPath::push_back(const Observation &observation, const Action &action, long int t) {
+	assert (observation.size() == (size_t)observation_size);
+	assert (action.size() == (size_t)action_size);
+	push_back(observation.data(), action.data(), t);
+}
+
+void ColumnarPath::push_back(const SensationActionPair &pair) {
+	assert (pair.observation.size() == (size_t)observation_size);
+	assert (pair.action.size() == (size_t)action_size);
+	push_back(pair.observation.data(), pair.action.data(), pair.t);
+}
+
+void ColumnarPath::assign(const SensorimotorPath &path) {
+	if (path.empty()) {
+		clear();
+		return;
+	}
+	setDimensions(path.front()->observation.size(), path.front()->action.size());
+	reserve(path.size());
+	SensorimotorPath::const_iterator it;
+	for (it = path.begin(); it != path.end(); ++it) {
+		push_back(**it);
+	}
+}
+
+void ColumnarPath::reserve(size_t n) {
+	observations.reserve(n * observation_size);
+	actions.reserve(n * action_size);
+	times.reserve(n);
+}
+
+void ColumnarPath::resize(size_t n) {
+	observations.resize(n * observation_size);
+	actions.resize(n * action_size);
+	times.resize(n);
+}
+
+void ColumnarPath::clear() {
+	observations.clear();
+	actions.clear();
+	times.clear();
+}
@@ -0,0 +1,53 @@
+/***************************************************************************************************
+ * @brief Messages between systems, over bounded channels with a latency and a bandwidth
+ * @file Coupling.cpp
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#include <Coupling.h>
+
+#include <iostream>
+
+Channel::Channel(size_t sender, size_t receiver, long int latency, size_t bandwidth):
+	sender(sender), receiver(receiver), latency(latency), bandwidth(bandwidth), clock(NULL) {
+	if (latency < 1) {
+		std::cerr << "Channel from " << sender << " to " << receiver << " with latency " << latency
+				<< ", it gets a latency of 1" << std::endl;
+		this->latency = 1;
+	}
+}
+
+Channel::~Channel() {
+}
+
+Coupling::Coupling(): tick(0) {
+}
+
+Coupling::~Coupling() {
+	for (size_t i = 0; i < channels.size(); ++i) {
+		delete channels[i];
+	}
+}
+
+void Coupling::Clear() {
+	tick = 0;
+	for (size_t i = 0; i < channels.size(); ++i) {
+		channels[i]->Clear();
+	}
+}
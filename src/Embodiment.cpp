@@ -23,31 +23,104 @@
 
 #include <Embodiment.h>
 
+#include <algorithm>
 #include <iostream>
+#include <thread>
+#include <assert.h>
 
 using namespace std;
 
+Embodiment::Embodiment(): system_ticks(this), environment_tick(this) {
+	environment = NULL;
+	coupling = NULL;
+	fixed_buffers = false;
+	t = 0;
+	record_capacity = 0;
+}
+
 /**
- * The embodiment sensorimotor loop. The system gets a sensor input, gets a tick, then
+ * The embodiment sensorimotor loop. The system gets a sensor input and the reward of the
+ * previous tick, gets a tick, then
  * the environment gets the result of the system, the action, and gets a tick. The
  * environment and the system are not allowed to empty the incoming action/perception
  * themselves. This means it can in the future be used for multiple environments or
  * systems.
+ *
+ * If the environment gave the sizes of the buffers they are handed out as they are: the
+ * systems and environment overwrite the values, and nothing is allocated.
+ *
+ * With more than one thread the systems are ticked on the worker pool, which returns when all
+ * of them are done. Every system only touches its own observation, action, trace and writer,
+ * and its own ends of the channels of the coupling, which get the tick as their clock first.
+ *
+ * Pipelined, the buffers are swapped instead: the actions of the last tick become the delayed
+ * actions the environment steps with, and the observations it produces become the current ones
+ * after both sides are done. The rewards are read before, so the systems never read what the
+ * environment is writing.
  */
 void Embodiment::Tick() {
-	// Iterate over all systems
+	if (coupling != NULL) coupling->setTick(t);
 	for (unsigned int i = 0; i < systems.size(); ++i) {
-		Action *last_action = actions[i];
-		// Emptying is maybe not really necessary but probably prevents bugs
-		last_action->clear();
-		Observation *last_observation = observations[i];
-		systems[i]->Tick(*last_observation, *last_action);
-		// Emptying is maybe not really necessary but probably prevents bugs
-		last_observation->clear();
+		rewards[i] = environment->GetReward(i);
+	}
+	if (environment_thread.isRunning()) {
+		actions.swap(delayed_actions);
+		environment_thread.Post(environment_tick);
+		TickSystems();
+		environment_thread.Wait();
+		observations.swap(next_observations);
+	} else {
+		TickSystems();
+		// The environment is itself responsible of filling observation array for all systems
+		environment->Tick(actions, observations, states);
 	}
+	++t;
+}
+
+void Embodiment::TickSystems() {
+	if (pool.getNofWorkers() > 1) {
+		pool.Run(system_ticks, systems.size());
+	} else {
+		for (unsigned int i = 0; i < systems.size(); ++i) {
+			TickSystem(i);
+		}
+	}
+}
+
+void Embodiment::TickEnvironment() {
+	environment->Tick(delayed_actions, next_observations, states);
+}
 
-	// The environment is itself responsible of filling observation array for all systems
-	environment->Tick(actions, observations, states);
+void Embodiment::TickSystem(size_t i) {
+	Action *last_action = actions[i];
+	// Emptying is maybe not really necessary but probably prevents bugs
+	if (!fixed_buffers) last_action->clear();
+	Observation *last_observation = observations[i];
+	systems[i]->Tick(*last_observation, rewards[i], *last_action);
+	if (record_capacity) traces[i].Record(*last_observation, *last_action, t);
+	if (writers[i] != NULL) writers[i]->Write(*last_observation, *last_action, t);
+	// Emptying is maybe not really necessary but probably prevents bugs
+	if (!fixed_buffers) last_observation->clear();
+}
+
+Embodiment::~Embodiment() {
+	Decouple();
+}
+
+void Embodiment::Decouple() {
+	SetPipelined(false);
+	for (unsigned int i = 0; i < actions.size(); ++i) {
+		delete actions[i];
+		delete observations[i];
+		delete states[i];
+		delete delayed_actions[i];
+		delete next_observations[i];
+	}
+	actions.clear();
+	observations.clear();
+	states.clear();
+	delayed_actions.clear();
+	next_observations.clear();
 }
 
 void Embodiment::Restart() {
@@ -56,26 +129,129 @@ void Embodiment::Restart() {
 		systems[i]->Restart();
 	}
 	environment->Init(observations, states);
+	if (IsPipelined()) {
+		// the environment starts with actions of zero, a(-1)
+		for (unsigned int i = 0; i < actions.size(); ++i) {
+			std::fill(actions[i]->begin(), actions[i]->end(), AP_TYPE(0));
+		}
+	}
+	arena.Release();
+	t = 0;
+	if (coupling != NULL) coupling->Clear();
+	for (unsigned int i = 0; i < traces.size(); ++i) {
+		traces[i].Clear();
+	}
 }
 
 /**
  * The default coupling is just by calling Tick on all systems in the same order. And
- * then call Tick on the environment.
+ * then call Tick on the environment. The coupling is kept, to advance its clock.
  */
-void Embodiment::Couple(Environment & env, AP_SYSTEMS & systems, Coupling coupling) {
+void Embodiment::Couple(Environment & env, AP_SYSTEMS & systems, Coupling &coupling) {
+	Decouple();
 	environment = &env;
+	this->coupling = &coupling;
 	this->systems = systems;
-	this->actions.clear();
-	this->observations.clear();
-	this->states.clear();
+	fixed_buffers = env.GetObservationSize() && env.GetActionSize() && env.GetStateSize();
 	AP_SYSTEMS::iterator it;
 	for (it = systems.begin(); it != systems.end(); ++it) {
-		Action *action = new Action(0);
-		Observation *observation = new Observation(0);
-		State *state = new State(0);
+		Action *action = new Action(env.GetActionSize());
+		Observation *observation = new Observation(env.GetObservationSize());
+		State *state = new State(env.GetStateSize());
 		actions.push_back(action);
 		observations.push_back(observation);
 		states.push_back(state);
+		delayed_actions.push_back(new Action(env.GetActionSize()));
+		next_observations.push_back(new Observation(env.GetObservationSize()));
 	}
+	rewards.assign(systems.size(), 0);
+	SetRecording(record_capacity);
+	writers.assign(systems.size(), NULL);
 	environment->Init(observations, states);
 }
+
+/**
+ * The buffers are allocated at the first recorded tick, so this can be called before or after
+ * coupling. The observation that is recorded is the one the system acted upon.
+ */
+void Embodiment::SetRecording(size_t capacity) {
+	record_capacity = capacity;
+	traces.resize(systems.size());
+	for (unsigned int i = 0; i < traces.size(); ++i) {
+		traces[i].setCapacity(capacity);
+	}
+}
+
+void Embodiment::SetTraceWriter(int i, TraceWriter *writer) {
+	assert (i >= 0 && i < (int)writers.size());
+	assert (writer == NULL || writer->isOpen());
+	writers[i] = writer;
+}
+
+/**
+ * The environment and systems save themselves, mostly by sharing their state with the snapshot
+ * till one of them writes to it, the values that are exchanged are copied. What is recorded, the
+ * arena and the messages in the channels of the coupling are not part of the snapshot.
+ */
+Snapshot Embodiment::Save() const {
+	if (environment == NULL) return Snapshot();
+	EmbodimentSnapshot state;
+	state.environment = environment->Save();
+	if (state.environment.empty()) {
+		cerr << "The environment does not support snapshots" << endl;
+		return Snapshot();
+	}
+	for (unsigned int i = 0; i < systems.size(); ++i) {
+		state.systems.push_back(systems[i]->Save());
+		if (state.systems.back().empty()) {
+			cerr << "System " << i << " does not support snapshots" << endl;
+			return Snapshot();
+		}
+		state.observations.push_back(*observations[i]);
+		state.actions.push_back(*actions[i]);
+		state.states.push_back(*states[i]);
+	}
+	state.t = t;
+	return Snapshot(state);
+}
+
+/**
+ * The values are copied into the buffers in place, so after the first restore going back to the
+ * same state again does not allocate anything here.
+ */
+bool Embodiment::Restore(const Snapshot &snapshot) {
+	if (environment == NULL || !snapshot.is<EmbodimentSnapshot>()) return false;
+	const EmbodimentSnapshot &state = snapshot.get<EmbodimentSnapshot>();
+	if (state.systems.size() != systems.size()) {
+		cerr << "Snapshot of " << state.systems.size() << " systems, instead of " << systems.size() << endl;
+		return false;
+	}
+	if (!environment->Restore(state.environment)) return false;
+	for (unsigned int i = 0; i < systems.size(); ++i) {
+		if (!systems[i]->Restore(state.systems[i])) return false;
+		store(state.observations[i], *observations[i]);
+		store(state.actions[i], *actions[i]);
+		store(state.states[i], *states[i]);
+	}
+	t = state.t;
+	return true;
+}
+
+void Embodiment::SetThreads(size_t nof_threads) {
+	if (!nof_threads) nof_threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+	if (nof_threads == pool.getNofWorkers()) return;
+	pool.Start(nof_threads);
+}
+
+void Embodiment::SetPipelined(bool pipelined) {
+	if (pipelined == environment_thread.isRunning()) return;
+	if (!pipelined) {
+		environment_thread.Stop();
+		return;
+	}
+	if (!fixed_buffers) {
+		cerr << "The environment does not give the sizes of its buffers, it cannot be pipelined" << endl;
+		return;
+	}
+	environment_thread.Start();
+}
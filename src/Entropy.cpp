@@ -0,0 +1,254 @@
+/***************************************************************************************************
+ * @brief Entropy estimators that operate on histograms of counts
+ * @file Entropy.cpp
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#include <Entropy.h>
+
+#include <map>
+#include <iostream>
+#include <assert.h>
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <boost/math/special_functions/digamma.hpp>
+#include <boost/math/special_functions/trigamma.hpp>
+
+using namespace std;
+
+//! Number of grid points for the integration over the NSB prior
+#define NSB_GRID_SIZE 400
+
+/**
+ * The logarithm is split in an exponent and a mantissa, x = 2^e * m, with m in [sqrt(1/2),sqrt(2)).
+ * Then ln(x) = e*ln(2) + ln(m) and ln(m) = 2*atanh(s) with s = (m-1)/(m+1), of which |s| < 0.172. The
+ * odd series of atanh converges quickly for such small values of s. There are no branches and no
+ * table lookups, so the loop in vlog can be vectorized.
+ */
+static inline PROB_TYPE fast_log(PROB_TYPE x) {
+	uint64_t bits;
+	memcpy(&bits, &x, sizeof(bits));
+	// only the upper 32 bits are inspected, SSE2 does not know 64-bit integer comparisons
+	uint32_t high = (uint32_t)(bits >> 32);
+	int32_t big = ((high & 0x000fffff) > 0x6a09e);
+	PROB_TYPE e = (PROB_TYPE)((int32_t)(high >> 20) - 1023 + big);
+	high = (high & 0x000fffff) | ((uint32_t)(0x3ff - big) << 20);
+	bits = (bits & 0xffffffffULL) | ((uint64_t)high << 32);
+	PROB_TYPE m;
+	memcpy(&m, &bits, sizeof(m));
+	PROB_TYPE s = (m - 1.0) / (m + 1.0);
+	PROB_TYPE s2 = s * s;
+	PROB_TYPE p = 2.0/15 + s2 * (2.0/17);
+	p = 2.0/13 + s2 * p;
+	p = 2.0/11 + s2 * p;
+	p = 2.0/9 + s2 * p;
+	p = 2.0/7 + s2 * p;
+	p = 2.0/5 + s2 * p;
+	p = 2.0/3 + s2 * p;
+	p = 2.0 + s2 * p;
+	return e * M_LN2 + s * p;
+}
+
+void vlog(const PROB_TYPE *x, PROB_TYPE *y, size_t n) {
+	for (size_t i = 0; i < n; ++i) {
+		y[i] = fast_log(x[i]);
+	}
+}
+
+Entropy::Entropy() {
+	estimator = EE_PLUGIN;
+	nlogn_table.resize(NLOGN_TABLE_SIZE);
+	for (int n = 0; n < NLOGN_TABLE_SIZE; ++n) {
+		nlogn_table[n] = n;
+	}
+	// ln(1) = 0, so we can start at 1 and avoid ln(0)
+	vlog(&nlogn_table[1], &nlogn_table[1], NLOGN_TABLE_SIZE - 1);
+	for (int n = 1; n < NLOGN_TABLE_SIZE; ++n) {
+		nlogn_table[n] *= n;
+	}
+	nlogn_table[0] = 0;
+}
+
+Entropy::~Entropy() {
+}
+
+EntropyEstimator Entropy::getEstimator() const {
+	return estimator;
+}
+
+void Entropy::setEstimator(EntropyEstimator estimator) {
+	this->estimator = estimator;
+}
+
+PROB_TYPE Entropy::log_slow(FREQ_TYPE n) {
+	return log((PROB_TYPE)n);
+}
+
+/**
+ * Small counts are looked up in the n*log(n) table. The large ones are collected and their
+ * logarithms are calculated in one batch by vlog.
+ */
+void Entropy::sumCounts(const FREQ_TYPE *counts, size_t size, PROB_TYPE &sum_nlogn,
+		FREQ_TYPE &total, size_t &nonzero) {
+	sum_nlogn = 0;
+	total = 0;
+	nonzero = 0;
+	large_counts.clear();
+	for (size_t i = 0; i < size; ++i) {
+		FREQ_TYPE n = counts[i];
+		assert (n >= 0);
+		total += n;
+		nonzero += (n != 0);
+		if (n < NLOGN_TABLE_SIZE) {
+			sum_nlogn += nlogn_table[n];
+		} else {
+			large_counts.push_back(n);
+		}
+	}
+	if (large_counts.empty()) return;
+	size_t nof_large = large_counts.size();
+	large_counts.resize(2 * nof_large);
+	vlog(&large_counts[0], &large_counts[nof_large], nof_large);
+	for (size_t i = 0; i < nof_large; ++i) {
+		sum_nlogn += large_counts[i] * large_counts[nof_large + i];
+	}
+}
+
+/**
+ * With N = sum_i n_i the plug-in estimate is H = - sum_i n_i/N ln(n_i/N) = ln(N) - 1/N sum_i n_i ln(n_i).
+ * The Miller-Madow correction adds (K-1)/2N nats, in which K is the number of non-zero bins. This
+ * removes the first order bias term of the plug-in estimate.
+ */
+PROB_TYPE Entropy::calculate(const FREQ_TYPE *counts, size_t size, size_t alphabet_size) {
+	if (!alphabet_size) alphabet_size = size;
+	assert (alphabet_size >= size);
+	PROB_TYPE sum_nlogn; FREQ_TYPE total; size_t nonzero;
+	sumCounts(counts, size, sum_nlogn, total, nonzero);
+	if (total == 0) return PROB_TYPE(0);
+
+	PROB_TYPE result;
+	switch (estimator) {
+	case EE_PLUGIN:
+		result = log((PROB_TYPE)total) - sum_nlogn / total;
+		break;
+	case EE_MILLER_MADOW:
+		result = log((PROB_TYPE)total) - sum_nlogn / total + (nonzero - 1) / (2.0 * total);
+		break;
+	case EE_NSB:
+		result = calcNSB(counts, size, alphabet_size);
+		break;
+	default:
+		cerr << "Unknown entropy estimator" << endl;
+		return PROB_TYPE(-1.0);
+	}
+	return result / M_LN2;
+}
+
+PROB_TYPE Entropy::calculate(const std::vector<FREQ_TYPE> &counts, size_t alphabet_size) {
+	if (counts.empty()) return PROB_TYPE(0);
+	return calculate(&counts[0], counts.size(), alphabet_size);
+}
+
+/**
+ * The probabilities are assumed to sum to one. Zeros are skipped, because lim_{p->0} p ln(p) = 0.
+ */
+PROB_TYPE Entropy::calculate(const Point &probabilities) {
+	PROB_TYPE result = 0;
+	large_counts.clear();
+	for (size_t i = 0; i < probabilities.size(); ++i) {
+		if (probabilities[i] > 0) large_counts.push_back(probabilities[i]);
+	}
+	size_t nonzero = large_counts.size();
+	if (!nonzero) return result;
+	large_counts.resize(2 * nonzero);
+	vlog(&large_counts[0], &large_counts[nonzero], nonzero);
+	for (size_t i = 0; i < nonzero; ++i) {
+		result -= large_counts[i] * large_counts[nonzero + i];
+	}
+	return result / M_LN2;
+}
+
+/**
+ * The NSB estimator uses a mixture of symmetric Dirichlet priors with concentration β, such that the
+ * prior on the entropy itself is approximately flat. With ξ(β) = ψ(Kβ+1) - ψ(β+1) the expected
+ * entropy under a Dirichlet(β) prior, the estimate is:
+ *   H = ∫ dξ P(n|β) <H|n,β> / ∫ dξ P(n|β)
+ * with the evidence P(n|β) = Γ(Kβ)/Γ(N+Kβ) prod_i Γ(n_i+β)/Γ(β) and the posterior mean:
+ *   <H|n,β> = ψ(N+Kβ+1) - sum_i (n_i+β)/(N+Kβ) ψ(n_i+β+1)
+ * The integral is evaluated over a grid in ln(β), hence dξ = ξ'(β) β d(ln β). Bins with equal counts
+ * give equal terms, so the sums are over the distinct counts only. For sparse histograms that are
+ * mostly ones and twos these are just a few terms, and all empty bins together are one term.
+ */
+PROB_TYPE Entropy::calcNSB(const FREQ_TYPE *counts, size_t size, size_t alphabet_size) {
+	using boost::math::digamma;
+	using boost::math::trigamma;
+
+	// multiplicities: how many bins have a given count (including the empty bins)
+	std::map<FREQ_TYPE, PROB_TYPE> multiplicity;
+	FREQ_TYPE total = 0;
+	size_t nonzero = 0;
+	for (size_t i = 0; i < size; ++i) {
+		if (!counts[i]) continue;
+		multiplicity[counts[i]] += 1;
+		total += counts[i];
+		++nonzero;
+	}
+	PROB_TYPE K = alphabet_size;
+	PROB_TYPE N = total;
+	if (alphabet_size < 2) return PROB_TYPE(0);
+
+	// the relevant range of β scales with the alphabet size
+	PROB_TYPE log_beta_min = log(1e-4 / K);
+	PROB_TYPE log_beta_max = log(1e4);
+	PROB_TYPE step = (log_beta_max - log_beta_min) / (NSB_GRID_SIZE - 1);
+
+	std::vector<PROB_TYPE> log_weight(NSB_GRID_SIZE);
+	std::vector<PROB_TYPE> mean_entropy(NSB_GRID_SIZE);
+	PROB_TYPE max_log_weight = -HUGE_VAL;
+	for (int g = 0; g < NSB_GRID_SIZE; ++g) {
+		PROB_TYPE log_beta = log_beta_min + g * step;
+		PROB_TYPE beta = exp(log_beta);
+		PROB_TYPE Kb = K * beta;
+		PROB_TYPE dxi = K * trigamma(Kb + 1) - trigamma(beta + 1);
+		PROB_TYPE log_evidence = lgamma(Kb) - lgamma(N + Kb);
+		PROB_TYPE H = digamma(N + Kb + 1);
+		std::map<FREQ_TYPE, PROB_TYPE>::const_iterator it;
+		for (it = multiplicity.begin(); it != multiplicity.end(); ++it) {
+			PROB_TYPE nb = it->first + beta;
+			log_evidence += it->second * (lgamma(nb) - lgamma(beta));
+			H -= it->second * nb / (N + Kb) * digamma(nb + 1);
+		}
+		H -= (K - nonzero) * beta / (N + Kb) * digamma(beta + 1);
+		log_weight[g] = log_evidence + log(dxi * beta);
+		mean_entropy[g] = H;
+		if (log_weight[g] > max_log_weight) max_log_weight = log_weight[g];
+	}
+
+	// trapezoidal rule, the weights are scaled by the maximum to prevent underflow
+	PROB_TYPE numerator = 0, denominator = 0;
+	for (int g = 0; g < NSB_GRID_SIZE; ++g) {
+		PROB_TYPE w = exp(log_weight[g] - max_log_weight);
+		if (g == 0 || g == NSB_GRID_SIZE - 1) w *= 0.5;
+		numerator += w * mean_entropy[g];
+		denominator += w;
+	}
+	return numerator / denominator;
+}
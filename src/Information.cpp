@@ -26,6 +26,7 @@
 #include <numeric>
 #include <math.h>
 #include <iostream>
+#include <assert.h>
 
 using namespace std;
 
@@ -36,6 +37,13 @@ InfoType Information::getInfoType() const
 
 Information::Information()
 {
+	info_type = IT_MUTUAL_INFORMATION;
+	sensorimotor_path = NULL;
+	nof_processed = 0;
+	range_min = 0;
+	range_max = 1;
+	observation_size = action_size = 0;
+	Clear();
 }
 
 Information::~Information()
@@ -47,12 +55,29 @@ void Information::setInfoType(InfoType infoType)
     info_type = infoType;
 }
 
-int Information::Calculate()
+EntropyEstimator Information::getEstimator() const
+{
+	return entropy.getEstimator();
+}
+
+void Information::setEstimator(EntropyEstimator estimator)
+{
+	entropy.setEstimator(estimator);
+}
+
+/**
+ * The value of the metric for all pairs counted so far. This can be called every tick, it does
+ * not go over the sensorimotor path again.
+ */
+PROB_TYPE Information::Calculate()
 {
 	switch (info_type) {
 	case IT_EMPOWERMENT:
-		CalculateEmpowerment();
-		break;
+		return CalculateEmpowerment();
+	case SENSORIMOTOR_ENTROPY:
+		return getSensorimotorEntropy();
+	case IT_MUTUAL_INFORMATION:
+		return getMutualInformation();
 	default:
 		cerr << "Unknown information type" << endl;
 		break;
@@ -61,9 +86,181 @@ int Information::Calculate()
 }
 
 int Information::CalculateEmpowerment() {
+	cerr << "Not implemented (yet), sorry!" << endl;
+	return 0;
+}
 
+void Information::setSensorimotorPath(SensorimotorPath *path)
+{
+	sensorimotor_path = path;
+	nof_processed = 0;
+}
+
+/**
+ * A std::list iterator stays valid when elements are appended, so we can continue from the
+ * last entry that has been counted. This is O(1) per new entry.
+ */
+void Information::Update()
+{
+	assert (sensorimotor_path != NULL);
+	if (sensorimotor_path->size() == nof_processed) return;
+	SensorimotorPath::iterator it = sensorimotor_path->begin();
+	if (nof_processed) {
+		it = last_processed;
+		++it;
+	}
+	for (; it != sensorimotor_path->end(); ++it) {
+		SensationActionPair *pair = *it;
+		Add(pair->observation.data(), pair->observation.size(), pair->action.data(),
+				pair->action.size());
+		last_processed = it;
+		++nof_processed;
+	}
 }
 
+void Information::Append(SensationActionPair *pair)
+{
+	assert (sensorimotor_path != NULL);
+	sensorimotor_path->push_back(pair);
+	Update();
+}
+
+/**
+ * The observation and the action are each mapped to one symbol, and their combination to a joint
+ * symbol. The sizes of the observations and actions are not allowed to change, they determine the
+ * size of the alphabets when the first pair is counted.
+ */
+void Information::Add(const AP_TYPE *observation, size_t observation_size, const AP_TYPE *action,
+		size_t action_size)
+{
+	if (!Prepare(observation_size, action_size)) return;
+	Count(GetSymbol(observation, observation_size, 0), GetSymbol(action, action_size, observation_size));
+}
+
+void Information::Add(const ColumnarView &view)
+{
+	for (size_t i = 0; i < view.size(); ++i) {
+		Add(view.observation(i), view.getObservationSize(), view.action(i), view.getActionSize());
+	}
+}
+
+void Information::Clear()
+{
+	RunningHistogram *histograms[] = { &sensor_histogram, &motor_histogram, &sensorimotor_histogram };
+	for (int i = 0; i < 3; ++i) {
+		histograms[i]->counts.clear();
+		histograms[i]->sum_nlogn = 0;
+		histograms[i]->total = 0;
+		histograms[i]->alphabet = 1;
+	}
+	prepared = false;
+	if (sensorimotor_path != NULL && !sensorimotor_path->empty()) {
+		last_processed = --sensorimotor_path->end();
+		nof_processed = sensorimotor_path->size();
+	}
+}
+
+bool Information::setNofBins(int nofBins)
+{
+	if (sensorimotor_histogram.total) {
+		cerr << "The number of bins cannot change after pairs have been counted" << endl;
+		return false;
+	}
+	prepared = false;
+	return quantizer.setNofBins(nofBins);
+}
+
+int Information::getNofBins() const
+{
+	return quantizer.getNofBins();
+}
+
+bool Information::setRange(AP_TYPE min, AP_TYPE max)
+{
+	if (sensorimotor_histogram.total) {
+		cerr << "The range cannot change after pairs have been counted" << endl;
+		return false;
+	}
+	if (!(max > min)) {
+		cerr << "Range [" << min << ", " << max << "] is empty" << endl;
+		return false;
+	}
+	range_min = min;
+	range_max = max;
+	prepared = false;
+	return quantizer.setChannels(quantizer.getNofChannels(), min, max);
+}
+
+/**
+ * Called for every pair, so once the alphabets are set only the sizes are compared. An alphabet
+ * that does not fit is reported once, after that its pairs are skipped without a message.
+ */
+bool Information::Prepare(size_t observation_size, size_t action_size)
+{
+	if (prepared && observation_size == this->observation_size && action_size == this->action_size) {
+		return sensorimotor_histogram.alphabet;
+	}
+	if (sensorimotor_histogram.total) {
+		cerr << "Observation and action of size " << observation_size << " and " << action_size
+				<< ", the counted ones had " << this->observation_size << " and " << this->action_size
+				<< endl;
+		return false;
+	}
+	int nof_channels = observation_size + action_size;
+	if (quantizer.getNofChannels() != nof_channels) {
+		quantizer.setChannels(nof_channels, range_min, range_max);
+	}
+	prepared = true;
+	this->observation_size = observation_size;
+	this->action_size = action_size;
+	sensor_histogram.alphabet = GetSymbol(NULL, observation_size, 0);
+	motor_histogram.alphabet = GetSymbol(NULL, action_size, observation_size);
+	if (!sensor_histogram.alphabet || !motor_histogram.alphabet ||
+			sensor_histogram.alphabet > UINT64_MAX / motor_histogram.alphabet) {
+		cerr << "The symbols of " << nof_channels << " values with " << quantizer.getNofBins()
+				<< " bins do not fit in 64 bits, they are not counted" << endl;
+		sensorimotor_histogram.alphabet = 0;
+		return false;
+	}
+	sensorimotor_histogram.alphabet = sensor_histogram.alphabet * motor_histogram.alphabet;
+	return true;
+}
+
+void Information::Count(uint64_t sensor_symbol, uint64_t motor_symbol)
+{
+	Increment(sensor_histogram, sensor_symbol);
+	Increment(motor_histogram, motor_symbol);
+	Increment(sensorimotor_histogram, sensor_symbol * motor_histogram.alphabet + motor_symbol);
+}
+
+/**
+ * With values NULL this returns the alphabet size, nof_bins^size, or 0 if that does not fit in
+ * 64 bits. Prepare checks that, so the symbols of values, which are smaller, cannot overflow.
+ */
+uint64_t Information::GetSymbol(const AP_TYPE *values, size_t size, int first)
+{
+	uint64_t nof_bins = quantizer.getNofBins();
+	uint64_t symbol = 0;
+	if (values == NULL) {
+		for (size_t i = 0; i < size; ++i) {
+			if (symbol > (UINT64_MAX - nof_bins) / nof_bins) return 0;
+			symbol = symbol * nof_bins + nof_bins - 1;
+		}
+		return symbol + 1;
+	}
+	for (size_t i = 0; i < size; ++i) {
+		symbol = symbol * nof_bins + quantizer.GetBin(first + i, values[i]);
+	}
+	return symbol;
+}
+
+void Information::Increment(RunningHistogram & histogram, uint64_t symbol)
+{
+	FREQ_TYPE &n = histogram.counts[symbol];
+	histogram.sum_nlogn += entropy.nlogn(n + 1) - entropy.nlogn(n);
+	++n;
+	++histogram.total;
+}
 
 /**********************************************************************************************
  * Helper functions that can operate on standard containers.
@@ -91,19 +288,41 @@ AP_TYPE euclidean(AP_TYPE x, AP_TYPE y) {
 //	}
 //};
 
-template<class T>
-T likeliness(T sum, T value) {
-	return sum+value*log10(value);
-}
-
 /**********************************************************************************************
  * Helper functions that calculate standard information-metrics like entropy
  * They operate on the RandomVariable structure
  *********************************************************************************************/
 
-int Information::Uncertainty(Point & var) {
-	Point::iterator i;
-	return -accumulate(var.begin(), var.end(), PROB_TYPE(0), likeliness<PROB_TYPE>);
+PROB_TYPE Information::Uncertainty(Point & var) {
+	return entropy.calculate(var);
+}
+
+PROB_TYPE Information::Uncertainty(const std::vector<FREQ_TYPE> & counts, size_t alphabet_size) {
+	return entropy.calculate(counts, alphabet_size);
+}
+
+/**
+ * H = ln(N) - 1/N sum_i n_i ln(n_i), the Miller-Madow correction only needs the number of non-zero
+ * bins on top of that. The NSB estimator needs all counts.
+ */
+PROB_TYPE Information::Uncertainty(const RunningHistogram & histogram) {
+	PROB_TYPE N = histogram.total;
+	if (!histogram.total) return PROB_TYPE(0);
+	switch (entropy.getEstimator()) {
+	case EE_PLUGIN:
+		return (log(N) - histogram.sum_nlogn / N) / M_LN2;
+	case EE_MILLER_MADOW:
+		return (log(N) - histogram.sum_nlogn / N + (histogram.counts.size() - 1) / (2 * N)) / M_LN2;
+	default:
+		break;
+	}
+	std::vector<FREQ_TYPE> counts;
+	counts.reserve(histogram.counts.size());
+	boost::unordered_map<uint64_t, FREQ_TYPE>::const_iterator it;
+	for (it = histogram.counts.begin(); it != histogram.counts.end(); ++it) {
+		counts.push_back(it->second);
+	}
+	return entropy.calculate(counts, histogram.alphabet);
 }
 
 //void Information::JointProbability(Point &x, Point &y, Point &xy) {
@@ -0,0 +1,221 @@
+/***************************************************************************************************
+ * @brief Value iteration, policy iteration and modified policy iteration on a transition table
+ * @file MDPSolver.cpp
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#include <MDPSolver.h>
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <assert.h>
+#include <math.h>
+
+using namespace std;
+
+MDPSolver::MDPSolver() {
+	discount_factor = 0.9;
+	tolerance = 1e-6;
+	gauss_seidel = true;
+	max_iterations = 100000;
+	bound = numeric_limits<AP_TYPE>::infinity();
+	iterations = 0;
+}
+
+/**
+ * With a discount factor of 1 or more the values need not exist, and the matrix of the exact
+ * evaluation can be singular, so the solvers refuse it.
+ */
+bool MDPSolver::Reset(const TransitionTable &table) {
+	values.clear();
+	policy.clear();
+	bound = numeric_limits<AP_TYPE>::infinity();
+	iterations = 0;
+	if (!table.isPrepared()) {
+		cerr << "The transition table is not prepared" << endl;
+		return false;
+	}
+	if (!(discount_factor >= 0 && discount_factor < 1)) {
+		cerr << "Discount factor " << discount_factor << " is not in [0, 1)" << endl;
+		return false;
+	}
+	values.assign(table.getNofStates(), 0);
+	policy.assign(table.getNofStates(), 0);
+	return true;
+}
+
+AP_TYPE MDPSolver::Backup(const TransitionTable &table, const std::vector<AP_TYPE> &values,
+		size_t state, size_t action) const {
+	AP_TYPE reward = 0, future = 0;
+	for (const Transition *t = table.begin(state, action); t != table.end(state, action); ++t) {
+		reward += t->probability * t->reward;
+		future += t->probability * values[t->next];
+	}
+	return reward + discount_factor * future;
+}
+
+/**
+ * Another action only wins if it is better by more than rounding errors, so policy iteration does
+ * not alternate between actions of the same value.
+ */
+AP_TYPE MDPSolver::Improve(const TransitionTable &table, const std::vector<AP_TYPE> &values,
+		size_t state, uint32_t &action) const {
+	AP_TYPE best = Backup(table, values, state, action);
+	for (uint32_t a = 0; a < table.getNofActions(); ++a) {
+		if (a == action) continue;
+		AP_TYPE value = Backup(table, values, state, a);
+		if (value > best + 1e-12 * (1 + fabs(best))) {
+			best = value;
+			action = a;
+		}
+	}
+	return best;
+}
+
+AP_TYPE MDPSolver::Sweep(const TransitionTable &table, bool greedy) {
+	if (!gauss_seidel) previous = values;
+	const std::vector<AP_TYPE> &source = gauss_seidel ? values : previous;
+	AP_TYPE change = 0;
+	for (size_t s = 0; s < values.size(); ++s) {
+		AP_TYPE value = greedy ? Improve(table, source, s, policy[s]) :
+				Backup(table, source, s, policy[s]);
+		change = max(change, (AP_TYPE)fabs(value - values[s]));
+		values[s] = value;
+	}
+	return change;
+}
+
+bool MDPSolver::ValueIteration(const TransitionTable &table) {
+	if (!Reset(table)) return false;
+	AP_TYPE factor = discount_factor / (1 - discount_factor);
+	bool converged = false;
+	while (!converged && iterations < max_iterations) {
+		++iterations;
+		bound = factor * Sweep(table, true);
+		converged = (bound < tolerance / 2);
+	}
+	// greedy with respect to the final values
+	for (size_t s = 0; s < values.size(); ++s) {
+		Improve(table, values, s, policy[s]);
+	}
+	return converged;
+}
+
+bool MDPSolver::PolicyIteration(const TransitionTable &table) {
+	if (!Reset(table)) return false;
+	while (iterations < max_iterations) {
+		++iterations;
+		if (!Evaluate(table, policy, values)) return false;
+		bool stable = true;
+		for (size_t s = 0; s < values.size(); ++s) {
+			uint32_t action = policy[s];
+			Improve(table, values, s, action);
+			stable = stable && (action == policy[s]);
+			policy[s] = action;
+		}
+		if (stable) {
+			bound = 0;
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * A greedy sweep, which gives the bound, followed by sweeps with the policy fixed.
+ */
+bool MDPSolver::ModifiedPolicyIteration(const TransitionTable &table, int sweeps) {
+	if (!Reset(table)) return false;
+	AP_TYPE factor = discount_factor / (1 - discount_factor);
+	bool converged = false;
+	while (!converged && iterations < max_iterations) {
+		++iterations;
+		bound = factor * Sweep(table, true);
+		converged = (bound < tolerance / 2);
+		for (int k = 0; k < sweeps && !converged; ++k) {
+			Sweep(table, false);
+		}
+	}
+	for (size_t s = 0; s < values.size(); ++s) {
+		Improve(table, values, s, policy[s]);
+	}
+	return converged;
+}
+
+/**
+ * Solves (I - gamma P) v = r for the transition matrix P and expected rewards r of the policy, with
+ * Gaussian elimination and partial pivoting on a dense matrix. The matrix is diagonally dominant
+ * for gamma < 1, so it is not singular.
+ */
+bool MDPSolver::Evaluate(const TransitionTable &table, const std::vector<uint32_t> &policy,
+		std::vector<AP_TYPE> &values) {
+	const size_t n = table.getNofStates();
+	values.clear();
+	if (!table.isPrepared() || !(discount_factor >= 0 && discount_factor < 1)) {
+		cerr << "Cannot evaluate a policy on a table that is not prepared or with discount factor "
+				<< discount_factor << endl;
+		return false;
+	}
+	if (policy.size() != n) {
+		cerr << "Policy for " << policy.size() << " states, instead of " << n << endl;
+		return false;
+	}
+	for (size_t s = 0; s < n; ++s) {
+		if (policy[s] >= table.getNofActions()) {
+			cerr << "Action " << policy[s] << " of state " << s << " is not in the table" << endl;
+			return false;
+		}
+	}
+	std::vector<AP_TYPE> matrix(n * n, 0);
+	values.assign(n, 0);
+	for (size_t s = 0; s < n; ++s) {
+		AP_TYPE *row = &matrix[s * n];
+		row[s] = 1;
+		for (const Transition *t = table.begin(s, policy[s]); t != table.end(s, policy[s]); ++t) {
+			row[t->next] -= discount_factor * t->probability;
+			values[s] += t->probability * t->reward;
+		}
+	}
+	for (size_t c = 0; c < n; ++c) {
+		size_t pivot = c;
+		for (size_t r = c + 1; r < n; ++r) {
+			if (fabs(matrix[r * n + c]) > fabs(matrix[pivot * n + c])) pivot = r;
+		}
+		if (pivot != c) {
+			std::swap_ranges(&matrix[c * n], &matrix[c * n] + n, &matrix[pivot * n]);
+			std::swap(values[c], values[pivot]);
+		}
+		for (size_t r = c + 1; r < n; ++r) {
+			AP_TYPE factor = matrix[r * n + c] / matrix[c * n + c];
+			if (factor == 0) continue;
+			for (size_t k = c; k < n; ++k) {
+				matrix[r * n + k] -= factor * matrix[c * n + k];
+			}
+			values[r] -= factor * values[c];
+		}
+	}
+	for (size_t c = n; c-- > 0; ) {
+		for (size_t k = c + 1; k < n; ++k) {
+			values[c] -= matrix[c * n + k] * values[k];
+		}
+		values[c] /= matrix[c * n + c];
+	}
+	return true;
+}
@@ -0,0 +1,205 @@
+/***************************************************************************************************
+ * @brief The Markov chain of a fixed policy: stationary distribution and exact reward curves
+ * @file MarkovChain.cpp
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#include <MarkovChain.h>
+
+#include <algorithm>
+#include <iostream>
+#include <assert.h>
+#include <math.h>
+
+using namespace std;
+
+MarkovChain::MarkovChain() {
+	rows.assign(1, 0);
+}
+
+bool MarkovChain::Build(const TransitionTable &table, const std::vector<uint32_t> &policy) {
+	const size_t n = table.getNofStates();
+	rows.assign(1, 0);
+	columns.clear();
+	probabilities.clear();
+	outcome_rewards.clear();
+	rewards.clear();
+	squared_rewards.clear();
+	if (!table.isPrepared() || policy.size() != n) {
+		cerr << "Policy for " << policy.size() << " states on a table of " << n << " states"
+				<< (table.isPrepared() ? "" : " that is not prepared") << endl;
+		return false;
+	}
+	for (size_t s = 0; s < n; ++s) {
+		if (policy[s] >= table.getNofActions()) {
+			cerr << "Action " << policy[s] << " of state " << s << " is not in the table" << endl;
+			return false;
+		}
+	}
+	rewards.assign(n, 0);
+	squared_rewards.assign(n, 0);
+	for (size_t s = 0; s < n; ++s) {
+		for (const Transition *t = table.begin(s, policy[s]); t != table.end(s, policy[s]); ++t) {
+			columns.push_back(t->next);
+			probabilities.push_back(t->probability);
+			outcome_rewards.push_back(t->reward);
+			rewards[s] += t->probability * t->reward;
+			squared_rewards[s] += t->probability * t->reward * t->reward;
+		}
+		rows.push_back(columns.size());
+	}
+	return true;
+}
+
+void MarkovChain::Step(const std::vector<PROB_TYPE> &distribution, std::vector<PROB_TYPE> &next) const {
+	assert (distribution.size() == size() && &distribution != &next);
+	next.assign(size(), 0);
+	for (size_t s = 0; s < size(); ++s) {
+		PROB_TYPE p = distribution[s];
+		if (p == 0) continue;
+		for (uint32_t k = rows[s]; k < rows[s + 1]; ++k) {
+			next[columns[k]] += p * probabilities[k];
+		}
+	}
+}
+
+/**
+ * The distribution is normalized after every step, so rounding errors do not accumulate.
+ */
+bool MarkovChain::Stationary(std::vector<PROB_TYPE> &distribution, PROB_TYPE tolerance,
+		int max_iterations) const {
+	const size_t n = size();
+	if (!n) return false;
+	if (distribution.size() != n) distribution.assign(n, PROB_TYPE(1) / n);
+	std::vector<PROB_TYPE> next;
+	for (int i = 0; i < max_iterations; ++i) {
+		Step(distribution, next);
+		PROB_TYPE sum = 0;
+		for (size_t s = 0; s < n; ++s) {
+			next[s] = (next[s] + distribution[s]) / 2;
+			sum += next[s];
+		}
+		PROB_TYPE change = 0;
+		for (size_t s = 0; s < n; ++s) {
+			next[s] /= sum;
+			change += fabs(next[s] - distribution[s]);
+		}
+		distribution.swap(next);
+		if (change < tolerance) return true;
+	}
+	return false;
+}
+
+AP_TYPE MarkovChain::Mean(const std::vector<PROB_TYPE> &distribution) const {
+	assert (distribution.size() == size());
+	AP_TYPE mean = 0;
+	for (size_t s = 0; s < size(); ++s) {
+		mean += distribution[s] * rewards[s];
+	}
+	return mean;
+}
+
+AP_TYPE MarkovChain::Variance(const std::vector<PROB_TYPE> &distribution) const {
+	assert (distribution.size() == size());
+	AP_TYPE mean = 0, square = 0;
+	for (size_t s = 0; s < size(); ++s) {
+		mean += distribution[s] * rewards[s];
+		square += distribution[s] * squared_rewards[s];
+	}
+	return max(square - mean * mean, AP_TYPE(0));
+}
+
+bool MarkovChain::RewardCurve(const std::vector<PROB_TYPE> &start, size_t horizon,
+		std::vector<AP_TYPE> &means, std::vector<AP_TYPE> &variances) const {
+	if (start.size() != size()) {
+		cerr << "Distribution over " << start.size() << " states, instead of " << size() << endl;
+		return false;
+	}
+	means.resize(horizon);
+	variances.resize(horizon);
+	std::vector<PROB_TYPE> distribution = start, next;
+	for (size_t t = 0; t < horizon; ++t) {
+		means[t] = Mean(distribution);
+		variances[t] = Variance(distribution);
+		Step(distribution, next);
+		distribution.swap(next);
+	}
+	return true;
+}
+
+/**
+ * The value is v = r + gamma P v. The second moment of the return G = R + gamma G' is
+ *   m = E[R^2] + 2 gamma E[R v(s')] + gamma^2 P m,
+ * since G' and R are independent given the next state, and the variance is m - v^2. Both are
+ * solved with Gauss-Seidel sweeps, which are contractions with factor gamma and gamma^2, so the
+ * same bound as in MDPSolver tells when to stop.
+ */
+bool MarkovChain::Return(AP_TYPE discount_factor, std::vector<AP_TYPE> &values,
+		std::vector<AP_TYPE> &variances, AP_TYPE tolerance, int max_iterations) const {
+	if (!(discount_factor >= 0 && discount_factor < 1)) {
+		cerr << "Discount factor " << discount_factor << " is not in [0, 1)" << endl;
+		return false;
+	}
+	const size_t n = size();
+	values.assign(n, 0);
+	std::vector<AP_TYPE> moments(n, 0), cross(n, 0);
+	bool converged = false;
+	AP_TYPE factor = discount_factor / (1 - discount_factor);
+	for (int i = 0; i < max_iterations && !converged; ++i) {
+		AP_TYPE change = 0;
+		for (size_t s = 0; s < n; ++s) {
+			AP_TYPE future = 0;
+			for (uint32_t k = rows[s]; k < rows[s + 1]; ++k) {
+				future += probabilities[k] * values[columns[k]];
+			}
+			AP_TYPE value = rewards[s] + discount_factor * future;
+			change = max(change, (AP_TYPE)fabs(value - values[s]));
+			values[s] = value;
+		}
+		converged = (factor * change < tolerance);
+	}
+	if (!converged) return false;
+
+	for (size_t s = 0; s < n; ++s) {
+		for (uint32_t k = rows[s]; k < rows[s + 1]; ++k) {
+			cross[s] += probabilities[k] * outcome_rewards[k] * values[columns[k]];
+		}
+	}
+	AP_TYPE gamma2 = discount_factor * discount_factor;
+	factor = gamma2 / (1 - gamma2);
+	converged = false;
+	for (int i = 0; i < max_iterations && !converged; ++i) {
+		AP_TYPE change = 0;
+		for (size_t s = 0; s < n; ++s) {
+			AP_TYPE future = 0;
+			for (uint32_t k = rows[s]; k < rows[s + 1]; ++k) {
+				future += probabilities[k] * moments[columns[k]];
+			}
+			AP_TYPE moment = squared_rewards[s] + 2 * discount_factor * cross[s] + gamma2 * future;
+			change = max(change, (AP_TYPE)fabs(moment - moments[s]));
+			moments[s] = moment;
+		}
+		converged = (factor * change < tolerance);
+	}
+	variances.resize(n);
+	for (size_t s = 0; s < n; ++s) {
+		variances[s] = max(moments[s] - values[s] * values[s], AP_TYPE(0));
+	}
+	return converged;
+}
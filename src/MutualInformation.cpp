@@ -75,6 +75,18 @@ PROB_TYPE MutualInformation::calculate(SensorimotorPath &path) {
 	return PROB_TYPE(-1.0);
 }
 
+PROB_TYPE MutualInformation::calculate(const ColumnarView &path) {
+	switch (mi_approximation) {
+	case MI_K_NEAREST_NEIGHBOUR:
+		return calckNNApproximation<DYNAMIC_SIZE, DYNAMIC_SIZE>(path, k_in_kNN);
+		break;
+	default:
+		cerr << "Not implemented (yet), sorry!" << endl;
+		break;
+	}
+	return PROB_TYPE(-1.0);
+}
+
 /**
  * The estimate is:
  * I(X,Y) = ψ(k)−1/N*sum_i{ψ(nx+1)+ψ(ny+1)}+ψ(N) with ψ the digamma function.
@@ -112,7 +124,8 @@ PROB_TYPE MutualInformation::calckNNApproximation(SensorimotorPath &path, int k)
 /**
  * Calculate the distance between two points. So, this returns the distance between e.g. two sensor values.
  */
-AP_TYPE MutualInformation::distance(const Point& p0, const Point& p1,
+template<typename V>
+AP_TYPE MutualInformation::distance(const V& p0, const V& p1,
 		DistanceMetric metric) {
 	if (p0.size() != p1.size()) {
 		cerr << "Points do not have the same dimension" << endl;
@@ -132,11 +145,21 @@ AP_TYPE MutualInformation::distance(const Point& p0, const Point& p1,
 /**
  * The maximum norm is used on the space Z=(X,Y).
  */
-AP_TYPE MutualInformation::maximumNorm(const Point& x0, const Point& x1, const Point &y0, const Point &y1,
+template<typename V>
+AP_TYPE MutualInformation::maximumNorm(const V& x0, const V& x1, const V &y0, const V &y1,
 		DistanceMetric metric) {
 	return max<AP_TYPE>(distance(x0,x1,metric),distance(y0, y1,metric));
 }
 
+// the distances are needed between points and between the values of samples
+template AP_TYPE MutualInformation::distance<Point>(const Point&, const Point&, DistanceMetric);
+template AP_TYPE MutualInformation::distance<SampleValues>(const SampleValues&, const SampleValues&,
+		DistanceMetric);
+template AP_TYPE MutualInformation::maximumNorm<Point>(const Point&, const Point&, const Point&,
+		const Point&, DistanceMetric);
+template AP_TYPE MutualInformation::maximumNorm<SampleValues>(const SampleValues&, const SampleValues&,
+		const SampleValues&, const SampleValues&, DistanceMetric);
+
 /**
  * The same maximum norm function, but now with SensationActionPair's as input, so it can be used for sorting.
  * Take notice that pointers are used, and the entities are not passed by references. This screws up the boost::bind
@@ -189,10 +212,14 @@ AP_TYPE MutualInformation::getNearestDistance(SensorimotorContainer & set, const
 		}
 		return winner_value;
 	} else {
-		// use boost::bind for sorting with a member function with additional argument
+		// use boost::bind for sorting with a member function with additional argument, the cast picks
+		// the overload of maximumNorm for pairs
+		typedef AP_TYPE (MutualInformation::*PairNorm)(const SensationActionPair*,
+				const SensationActionPair*, DistanceMetric);
+		PairNorm norm = &MutualInformation::maximumNorm;
 	    sort(set.begin(), set.end(),
-	    		boost::bind<AP_TYPE>(&MutualInformation::maximumNorm, this, _1, &p, DM_EUCLIDEAN) <
-	    		boost::bind<AP_TYPE>(&MutualInformation::maximumNorm, this, _2, &p, DM_EUCLIDEAN)
+	    		boost::bind<AP_TYPE>(norm, this, _1, &p, DM_EUCLIDEAN) <
+	    		boost::bind<AP_TYPE>(norm, this, _2, &p, DM_EUCLIDEAN)
 	    );
 //		cout << "Sorted: " << endl;
 //		it = set.begin();
@@ -0,0 +1,152 @@
+/***************************************************************************************************
+ * @brief Streaming estimation of quantiles with bounded memory
+ * @file QuantileSketch.cpp
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#include <QuantileSketch.h>
+
+#include <algorithm>
+#include <assert.h>
+#include <math.h>
+
+//! The buffer is merged when it has this many times "compression" values
+#define BUFFER_FACTOR 5
+
+static bool compare_mean(const Centroid &c0, const Centroid &c1) {
+	return c0.mean < c1.mean;
+}
+
+QuantileSketch::QuantileSketch(AP_TYPE compression) {
+	assert (compression > 0);
+	this->compression = compression;
+	Clear();
+}
+
+QuantileSketch::~QuantileSketch() {
+}
+
+void QuantileSketch::Clear() {
+	centroids.clear();
+	buffer.clear();
+	buffer.reserve(BUFFER_FACTOR * compression);
+	total_weight = 0;
+	min = HUGE_VAL;
+	max = -HUGE_VAL;
+}
+
+void QuantileSketch::Add(AP_TYPE value, AP_TYPE weight) {
+	if (value != value) return; // NaN
+	Centroid c;
+	c.mean = value;
+	c.weight = weight;
+	buffer.push_back(c);
+	total_weight += weight;
+	min = (value < min) ? value : min;
+	max = (value > max) ? value : max;
+	if (buffer.size() >= BUFFER_FACTOR * compression) Compress();
+}
+
+void QuantileSketch::Add(const AP_TYPE *values, size_t size, size_t stride) {
+	for (size_t i = 0; i < size; ++i) {
+		Add(values[i * stride]);
+	}
+}
+
+/**
+ * The centroids of the other sketch are just weighted values to this one. They are all buffered
+ * before compressing, with the total weight already including them, since Compress sizes the
+ * centroids by their quantile in the total weight. Halfway through, that would be the quantile in
+ * a weight that is too small.
+ */
+void QuantileSketch::Merge(const QuantileSketch &other) {
+	total_weight += other.total_weight;
+	min = (other.min < min) ? other.min : min;
+	max = (other.max > max) ? other.max : max;
+	buffer.insert(buffer.end(), other.centroids.begin(), other.centroids.end());
+	buffer.insert(buffer.end(), other.buffer.begin(), other.buffer.end());
+	if (buffer.size() >= BUFFER_FACTOR * compression) Compress();
+}
+
+AP_TYPE QuantileSketch::Scale(AP_TYPE q) const {
+	return compression / (2 * M_PI) * asin(2 * q - 1);
+}
+
+/**
+ * All centroids and buffered values are sorted and walked through from left to right. A value is
+ * merged into the current centroid as long as the centroid stays small enough for its quantile.
+ */
+void QuantileSketch::Compress() {
+	if (buffer.empty()) return;
+	buffer.insert(buffer.end(), centroids.begin(), centroids.end());
+	std::sort(buffer.begin(), buffer.end(), compare_mean);
+	centroids.clear();
+
+	AP_TYPE weight_before = 0;
+	AP_TYPE k_left = Scale(0);
+	Centroid current = buffer[0];
+	for (size_t i = 1; i < buffer.size(); ++i) {
+		AP_TYPE q_right = (weight_before + current.weight + buffer[i].weight) / total_weight;
+		q_right = (q_right < 1) ? q_right : 1;
+		if (Scale(q_right) - k_left <= 1) {
+			current.weight += buffer[i].weight;
+			current.mean += (buffer[i].mean - current.mean) * buffer[i].weight / current.weight;
+		} else {
+			centroids.push_back(current);
+			weight_before += current.weight;
+			k_left = Scale(weight_before / total_weight);
+			current = buffer[i];
+		}
+	}
+	centroids.push_back(current);
+	buffer.clear();
+}
+
+size_t QuantileSketch::getNofCentroids() {
+	Compress();
+	return centroids.size();
+}
+
+/**
+ * The mean of a centroid is assumed to be at the middle of its weight, and between these the
+ * values are interpolated linearly. Before the first and after the last centroid the exact
+ * minimum and maximum are used.
+ */
+AP_TYPE QuantileSketch::Quantile(AP_TYPE q) {
+	Compress();
+	if (centroids.empty()) return 0;
+	if (q <= 0) return min;
+	if (q >= 1) return max;
+	AP_TYPE index = q * total_weight;
+
+	AP_TYPE left_value = min, left_index = 0;
+	AP_TYPE weight_before = 0;
+	for (size_t i = 0; i < centroids.size(); ++i) {
+		AP_TYPE center = weight_before + centroids[i].weight / 2;
+		if (index < center) {
+			AP_TYPE fraction = (index - left_index) / (center - left_index);
+			return left_value + fraction * (centroids[i].mean - left_value);
+		}
+		left_value = centroids[i].mean;
+		left_index = center;
+		weight_before += centroids[i].weight;
+	}
+	AP_TYPE fraction = (index - left_index) / (total_weight - left_index);
+	return left_value + fraction * (max - left_value);
+}
@@ -0,0 +1,249 @@
+/***************************************************************************************************
+ * @brief Conversion of sensor and actuator values to bin indices
+ * @file Quantizer.cpp
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#include <Quantizer.h>
+
+#include <algorithm>
+#include <iostream>
+#include <assert.h>
+
+using namespace std;
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#ifdef __AVX__
+#include <immintrin.h>
+#endif
+
+//! Up to this number of bins the edges are compared one by one in a vectorizable loop
+#define MAX_LINEAR_EDGES 64
+
+Quantizer::Quantizer() {
+	mode = QM_EQUAL_WIDTH;
+	setNofBins(10);
+}
+
+Quantizer::~Quantizer() {
+}
+
+bool Quantizer::setNofBins(int nofBins) {
+	if (nofBins < 1 || nofBins > MAX_NOF_BINS) {
+		cerr << "Number of bins " << nofBins << " is not in [1, " << MAX_NOF_BINS << "]" << endl;
+		return false;
+	}
+	nof_bins = nofBins;
+	max_bin = nof_bins - 1;
+	edges.assign(range_min.size() * (nof_bins - 1), 0);
+	for (size_t c = 0; c < range_min.size(); ++c) {
+		setRange(c, range_min[c], range_max[c]);
+	}
+	return true;
+}
+
+int Quantizer::getNofBins() const {
+	return nof_bins;
+}
+
+void Quantizer::setMode(QuantizerMode mode) {
+	this->mode = mode;
+}
+
+bool Quantizer::setChannels(int nof_channels, AP_TYPE min, AP_TYPE max) {
+	if (nof_channels < 0 || !(max >= min)) {
+		cerr << nof_channels << " channels with range [" << min << ", " << max << "]" << endl;
+		return false;
+	}
+	range_min.assign(nof_channels, min);
+	range_max.assign(nof_channels, max);
+	scale.assign(nof_channels, 0);
+	edges.assign(nof_channels * (nof_bins - 1), 0);
+	sketches.assign(nof_channels, QuantileSketch());
+	for (int c = 0; c < nof_channels; ++c) {
+		setRange(c, min, max);
+	}
+	return true;
+}
+
+/**
+ * A channel that always has the same value (min == max) gets all its values in the first bin. A
+ * range with NaN is refused as well, it would give NaN bins.
+ */
+bool Quantizer::setRange(int channel, AP_TYPE min, AP_TYPE max) {
+	if (channel < 0 || channel >= getNofChannels()) {
+		cerr << "There is no channel " << channel << ", there are " << getNofChannels() << endl;
+		return false;
+	}
+	if (!(max >= min)) {
+		cerr << "Range [" << min << ", " << max << "] of channel " << channel << " is empty or NaN"
+				<< endl;
+		return false;
+	}
+	range_min[channel] = min;
+	range_max[channel] = max;
+	scale[channel] = (max > min) ? nof_bins / (max - min) : 0;
+	UpdateEdges(channel);
+	return true;
+}
+
+/**
+ * As long as nothing has been learned the edges are those of equal-width bins.
+ */
+void Quantizer::UpdateEdges(int channel) {
+	AP_TYPE *edge = edges.data() + channel * (nof_bins - 1);
+	QuantileSketch &sketch = sketches[channel];
+	for (int k = 1; k < nof_bins; ++k) {
+		if (sketch.getCount() > 0) {
+			edge[k - 1] = sketch.Quantile(k / (AP_TYPE)nof_bins);
+		} else {
+			edge[k - 1] = range_min[channel] + k * (range_max[channel] - range_min[channel]) / nof_bins;
+		}
+	}
+}
+
+bool Quantizer::Learn(int channel, const AP_TYPE *column, size_t size, size_t stride, bool extend) {
+	if (channel < 0 || channel >= getNofChannels()) {
+		cerr << "There is no channel " << channel << ", there are " << getNofChannels() << endl;
+		return false;
+	}
+	if (!size) return true;
+	if (mode == QM_EQUAL_FREQUENCY) {
+		if (!extend) sketches[channel].Clear();
+		sketches[channel].Add(column, size, stride);
+	}
+	AP_TYPE min = extend ? range_min[channel] : column[0];
+	AP_TYPE max = extend ? range_max[channel] : column[0];
+	for (size_t i = 0; i < size; ++i) {
+		AP_TYPE value = column[i * stride];
+		min = (value < min) ? value : min;
+		max = (value > max) ? value : max;
+	}
+	return setRange(channel, min, max);
+}
+
+/**
+ * The ranges are joined and the sketches are merged.
+ */
+bool Quantizer::Merge(const Quantizer &other) {
+	if (other.getNofChannels() != getNofChannels()) {
+		cerr << "Cannot merge " << other.getNofChannels() << " channels into " << getNofChannels()
+				<< endl;
+		return false;
+	}
+	for (int c = 0; c < getNofChannels(); ++c) {
+		sketches[c].Merge(other.sketches[c]);
+		AP_TYPE min = (other.range_min[c] < range_min[c]) ? other.range_min[c] : range_min[c];
+		AP_TYPE max = (other.range_max[c] > range_max[c]) ? other.range_max[c] : range_max[c];
+		setRange(c, min, max);
+	}
+	return true;
+}
+
+int Quantizer::GetQuantileBin(int channel, AP_TYPE value) const {
+	const AP_TYPE *edge = getEdges(channel);
+	return std::upper_bound(edge, edge + nof_bins - 1, value) - edge;
+}
+
+/**
+ * For a few bins it is quicker to compare every value with every edge than to do a binary search
+ * per value, because the former is a simple loop over the column that can be vectorized. The
+ * comparison is !(value < edge) to be the same as std::upper_bound, also for NaN.
+ */
+void Quantizer::QuantizeQuantiles(int channel, const AP_TYPE *column, size_t size, BIN_TYPE *bins,
+		size_t stride) const {
+	const AP_TYPE *edge = getEdges(channel);
+	if (nof_bins - 1 > MAX_LINEAR_EDGES) {
+		for (size_t i = 0; i < size; ++i) {
+			bins[i] = std::upper_bound(edge, edge + nof_bins - 1, column[i * stride]) - edge;
+		}
+		return;
+	}
+	for (size_t i = 0; i < size; ++i) {
+		bins[i] = 0;
+	}
+	for (int k = 0; k < nof_bins - 1; ++k) {
+		AP_TYPE e = edge[k];
+		for (size_t i = 0; i < size; ++i) {
+			bins[i] += !(column[i * stride] < e);
+		}
+	}
+}
+
+/**
+ * The value is scaled to [0, nof_bins), clamped, and truncated towards zero. The maximum value of
+ * the range itself would become nof_bins, the clamping puts it in the last bin. The truncated
+ * 32-bit integers are packed to 16 bits with signed saturation, that's why there can be at most
+ * 32768 bins. The remaining values at the end of the column are done one by one.
+ */
+void Quantizer::Quantize(int channel, const AP_TYPE *column, size_t size, BIN_TYPE *bins,
+		size_t stride) const {
+	assert (channel >= 0 && channel < getNofChannels());
+	if (mode == QM_EQUAL_FREQUENCY) {
+		QuantizeQuantiles(channel, column, size, bins, stride);
+		return;
+	}
+	size_t i = 0;
+#ifdef __AVX__
+	if (stride == 1) {
+		__m256d offset = _mm256_set1_pd(range_min[channel]);
+		__m256d factor = _mm256_set1_pd(scale[channel]);
+		__m256d zero = _mm256_setzero_pd();
+		__m256d last = _mm256_set1_pd(max_bin);
+		for (; i + 8 <= size; i += 8) {
+			__m256d v0 = _mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(column + i), offset), factor);
+			__m256d v1 = _mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(column + i + 4), offset), factor);
+			v0 = _mm256_min_pd(_mm256_max_pd(v0, zero), last);
+			v1 = _mm256_min_pd(_mm256_max_pd(v1, zero), last);
+			__m128i b = _mm_packs_epi32(_mm256_cvttpd_epi32(v0), _mm256_cvttpd_epi32(v1));
+			_mm_storeu_si128((__m128i*)(bins + i), b);
+		}
+	}
+#endif
+#ifdef __SSE2__
+	__m128d offset = _mm_set1_pd(range_min[channel]);
+	__m128d factor = _mm_set1_pd(scale[channel]);
+	__m128d zero = _mm_setzero_pd();
+	__m128d last = _mm_set1_pd(max_bin);
+	for (; i + 4 <= size; i += 4) {
+		const AP_TYPE *x = column + i * stride;
+		__m128d v0, v1;
+		if (stride == 1) {
+			v0 = _mm_loadu_pd(x);
+			v1 = _mm_loadu_pd(x + 2);
+		} else {
+			v0 = _mm_set_pd(x[stride], x[0]);
+			v1 = _mm_set_pd(x[3 * stride], x[2 * stride]);
+		}
+		v0 = _mm_mul_pd(_mm_sub_pd(v0, offset), factor);
+		v1 = _mm_mul_pd(_mm_sub_pd(v1, offset), factor);
+		v0 = _mm_min_pd(_mm_max_pd(v0, zero), last);
+		v1 = _mm_min_pd(_mm_max_pd(v1, zero), last);
+		// each conversion fills the lower two of four 32-bit integers
+		__m128i b = _mm_unpacklo_epi64(_mm_cvttpd_epi32(v0), _mm_cvttpd_epi32(v1));
+		b = _mm_packs_epi32(b, b);
+		_mm_storel_epi64((__m128i*)(bins + i), b);
+	}
+#endif
+	for (; i < size; ++i) {
+		bins[i] = GetBin(channel, column[i * stride]);
+	}
+}
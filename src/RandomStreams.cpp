@@ -0,0 +1,129 @@
+/***************************************************************************************************
+ * @brief Independent random number streams, one per instance of an environment
+ * @file RandomStreams.cpp
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#include <RandomStreams.h>
+#include <Batch.h>
+
+#include <assert.h>
+#include <math.h>
+
+RandomStreams::RandomStreams(size_t nof_streams, uint32_t seed) {
+	Seed(nof_streams, seed);
+}
+
+void RandomStreams::Seed(size_t nof_streams, uint32_t seed) {
+	seeds.assign(nof_streams, seed);
+	instances.resize(nof_streams);
+	numbers.assign(nof_streams, 0);
+	counters_low.assign(nof_streams, 0);
+	counters_high.assign(nof_streams, 0);
+	for (int w = 0; w < 4; ++w) {
+		words[w].resize(nof_streams);
+	}
+	for (size_t i = 0; i < nof_streams; ++i) {
+		instances[i] = i;
+	}
+	drawn = 4;
+}
+
+void RandomStreams::Reseed(size_t i, uint32_t seed, uint32_t stream) {
+	assert (i < seeds.size());
+	seeds[i] = seed;
+	instances[i] = i;
+	numbers[i] = stream;
+	counters_low[i] = counters_high[i] = 0;
+	if (drawn < 4) Generate(i);
+}
+
+void RandomStreams::Generate(size_t i) {
+	uint32_t c0 = counters_low[i], c1 = counters_high[i], c2 = numbers[i], c3 = 0;
+	philox(c0, c1, c2, c3, seeds[i], instances[i]);
+	words[0][i] = c0; words[1][i] = c1; words[2][i] = c2; words[3][i] = c3;
+	counters_high[i] += (++counters_low[i] == 0);
+}
+
+/**
+ * The same as Generate(i) for n streams, on restricted pointers so the loop is vectorized.
+ */
+static void GenerateBlocks(size_t n, const uint32_t *RESTRICT k0, const uint32_t *RESTRICT k1,
+		const uint32_t *RESTRICT s, uint32_t *RESTRICT low, uint32_t *RESTRICT high,
+		uint32_t *RESTRICT w0, uint32_t *RESTRICT w1, uint32_t *RESTRICT w2, uint32_t *RESTRICT w3) {
+	for (size_t i = 0; i < n; ++i) {
+		uint32_t c0 = low[i], c1 = high[i], c2 = s[i], c3 = 0;
+		philox(c0, c1, c2, c3, k0[i], k1[i]);
+		w0[i] = c0; w1[i] = c1; w2[i] = c2; w3[i] = c3;
+		low[i] += 1;
+		high[i] += (low[i] == 0);
+	}
+}
+
+void RandomStreams::Generate() {
+	drawn = 0;
+	if (seeds.empty()) return;
+	GenerateBlocks(seeds.size(), &seeds[0], &instances[0], &numbers[0], &counters_low[0],
+			&counters_high[0], &words[0][0], &words[1][0], &words[2][0], &words[3][0]);
+}
+
+void RandomStreams::Uniform(AP_TYPE *result) {
+	const size_t n = seeds.size();
+	if (!n) return;
+	if (drawn == 4) Generate();
+	const uint32_t *w = &words[drawn++][0];
+	for (size_t i = 0; i < n; ++i) {
+		result[i] = w[i] * (1.0 / 4294967296.0);
+	}
+}
+
+void RandomStreams::Bits(uint32_t *result) {
+	const size_t n = seeds.size();
+	if (!n) return;
+	if (drawn == 4) Generate();
+	const uint32_t *w = &words[drawn++][0];
+	for (size_t i = 0; i < n; ++i) {
+		result[i] = w[i];
+	}
+}
+
+/**
+ * The blocks that are skipped entirely are never generated, only the counters move on.
+ */
+void RandomStreams::Skip(uint64_t n) {
+	if (n <= 4 - drawn) {
+		drawn += n;
+		return;
+	}
+	n -= 4 - drawn;
+	uint64_t blocks = (n - 1) / 4;
+	for (size_t i = 0; i < seeds.size(); ++i) {
+		uint64_t counter = ((uint64_t)counters_high[i] << 32 | counters_low[i]) + blocks;
+		counters_low[i] = (uint32_t)counter;
+		counters_high[i] = (uint32_t)(counter >> 32);
+	}
+	Generate();
+	drawn = n - blocks * 4;
+}
+
+uint32_t RandomStreams::Threshold(AP_TYPE p) {
+	assert (p >= 0 && p <= 1);
+	AP_TYPE threshold = ceil(p * 4294967296.0);
+	return (threshold >= 4294967295.0) ? UINT32_MAX : (uint32_t)threshold;
+}
@@ -23,14 +23,32 @@
 
 #include <assert.h>
 #include <stddef.h>
+#include <iostream>
 #include <RandomVariableConverter.h>
 
+using namespace std;
+
+//! Upper limit on the number of bins in the buffer (joint and marginals together)
+#define MAX_DENSE_BINS (1 << 26)
+
+//! Below this number of bins a dense buffer is always cheap (it fits in the L2 cache)
+#define MIN_DENSE_BINS (1 << 16)
+
 RandomVariableConverter::RandomVariableConverter()
 {
-//	motor = new RandomVariable(0);
-//	sensor = new RandomVariable(0);
-//	sensorimotor = new RandomVariable(0);
-//	sensors_over_time = new RandomVariableSet(0);
+	motor = new Point(0);
+	sensor = new Point(0);
+	sensorimotor = new Point(0);
+	path = NULL;
+	columnar_path = NULL;
+	sensor_alphabet = motor_alphabet = 1;
+	joint_size = sensor_size = motor_size = 0;
+	nof_samples = 0;
+	histogram_mode = HM_AUTOMATIC;
+	sparse = false;
+	hashed = false;
+	learn_ranges = false;
+	setNofBins(10);
 }
 
 
@@ -43,140 +61,263 @@ RandomVariableConverter::~RandomVariableConverter()
 }
 
 /**
- * Sum the number of times that the value falls in the given bin.
+ * Every sensor value is a channel, followed by a channel for every actuator value. In the row-major
+ * matrices the values of one channel are a row length apart, which the quantizer handles as a stride.
+ * By default every channel has a range [0,1]. With 4 bins, they will span [0 - 0.25|0.25 - 0.5|
+ * 0.5 - 0.75|0.75 - 1.0], and 1 itself falls in the last bin.
  */
-//PROB_TYPE sum_equals(PROB_TYPE value, FREQ_TYPE bin) {
-//	value = value +
-//}
+void RandomVariableConverter::Quantize(const std::vector<ColumnarView> & input)
+{
+	int observation_size = input.front().getObservationSize();
+	int action_size = input.front().getActionSize();
+	int nof_channels = observation_size + action_size;
+	if (quantizer.getNofChannels() != nof_channels) {
+		quantizer.setChannels(nof_channels);
+	}
+	size_t N = nof_samples;
+	column_bins.resize(nof_channels * N);
 
-//PROB_TYPE get_sensor(PROB_TYPE value, FREQ_TYPE bin) {
-//	value = value +
-//}
+	for (int c = 0; c < nof_channels; ++c) {
+		size_t stride = (c < observation_size) ? observation_size : action_size;
+		if (learn_ranges) {
+			for (size_t v = 0; v < input.size(); ++v) {
+				quantizer.Learn(c, GetColumn(input[v], c), input[v].size(), stride, v > 0);
+			}
+		}
+		// the views follow each other in the column
+		size_t offset = 0;
+		for (size_t v = 0; v < input.size(); ++v) {
+			quantizer.Quantize(c, GetColumn(input[v], c), input[v].size(), &column_bins[c * N + offset],
+					stride);
+			offset += input[v].size();
+		}
+	}
+}
+
+const AP_TYPE *RandomVariableConverter::GetColumn(const ColumnarView & view, int channel) const
+{
+	int observation_size = view.getObservationSize();
+	return (channel < observation_size) ? view.getObservations() + channel :
+			view.getActions() + (channel - observation_size);
+}
 
 /**
- * The value should be normalized from 0 to 1. Subsequently the bin is easy
- * to pick. With 4 bins, they will span [0 - 0.25|0.25 - 0.5|0.5 - 0.75|0.75 - 1.0].
- * The bin width with 4 bins is 0.25. Hence, to get the bin index from 0 to 3,
- * say 0.66, you'll need to divide 0.66 by 0.25, which is 2 and something. The only
- * exception is 1. That value is corrected so it falls in the last bin.
+ * Row-major over the values: the last value changes fastest. So, with 4 bins the bins {1, 2, 3}
+ * become symbol 1*16 + 2*4 + 3. The loops go over entire columns, so they can be vectorized.
  */
-int RandomVariableConverter::GetBin(AP_TYPE value) {
-	if (value == (AP_TYPE)1.0) return nof_bins - 1;
-	return value / bin_width;
+void RandomVariableConverter::GetSymbols(int first, int last, std::vector<uint64_t> & result)
+{
+	size_t N = nof_samples;
+	uint64_t nof_bins = quantizer.getNofBins();
+	result.assign(N, 0);
+	for (int c = first; c < last; ++c) {
+		const BIN_TYPE *bin = &column_bins[c * N];
+		for (size_t i = 0; i < N; ++i) {
+			result[i] = result[i] * nof_bins + bin[i];
+		}
+	}
 }
 
 /**
- * Provided: inner_product
- * Starting with an initial value of @a init, multiplies successive
- * elements from the two ranges and adds each product into the accumulated
- * value using operator+(). The values in the ranges are processed in
- * order.
- * Hence, this is only over pair-wise elements and returns one value.
- *
- * Needed: extensive_product
- * Starting with the initial values in @a result, multiplies successive elements
- * from one range with all elements in the other range and puts them into the
- * accumulated vector using operator+() (binary_op1). The values in the ranges
- * are processed in order.
- * So, the results are row-wise sums of the cross products.
- *
- * @ingroup mutating_algorithms
- * @param  first1     An input iterator.
- * @param  last1      An input iterator.
- * @param  first2     An input iterator.
- * @param  last2      An input iterator.
- * @param  result     An output iterator.
- * @param  binary_op1 A binary operator.
- * @param  binary_op2 A binary operator.
- * @return Iterator pointing just beyond the values written to result.
+ * With 5 bins, 3 bits are used per value. So the bins {1, 2, 3} become key 1<<6 | 2<<3 | 3.
  */
-template<typename _InputIterator1, typename _InputIterator2,
-	   typename _OutputIterator, typename _BinaryOperation1,
-	   typename _BinaryOperation2>
-  _OutputIterator
-  extensive_product(_InputIterator1 __first1, _InputIterator1 __last1,
-	      _InputIterator2 __first2, _InputIterator2 __last2,
-	      _OutputIterator __result,
-		  _BinaryOperation1 __binary_op1,
-		  _BinaryOperation2 __binary_op2)
-{
-    // concept requirements
-    __glibcxx_function_requires(_InputIteratorConcept<_InputIterator1>)
-    __glibcxx_function_requires(_InputIteratorConcept<_InputIterator2>)
-    __glibcxx_function_requires(_OutputIteratorConcept<_OutputIterator,
-    		__typeof__(__binary_op(*__first1,*__first2))>)
-    __glibcxx_requires_valid_range(__first1, __last1);
-    __glibcxx_requires_valid_range(__first2, __last2);
-
-    for (; __first1 != __last1; ++__first1, ++__result)
-        for (; __first2 != __last2; ++__first2)
-        	*__result = __binary_op1(*__result, __binary_op2(*__first1, *__first2));
-    return __result;
+void RandomVariableConverter::GetKeys(int first, int last, std::vector<uint64_t> & result)
+{
+	size_t N = nof_samples;
+	result.assign(N, 0);
+	for (int c = first; c < last; ++c) {
+		const BIN_TYPE *bin = &column_bins[c * N];
+		for (size_t i = 0; i < N; ++i) {
+			result[i] = (result[i] << bits_per_bin) | bin[i];
+		}
+	}
+}
+
+/**
+ * The finalizer of SplitMix64, a bijection that mixes all bits.
+ */
+static inline uint64_t mix(uint64_t x) {
+	x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+	return x ^ (x >> 31);
+}
+
+/**
+ * Every bin is mixed into the key of the bins before it. All ones is the empty key of the tables,
+ * so that becomes all ones but the last.
+ */
+void RandomVariableConverter::GetHashedKeys(int first, int last, std::vector<uint64_t> & result)
+{
+	size_t N = nof_samples;
+	result.assign(N, 0);
+	for (int c = first; c < last; ++c) {
+		const BIN_TYPE *bin = &column_bins[c * N];
+		for (size_t i = 0; i < N; ++i) {
+			result[i] = mix(result[i] + bin[i] + 1);
+		}
+	}
+	for (size_t i = 0; i < N; ++i) {
+		if (result[i] == COUNTTABLE_EMPTY_KEY) --result[i];
+	}
+}
+
+/**
+ * The number of symbols nof_bins^size, saturated at UINT64_MAX.
+ */
+static uint64_t alphabet_size(int nof_bins, size_t size) {
+	uint64_t alphabet = 1;
+	for (size_t i = 0; i < size; ++i) {
+		if (alphabet > UINT64_MAX / nof_bins) return UINT64_MAX;
+		alphabet *= nof_bins;
+	}
+	return alphabet;
 }
 
 /**
  * We have to calculate somehow random variables from sensor input or motor output. This
- * input can have a continuous range of values and be of a vector format. The sensor input
- * S[t=0]={0.1, 0.2, 0.1}, S[t=1]={0.1, 0.8, 0.1}, S[t=1]={0.1, 0.8, 0.8} will become
- * with two bins the following frequency matrix F={3, 1, 2 : 3, 2, 2 : 3, 2, 1}. This
- * corresponds to P[t=0]={1.0, 0.33, 0.67}, etc. Obviously the elements are here considered
- * independent. There might very well be a better way in which to calculate the probability
- * of an entire sensory input. It is of course possible to assign an aggregated value to an
- * input vector and set this as the observation value.
+ * input can have a continuous range of values and be of a vector format. Each vector is
+ * binned element-wise and the bins together form one symbol, so the elements are not
+ * considered independent. With two bins the sensor inputs S[t=0]={0.1, 0.2, 0.1} and
+ * S[t=1]={0.1, 0.8, 0.1} are the symbols 0 and 2 out of 2^3=8 possible sensor symbols.
+ *
+ * A list-based path is traversed only once, to copy its values into matrices. Several views,
+ * like the blocks of a trace file, are treated as one path. Then every
+ * pair increments three bins: the joint one, the sensor and the motor one. Only afterwards
+ * the counts are normalized into probabilities.
  */
 void RandomVariableConverter::CalculateJointRandomVariables()
 {
-	assert (path != NULL);
-	assert (!path->empty());
-	SensorimotorPath::iterator it;
-//	std::transform(path.begin(), path.end(), path.begin(), sensor.begin(),
-//			get_sensor<PROB_TYPE>);
-	// std::inner_product
-
-//	sensor->clear();
-//	sensor->reserve(path->size());
-//	sensor_bins->clear();
-//	sensor_bins->reserve(nof_bins);
-//	for (int i = 0; i < nof_bins; ++i) {
-//		sensor_bins[i] = 0;
-//	}
-
-	// the number of sensors or the "observation" size
-	/*
-	size_t observation_size = path->front().observation.size();
-
-	// create double vector: sensors_over_time[observation][bin]
-	sensors_over_time->clear();
-	for (int s = 0; s < observation_size; ++s) {
-		sensors_over_time->push_back(new RandomVariable());
-		sensors_over_time[s].clear();
-		for (int i = 0; i < nof_bins; ++i) {
-			sensors_over_time[s].push_back(new RandomVariable());
-		}
+	if (path != NULL) {
+		path_copy.assign(*path);
+		views.assign(1, path_copy.getView());
+	} else if (columnar_path != NULL) {
+		views.assign(1, columnar_path->getView());
 	}
+	assert (!views.empty());
 
-	// quantify the sensory events by the GetBin function
-	for (int s = 0; s < observation_size; ++s) {
-		for (it = path->begin(); it != path->end(); ++it) {
-			int bin = GetBin(((*it).observation)[s]);
-			sensors_over_time->at(s)->at(bin)++;
-		}
-		// make probabilities by frequencies by dividing over path length
-		for (int i = 0; i < nof_bins; ++i) {
-			sensors_over_time->at(s)->at(i) /= (AP_TYPE)path->size();
-		}
+	size_t observation_size = views.front().getObservationSize();
+	size_t action_size = views.front().getActionSize();
+	nof_samples = 0;
+	for (size_t v = 0; v < views.size(); ++v) {
+		assert (views[v].getObservationSize() == (int)observation_size);
+		assert (views[v].getActionSize() == (int)action_size);
+		nof_samples += views[v].size();
 	}
-*/
-	// now calculate for each sensor value its probability
-//	sensor->at()
+	assert (nof_samples > 0);
+	int nof_bins = quantizer.getNofBins();
+	sensor_alphabet = alphabet_size(nof_bins, observation_size);
+	motor_alphabet = alphabet_size(nof_bins, action_size);
+	Quantize(views);
 
+	// in doubles, because this overflows easily
+	double dense_bins = (double)sensor_alphabet * motor_alphabet + sensor_alphabet + motor_alphabet;
+	switch (histogram_mode) {
+	case HM_DENSE:
+		sparse = false;
+		break;
+	case HM_SPARSE:
+		sparse = true;
+		break;
+	default:
+		sparse = (dense_bins > MAX_DENSE_BINS) ||
+			(dense_bins > MIN_DENSE_BINS && dense_bins > 4.0 * nof_samples);
+		break;
+	}
+	if (!sparse && dense_bins > MAX_DENSE_BINS) {
+		cerr << "A dense histogram of " << dense_bins << " bins is too large, the counts are hashed" << endl;
+		sparse = true;
+	}
+
+	hashed = false;
+	if (sparse) {
+		CountSparse(observation_size, action_size);
+	} else {
+		CountDense(observation_size, action_size);
+	}
+
+	Normalize(getSensorCounts(), *sensor);
+	Normalize(getMotorCounts(), *motor);
+	Normalize(getSensorimotorCounts(), *sensorimotor);
 }
 
-void RandomVariableConverter::setNofBins(int nofBins)
+void RandomVariableConverter::CountDense(int observation_size, int action_size)
 {
-	assert (nofBins > 0);
-    nof_bins = nofBins;
-    bin_width = 1.0/(AP_TYPE)nof_bins;
+	joint_size = sensor_alphabet * motor_alphabet;
+	sensor_size = sensor_alphabet;
+	motor_size = motor_alphabet;
+	symbols.clear();
+	bins.assign(joint_size + sensor_size + motor_size, 0);
+	FREQ_TYPE *joint_bins = &bins[0];
+	FREQ_TYPE *sensor_bins = joint_bins + joint_size;
+	FREQ_TYPE *motor_bins = sensor_bins + sensor_size;
+
+	GetSymbols(0, observation_size, sensor_symbols);
+	GetSymbols(observation_size, observation_size + action_size, motor_symbols);
+	for (size_t i = 0; i < (size_t)nof_samples; ++i) {
+		uint64_t s = sensor_symbols[i];
+		uint64_t m = motor_symbols[i];
+		joint_bins[s * motor_alphabet + m]++;
+		sensor_bins[s]++;
+		motor_bins[m]++;
+	}
+}
+
+/**
+ * The joint key is the sensor key followed by the motor key, so all of it should fit in 64 bits
+ * (and not be all ones, that is the empty key of the tables). If it does not, the keys are hashed
+ * and the joint key is a hash of the sensor and motor key.
+ */
+void RandomVariableConverter::CountSparse(int observation_size, int action_size)
+{
+	bits_per_bin = 1;
+	while ((1 << bits_per_bin) < quantizer.getNofBins()) ++bits_per_bin;
+	int motor_bits = action_size * bits_per_bin;
+	hashed = ((observation_size + action_size) * bits_per_bin >= 64);
+
+	if (hashed) {
+		cerr << "The bins of " << observation_size + action_size << " values do not fit in a 64-bit key, "
+				"the keys are hashed" << endl;
+		GetHashedKeys(0, observation_size, sensor_symbols);
+		GetHashedKeys(observation_size, observation_size + action_size, motor_symbols);
+	} else {
+		GetKeys(0, observation_size, sensor_symbols);
+		GetKeys(observation_size, observation_size + action_size, motor_symbols);
+	}
+	joint_table.Clear(nof_samples);
+	sensor_table.Clear();
+	motor_table.Clear();
+	for (size_t i = 0; i < (size_t)nof_samples; ++i) {
+		uint64_t s = sensor_symbols[i];
+		uint64_t m = motor_symbols[i];
+		uint64_t joint = hashed ? mix(s ^ mix(m)) : (s << motor_bits) | m;
+		if (joint == COUNTTABLE_EMPTY_KEY) --joint;
+		joint_table.Increment(joint);
+		sensor_table.Increment(s);
+		motor_table.Increment(m);
+	}
+
+	bins.clear();
+	symbols.clear();
+	joint_table.Export(symbols, bins);
+	sensor_table.Export(symbols, bins);
+	motor_table.Export(symbols, bins);
+	joint_size = joint_table.size();
+	sensor_size = sensor_table.size();
+	motor_size = motor_table.size();
+}
+
+void RandomVariableConverter::Normalize(const Histogram & histogram, Point & probabilities)
+{
+	probabilities.resize(histogram.size);
+	PROB_TYPE scale = (histogram.total) ? PROB_TYPE(1) / histogram.total : PROB_TYPE(0);
+	for (size_t i = 0; i < histogram.size; ++i) {
+		probabilities[i] = histogram.counts[i] * scale;
+	}
+}
+
+bool RandomVariableConverter::setNofBins(int nofBins)
+{
+	return quantizer.setNofBins(nofBins);
 }
 
 Point *RandomVariableConverter::getMotor() const
@@ -186,7 +327,7 @@ Point *RandomVariableConverter::getMotor() const
 
 int RandomVariableConverter::getNofBins() const
 {
-    return nof_bins;
+    return quantizer.getNofBins();
 }
 
 Point *RandomVariableConverter::getSensor() const
@@ -198,3 +339,41 @@ Point *RandomVariableConverter::getSensorimotor() const
 {
     return sensorimotor;
 }
+
+HistogramMode RandomVariableConverter::getHistogramMode() const
+{
+	return histogram_mode;
+}
+
+void RandomVariableConverter::setHistogramMode(HistogramMode mode)
+{
+	histogram_mode = mode;
+}
+
+Histogram RandomVariableConverter::GetHistogram(size_t offset, size_t size, uint64_t alphabet) const
+{
+	Histogram histogram;
+	histogram.counts = bins.empty() ? NULL : &bins[0] + offset;
+	histogram.symbols = symbols.empty() ? NULL : &symbols[0] + offset;
+	histogram.size = size;
+	histogram.alphabet = alphabet;
+	histogram.total = nof_samples;
+	return histogram;
+}
+
+Histogram RandomVariableConverter::getSensorimotorCounts() const
+{
+	uint64_t alphabet = (sensor_alphabet > UINT64_MAX / motor_alphabet) ? UINT64_MAX :
+			sensor_alphabet * motor_alphabet;
+	return GetHistogram(0, joint_size, alphabet);
+}
+
+Histogram RandomVariableConverter::getSensorCounts() const
+{
+	return GetHistogram(joint_size, sensor_size, sensor_alphabet);
+}
+
+Histogram RandomVariableConverter::getMotorCounts() const
+{
+	return GetHistogram(joint_size + sensor_size, motor_size, motor_alphabet);
+}
@@ -0,0 +1,525 @@
+/***************************************************************************************************
+ * @brief Compression of blocks of sensorimotor samples
+ * @file TraceCodec.cpp
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#include <TraceCodec.h>
+
+#include <assert.h>
+#include <math.h>
+#include <string.h>
+#include <queue>
+#include <functional>
+
+//! Bytes after packed bits, so the decoder can always load 8 bytes (and one more)
+#define PACKED_PADDING 9
+
+//! Doubles in this range that are integers are exact as int64_t as well
+#define MAX_EXACT_INTEGER 4503599627370496.0
+
+//! Huffman codes are at most this long, so a code is decoded with one lookup in 2^12 entries
+#define MAX_CODE_LENGTH 12
+
+//! The code lengths of the 256 byte values, two per byte
+#define CODE_LENGTHS_SIZE 128
+
+static inline void put_varint(std::vector<uint8_t> &out, uint64_t value) {
+	while (value >= 0x80) {
+		out.push_back((uint8_t)(value | 0x80));
+		value >>= 7;
+	}
+	out.push_back((uint8_t)value);
+}
+
+static inline size_t varint_size(uint64_t value) {
+	size_t size = 1;
+	while (value >= 0x80) {
+		value >>= 7;
+		++size;
+	}
+	return size;
+}
+
+static inline const uint8_t *get_varint(const uint8_t *data, const uint8_t *end, uint64_t &value) {
+	value = 0;
+	for (int shift = 0; data < end && shift < 64; shift += 7) {
+		uint8_t byte = *data++;
+		value |= (uint64_t)(byte & 0x7f) << shift;
+		if (!(byte & 0x80)) return data;
+	}
+	return NULL;
+}
+
+static inline void put_int64(std::vector<uint8_t> &out, int64_t value) {
+	uint8_t bytes[8];
+	memcpy(bytes, &value, 8);
+	out.insert(out.end(), bytes, bytes + 8);
+}
+
+static inline uint64_t load64(const uint8_t *data) {
+	uint64_t value;
+	memcpy(&value, data, 8);
+	return value;
+}
+
+/**
+ * Huffman code lengths for the byte frequencies. If a code would be longer than MAX_CODE_LENGTH the
+ * frequencies are halved, non-zero ones stay non-zero, and the tree is built again; in the end all
+ * frequencies are 1 and the codes are 8 bits. A single byte value gets a code of one bit.
+ */
+static void code_lengths(const uint64_t *frequencies, uint8_t *lengths) {
+	typedef std::pair<uint64_t, int> Node;
+	std::vector<uint64_t> weights(frequencies, frequencies + 256);
+	std::vector<int> parent(2 * 256);
+	while (true) {
+		std::priority_queue<Node, std::vector<Node>, std::greater<Node> > queue;
+		for (int s = 0; s < 256; ++s) {
+			lengths[s] = 0;
+			if (weights[s]) queue.push(Node(weights[s], s));
+		}
+		if (queue.size() == 1) {
+			lengths[queue.top().second] = 1;
+			return;
+		}
+		std::fill(parent.begin(), parent.end(), -1);
+		for (int next = 256; queue.size() > 1; ++next) {
+			Node a = queue.top();
+			queue.pop();
+			Node b = queue.top();
+			queue.pop();
+			parent[a.second] = parent[b.second] = next;
+			queue.push(Node(a.first + b.first, next));
+		}
+		int max_length = 0;
+		for (int s = 0; s < 256; ++s) {
+			if (!weights[s]) continue;
+			int length = 0;
+			for (int p = s; parent[p] >= 0; p = parent[p]) ++length;
+			lengths[s] = length;
+			max_length = (length > max_length) ? length : max_length;
+		}
+		if (max_length <= MAX_CODE_LENGTH) return;
+		for (int s = 0; s < 256; ++s) {
+			weights[s] = (weights[s] + 1) / 2;
+		}
+	}
+}
+
+/**
+ * Canonical codes, as in deflate: shorter codes first, and in order of the byte values for the same
+ * length. The bits are written from the least significant one, so the codes are reversed.
+ */
+static void canonical_codes(const uint8_t *lengths, uint16_t *codes) {
+	int count[MAX_CODE_LENGTH + 1] = { 0 };
+	for (int s = 0; s < 256; ++s) {
+		count[lengths[s]]++;
+	}
+	count[0] = 0;
+	int next[MAX_CODE_LENGTH + 1];
+	int code = 0;
+	for (int length = 1; length <= MAX_CODE_LENGTH; ++length) {
+		code = (code + count[length - 1]) << 1;
+		next[length] = code;
+	}
+	for (int s = 0; s < 256; ++s) {
+		if (!lengths[s]) continue;
+		int c = next[lengths[s]]++;
+		uint16_t reversed = 0;
+		for (int b = 0; b < lengths[s]; ++b) {
+			reversed |= ((c >> b) & 1) << (lengths[s] - 1 - b);
+		}
+		codes[s] = reversed;
+	}
+}
+
+TraceCodec::TraceCodec(): huffman(false) {
+}
+
+TraceCodec::~TraceCodec() {
+}
+
+/**
+ * A block is: the number of samples, the number of sensor and actuator values, then every sensor
+ * channel, every actuator channel, and the times.
+ */
+void TraceCodec::Encode(const ColumnarView &block, std::vector<uint8_t> &out) {
+	size_t n = block.size();
+	int observation_size = block.getObservationSize();
+	int action_size = block.getActionSize();
+	encodings.clear();
+	put_varint(out, n);
+	put_varint(out, observation_size);
+	put_varint(out, action_size);
+	for (int c = 0; c < observation_size; ++c) {
+		EncodeChannel(block.getObservations() + c, n, observation_size, out);
+	}
+	for (int c = 0; c < action_size; ++c) {
+		EncodeChannel(block.getActions() + c, n, action_size, out);
+	}
+	integers.resize(n);
+	long int previous = 0;
+	for (size_t i = 0; i < n; ++i) {
+		integers[i] = block.time(i) - previous;
+		previous = block.time(i);
+	}
+	EncodeIntegers(integers.data(), n, out);
+}
+
+/**
+ * Integers are only recognized as such if converting them back gives exactly the same double, so
+ * -0.0, NaN and infinities make a channel continuous.
+ */
+void TraceCodec::EncodeChannel(const AP_TYPE *values, size_t n, size_t stride,
+		std::vector<uint8_t> &out) {
+	column.resize(n);
+	integers.resize(n);
+	bool discrete = true;
+	for (size_t i = 0; i < n; ++i) {
+		AP_TYPE v = values[i * stride];
+		column[i] = v;
+		discrete = discrete && (fabs(v) <= MAX_EXACT_INTEGER) && (v == floor(v)) &&
+				!(v == 0 && signbit(v));
+		if (discrete) integers[i] = (int64_t)v;
+	}
+	if (discrete) {
+		EncodeIntegers(integers.data(), n, out);
+	} else {
+		EncodeXor(column.data(), n, out);
+	}
+}
+
+/**
+ * The size of both encodings is calculated beforehand. With packing every value takes the number of
+ * bits of the largest difference with the minimum. A run takes the varint of that difference and the
+ * varint of its length.
+ */
+void TraceCodec::EncodeIntegers(const int64_t *values, size_t n, std::vector<uint8_t> &out) {
+	int64_t min = 0, max = 0;
+	size_t runs_size = 0, nof_runs = 0;
+	if (n) min = max = values[0];
+	for (size_t i = 0; i < n; ++i) {
+		if (values[i] < min) min = values[i];
+		if (values[i] > max) max = values[i];
+	}
+	for (size_t i = 0; i < n; ) {
+		size_t j = i + 1;
+		while (j < n && values[j] == values[i]) ++j;
+		runs_size += varint_size(values[i] - min) + varint_size(j - i);
+		++nof_runs;
+		i = j;
+	}
+	uint64_t range = (uint64_t)max - (uint64_t)min;
+	int bits = 0;
+	while (bits < 64 && (range >> bits)) ++bits;
+	size_t packed_size = (n * bits + 7) / 8 + PACKED_PADDING + 1;
+	runs_size += varint_size(nof_runs);
+
+	out.push_back((runs_size < packed_size) ? CE_RUNS : CE_PACKED);
+	put_int64(out, min);
+	if (runs_size < packed_size) {
+		encodings.push_back(CE_RUNS);
+		put_varint(out, nof_runs);
+		for (size_t i = 0; i < n; ) {
+			size_t j = i + 1;
+			while (j < n && values[j] == values[i]) ++j;
+			put_varint(out, values[i] - min);
+			put_varint(out, j - i);
+			i = j;
+		}
+		return;
+	}
+	encodings.push_back(CE_PACKED);
+	out.push_back((uint8_t)bits);
+	size_t offset = out.size();
+	out.resize(offset + packed_size - 1, 0);
+	uint8_t *packed = &out[offset];
+	for (size_t i = 0, pos = 0; i < n; ++i, pos += bits) {
+		uint64_t v = (uint64_t)values[i] - (uint64_t)min;
+		size_t byte = pos >> 3;
+		int shift = pos & 7;
+		uint64_t word = load64(packed + byte) | (v << shift);
+		memcpy(packed + byte, &word, 8);
+		if (shift + bits > 64) packed[byte + 8] |= (uint8_t)(v >> (64 - shift));
+	}
+}
+
+/**
+ * Per value one control byte with the number of leading (high nibble) and trailing (low nibble) zero
+ * bytes of the xor, then the bytes in between. These bytes are also Huffman coded, behind them, and
+ * the smaller of the two is kept. If that turns out larger than the doubles themselves, the doubles
+ * are stored instead.
+ */
+void TraceCodec::EncodeXor(const AP_TYPE *values, size_t n, std::vector<uint8_t> &out) {
+	size_t start = out.size();
+	out.push_back(CE_XOR);
+	uint64_t previous = 0;
+	for (size_t i = 0; i < n; ++i) {
+		uint64_t bits;
+		memcpy(&bits, &values[i], 8);
+		uint64_t x = bits ^ previous;
+		previous = bits;
+		int leading = x ? __builtin_clzll(x) / 8 : 8;
+		int trailing = x ? __builtin_ctzll(x) / 8 : 0;
+		out.push_back((uint8_t)((leading << 4) | trailing));
+		for (int b = trailing; b < 8 - leading; ++b) {
+			out.push_back((uint8_t)(x >> (8 * b)));
+		}
+	}
+	size_t xor_end = out.size();
+	size_t xor_size = xor_end - start;
+	if (huffman && xor_size > 1) {
+		bytes.assign(out.begin() + start + 1, out.end());
+		EncodeHuffman(bytes.data(), bytes.size(), out);
+	}
+	size_t huffman_size = out.size() - xor_end;
+	if (huffman_size && huffman_size <= (1 - HUFFMAN_MIN_SAVING) * xor_size &&
+			huffman_size <= 1 + 8 * n) {
+		out.erase(out.begin() + start, out.begin() + xor_end);
+		encodings.push_back(CE_HUFFMAN);
+		return;
+	}
+	out.resize(xor_end);
+	if (xor_size <= 1 + 8 * n) {
+		encodings.push_back(CE_XOR);
+		return;
+	}
+	out.resize(start);
+	out.push_back(CE_RAW);
+	const uint8_t *raw = (const uint8_t*)values;
+	out.insert(out.end(), raw, raw + 8 * n);
+	encodings.push_back(CE_RAW);
+}
+
+/**
+ * The number of bytes, their code lengths (a nibble each), the number of bytes of bits, and the
+ * bits. The bits are collected in a 64-bit word and written 32 at a time.
+ */
+void TraceCodec::EncodeHuffman(const uint8_t *bytes, size_t size, std::vector<uint8_t> &out) {
+	uint64_t frequencies[256] = { 0 };
+	for (size_t i = 0; i < size; ++i) {
+		frequencies[bytes[i]]++;
+	}
+	uint8_t lengths[256];
+	uint16_t codes[256];
+	code_lengths(frequencies, lengths);
+	canonical_codes(lengths, codes);
+	uint64_t nof_bits = 0;
+	for (int s = 0; s < 256; ++s) {
+		nof_bits += frequencies[s] * lengths[s];
+	}
+
+	out.push_back(CE_HUFFMAN);
+	put_varint(out, size);
+	for (int s = 0; s < 256; s += 2) {
+		out.push_back((uint8_t)(lengths[s] | (lengths[s + 1] << 4)));
+	}
+	put_varint(out, (nof_bits + 7) / 8);
+	uint64_t word = 0;
+	int fill = 0;
+	for (size_t i = 0; i < size; ++i) {
+		word |= (uint64_t)codes[bytes[i]] << fill;
+		fill += lengths[bytes[i]];
+		if (fill >= 32) {
+			for (int b = 0; b < 4; ++b, word >>= 8) {
+				out.push_back((uint8_t)word);
+			}
+			fill -= 32;
+		}
+	}
+	for (; fill > 0; fill -= 8, word >>= 8) {
+		out.push_back((uint8_t)word);
+	}
+}
+
+bool TraceCodec::Decode(const uint8_t *data, size_t size, ColumnarPath &block) {
+	const uint8_t *end = data + size;
+	uint64_t n, observation_size, action_size;
+	data = get_varint(data, end, n);
+	if (data) data = get_varint(data, end, observation_size);
+	if (data) data = get_varint(data, end, action_size);
+	if (!data || n > UINT32_MAX || observation_size > size || action_size > size) return false;
+	block.setDimensions(observation_size, action_size);
+	block.resize(n);
+	for (uint64_t c = 0; c < observation_size && data; ++c) {
+		data = DecodeChannel(data, end, n, block.getObservations() + c, observation_size);
+	}
+	for (uint64_t c = 0; c < action_size && data; ++c) {
+		data = DecodeChannel(data, end, n, block.getActions() + c, action_size);
+	}
+	integers.resize(n);
+	if (data) data = DecodeIntegers(data, end, n, integers.data());
+	if (!data) return false;
+	long int *times = block.getTimes();
+	long int t = 0;
+	for (size_t i = 0; i < n; ++i) {
+		t += integers[i];
+		times[i] = t;
+	}
+	return true;
+}
+
+const uint8_t *TraceCodec::DecodeChannel(const uint8_t *data, const uint8_t *end, size_t n,
+		AP_TYPE *values, size_t stride) {
+	if (data >= end) return NULL;
+	switch (*data) {
+	case CE_PACKED: case CE_RUNS:
+		integers.resize(n);
+		data = DecodeIntegers(data, end, n, integers.data());
+		if (!data) return NULL;
+		for (size_t i = 0; i < n; ++i) {
+			values[i * stride] = (AP_TYPE)integers[i];
+		}
+		return data;
+	case CE_XOR:
+		return DecodeXor(data + 1, end, n, values, stride);
+	case CE_HUFFMAN: {
+		data = DecodeHuffman(data + 1, end);
+		const uint8_t *bytes_end = bytes.data() + bytes.size();
+		if (!data || DecodeXor(bytes.data(), bytes_end, n, values, stride) != bytes_end) return NULL;
+		return data;
+	}
+	case CE_RAW:
+		++data;
+		if ((size_t)(end - data) < 8 * n) return NULL;
+		for (size_t i = 0; i < n; ++i, data += 8) {
+			memcpy(&values[i * stride], data, 8);
+		}
+		return data;
+	default:
+		return NULL;
+	}
+}
+
+const uint8_t *TraceCodec::DecodeXor(const uint8_t *data, const uint8_t *end, size_t n,
+		AP_TYPE *values, size_t stride) {
+	uint64_t previous = 0;
+	for (size_t i = 0; i < n; ++i) {
+		if (data >= end) return NULL;
+		int leading = *data >> 4;
+		int trailing = *data & 0x0f;
+		++data;
+		if (leading + trailing > 8 || data + (8 - leading - trailing) > end) return NULL;
+		uint64_t x = 0;
+		for (int b = trailing; b < 8 - leading; ++b) {
+			x |= (uint64_t)(*data++) << (8 * b);
+		}
+		previous ^= x;
+		memcpy(&values[i * stride], &previous, 8);
+	}
+	return data;
+}
+
+/**
+ * Every entry of the table is a possible value of the next MAX_CODE_LENGTH bits, so a code of length
+ * l fills 2^(MAX_CODE_LENGTH - l) entries. Code lengths that do not fit in the table are corrupt, and
+ * so are the entries that no code fills.
+ */
+const uint8_t *TraceCodec::DecodeHuffman(const uint8_t *data, const uint8_t *end) {
+	uint64_t size, nof_bytes;
+	data = get_varint(data, end, size);
+	if (!data || end - data < CODE_LENGTHS_SIZE) return NULL;
+	uint8_t lengths[256];
+	uint32_t kraft = 0;
+	for (int s = 0; s < 256; s += 2, ++data) {
+		lengths[s] = *data & 0x0f;
+		lengths[s + 1] = *data >> 4;
+	}
+	for (int s = 0; s < 256; ++s) {
+		if (lengths[s] > MAX_CODE_LENGTH) return NULL;
+		if (lengths[s]) kraft += 1 << (MAX_CODE_LENGTH - lengths[s]);
+	}
+	data = get_varint(data, end, nof_bytes);
+	if (!data || kraft > (1 << MAX_CODE_LENGTH) || nof_bytes > (uint64_t)(end - data) ||
+			size > 8 * nof_bytes) return NULL;
+	uint16_t codes[256];
+	canonical_codes(lengths, codes);
+	decode_table.assign(1 << MAX_CODE_LENGTH, 0);
+	for (int s = 0; s < 256; ++s) {
+		if (!lengths[s]) continue;
+		for (int c = codes[s]; c < (1 << MAX_CODE_LENGTH); c += 1 << lengths[s]) {
+			decode_table[c] = (uint16_t)((s << 4) | lengths[s]);
+		}
+	}
+
+	const uint8_t *stop = data + nof_bytes;
+	bytes.resize(size);
+	uint64_t word = 0;
+	int fill = 0;
+	for (size_t i = 0; i < size; ) {
+		// whole bytes, the bits of a partial byte above them are the same the next time
+		if (stop - data >= 8) {
+			word |= load64(data) << fill;
+			data += (63 - fill) >> 3;
+			fill += ((63 - fill) >> 3) * 8;
+		}
+		while (fill <= 56 && data < stop) {
+			word |= (uint64_t)(*data++) << fill;
+			fill += 8;
+		}
+		// after a refill there are at least 4 codes in the word, except at the end
+		size_t last = (fill >= 4 * MAX_CODE_LENGTH && i + 4 <= size) ? i + 4 : i + 1;
+		for (; i < last; ++i) {
+			uint16_t entry = decode_table[word & ((1 << MAX_CODE_LENGTH) - 1)];
+			int length = entry & 0x0f;
+			if (!length || length > fill) return NULL;
+			bytes[i] = (uint8_t)(entry >> 4);
+			word >>= length;
+			fill -= length;
+		}
+	}
+	return stop;
+}
+
+const uint8_t *TraceCodec::DecodeIntegers(const uint8_t *data, const uint8_t *end, size_t n,
+		int64_t *values) {
+	if (end - data < 9) return NULL;
+	uint8_t encoding = *data++;
+	int64_t min;
+	memcpy(&min, data, 8);
+	data += 8;
+	if (encoding == CE_RUNS) {
+		uint64_t nof_runs, value, length;
+		data = get_varint(data, end, nof_runs);
+		size_t i = 0;
+		for (uint64_t r = 0; r < nof_runs && data; ++r) {
+			data = get_varint(data, end, value);
+			if (data) data = get_varint(data, end, length);
+			if (!data || length > n - i) return NULL;
+			int64_t v = (int64_t)((uint64_t)min + value);
+			for (uint64_t j = 0; j < length; ++j) {
+				values[i++] = v;
+			}
+		}
+		return (i == n) ? data : NULL;
+	}
+	if (encoding != CE_PACKED || data >= end) return NULL;
+	int bits = *data++;
+	size_t packed_size = (n * bits + 7) / 8 + PACKED_PADDING;
+	if (bits > 64 || (size_t)(end - data) < packed_size) return NULL;
+	uint64_t mask = (bits == 64) ? ~(uint64_t)0 : (((uint64_t)1 << bits) - 1);
+	for (size_t i = 0, pos = 0; i < n; ++i, pos += bits) {
+		size_t byte = pos >> 3;
+		int shift = pos & 7;
+		uint64_t v = load64(data + byte) >> shift;
+		if (shift + bits > 64) v |= (uint64_t)data[byte + 8] << (64 - shift);
+		values[i] = (int64_t)((uint64_t)min + (v & mask));
+	}
+	return data + packed_size;
+}
@@ -0,0 +1,244 @@
+/***************************************************************************************************
+ * @brief Binary files with sensorimotor traces, written during a run and memory-mapped for analysis
+ * @file TraceFile.cpp
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#include <TraceFile.h>
+
+#include <iostream>
+#include <assert.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace std;
+
+static const char TRACE_MAGIC[8] = "APTRACE";
+
+static const uint32_t TRACE_BYTE_ORDER = 0x01020304;
+
+// the samples after the header should be aligned for doubles
+static_assert(sizeof(TraceHeader) == 64, "the header of a trace file is 64 bytes");
+
+TraceWriter::TraceWriter() {
+	file = NULL;
+	memset(&header, 0, sizeof(header));
+}
+
+TraceWriter::~TraceWriter() {
+	if (file != NULL) Close();
+}
+
+bool TraceWriter::Open(const std::string &filename, int observation_size, int action_size,
+		size_t block_size, TraceEncoding encoding) {
+	assert (file == NULL);
+	assert (block_size > 0);
+	file = fopen(filename.c_str(), "wb");
+	if (file == NULL) {
+		cerr << "Cannot open trace file " << filename << " for writing" << endl;
+		return false;
+	}
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, TRACE_MAGIC, sizeof(header.magic));
+	header.version = TRACE_VERSION;
+	header.byte_order = TRACE_BYTE_ORDER;
+	header.observation_size = observation_size;
+	header.action_size = action_size;
+	header.value_type = TD_FLOAT64;
+	header.time_type = TD_INT64;
+	header.block_size = block_size;
+	header.nof_samples = 0;
+	header.encoding = encoding;
+	index.clear();
+	offset = sizeof(header);
+	block.setDimensions(observation_size, action_size);
+	block.reserve(block_size);
+	// flushed right away, so a file that is never closed still has a header of 0 samples
+	bool ok = (fwrite(&header, sizeof(header), 1, file) == 1) && (fflush(file) == 0);
+	if (!ok) {
+		cerr << "Writing to trace file " << filename << " failed" << endl;
+	}
+	return ok;
+}
+
+void TraceWriter::Write(const AP_TYPE *observation, const AP_TYPE *action, long int t) {
+	assert (file != NULL);
+	block.push_back(observation, action, t);
+	if (block.size() == header.block_size) Flush();
+}
+
+bool TraceWriter::Flush() {
+	size_t n = block.size();
+	if (!n) return true;
+	if (header.encoding == TE_COMPRESSED) {
+		buffer.clear();
+		codec.Encode(block.getView(), buffer);
+		bool ok = fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size();
+		if (!ok) {
+			cerr << "Writing to trace file failed" << endl;
+		}
+		index.push_back(offset);
+		offset += buffer.size();
+		header.nof_samples += n;
+		block.clear();
+		return ok;
+	}
+	// without observations or actions their matrix is empty, and its data may be NULL
+	size_t nof_observations = n * header.observation_size;
+	size_t nof_actions = n * header.action_size;
+	bool ok = !nof_observations ||
+			fwrite(block.getObservations(), sizeof(AP_TYPE), nof_observations, file) == nof_observations;
+	ok = ok && (!nof_actions || fwrite(block.getActions(), sizeof(AP_TYPE), nof_actions, file) == nof_actions);
+	ok = ok && fwrite(block.getTimes(), sizeof(long int), n, file) == n;
+	if (!ok) {
+		cerr << "Writing to trace file failed" << endl;
+	}
+	header.nof_samples += n;
+	block.clear();
+	return ok;
+}
+
+/**
+ * The number of samples is only written at the end, so a reader never sees a half-written file as
+ * complete.
+ */
+bool TraceWriter::Close() {
+	assert (file != NULL);
+	bool ok = Flush();
+	if (header.encoding == TE_COMPRESSED) {
+		// the end of the last block, and then the index at a multiple of 8 bytes
+		index.push_back(offset);
+		static const uint8_t padding[8] = { 0 };
+		size_t nof_padding = (8 - offset % 8) % 8;
+		ok = ok && (fwrite(padding, 1, nof_padding, file) == nof_padding);
+		header.index_offset = offset + nof_padding;
+		ok = ok && (fwrite(index.data(), sizeof(uint64_t), index.size(), file) == index.size());
+	}
+	ok = ok && (fseek(file, 0, SEEK_SET) == 0);
+	ok = ok && (fwrite(&header, sizeof(header), 1, file) == 1);
+	ok = (fclose(file) == 0) && ok;
+	file = NULL;
+	if (!ok) {
+		cerr << "Closing trace file failed" << endl;
+	}
+	return ok;
+}
+
+TraceReader::TraceReader() {
+	data = NULL;
+	length = 0;
+	header = NULL;
+	index = NULL;
+}
+
+TraceReader::~TraceReader() {
+	Close();
+}
+
+bool TraceReader::Open(const std::string &filename) {
+	Close();
+	int fd = open(filename.c_str(), O_RDONLY);
+	if (fd < 0) {
+		cerr << "Cannot open trace file " << filename << endl;
+		return false;
+	}
+	struct stat st;
+	if (fstat(fd, &st) || (size_t)st.st_size < sizeof(TraceHeader)) {
+		cerr << "Trace file " << filename << " is too small" << endl;
+		close(fd);
+		return false;
+	}
+	length = st.st_size;
+	void *mapping = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (mapping == MAP_FAILED) {
+		cerr << "Cannot map trace file " << filename << endl;
+		length = 0;
+		return false;
+	}
+	data = (char*)mapping;
+	madvise(data, length, MADV_SEQUENTIAL);
+	header = (const TraceHeader*)data;
+
+	if (memcmp(header->magic, TRACE_MAGIC, sizeof(TRACE_MAGIC)) || header->version != TRACE_VERSION ||
+			header->byte_order != TRACE_BYTE_ORDER || header->value_type != TD_FLOAT64 ||
+			header->time_type != TD_INT64 || !header->block_size || header->encoding >= TE_COUNT) {
+		cerr << "File " << filename << " is not a trace file of version " << TRACE_VERSION << endl;
+		Close();
+		return false;
+	}
+
+	if (isCompressed()) {
+		size_t nof_blocks = (header->nof_samples + header->block_size - 1) / header->block_size;
+		if (header->index_offset % sizeof(uint64_t) ||
+				header->index_offset + (nof_blocks + 1) * sizeof(uint64_t) > length) {
+			cerr << "Trace file " << filename << " is truncated" << endl;
+			Close();
+			return false;
+		}
+		index = (const uint64_t*)(data + header->index_offset);
+		blocks.resize(nof_blocks);
+		return true;
+	}
+
+	// the blocks follow each other, only the last one can be shorter
+	size_t row_size = (header->observation_size + header->action_size) * sizeof(AP_TYPE) +
+			sizeof(long int);
+	size_t offset = sizeof(TraceHeader);
+	for (uint64_t first = 0; first < header->nof_samples; first += header->block_size) {
+		size_t n = header->nof_samples - first;
+		if (n > header->block_size) n = header->block_size;
+		if (offset + n * row_size > length) {
+			cerr << "Trace file " << filename << " is truncated" << endl;
+			Close();
+			return false;
+		}
+		const AP_TYPE *observations = (const AP_TYPE*)(data + offset);
+		const AP_TYPE *actions = observations + n * header->observation_size;
+		const long int *times = (const long int*)(actions + n * header->action_size);
+		blocks.push_back(ColumnarView(observations, actions, times, n, header->observation_size,
+				header->action_size));
+		offset += n * row_size;
+	}
+	return true;
+}
+
+void TraceReader::Close() {
+	if (data != NULL) munmap(data, length);
+	data = NULL;
+	length = 0;
+	header = NULL;
+	index = NULL;
+	blocks.clear();
+}
+
+ColumnarView TraceReader::Load(size_t b, ColumnarPath &buffer) {
+	assert (b < blocks.size());
+	if (!isCompressed()) return blocks[b];
+	uint64_t begin = index[b], end = index[b + 1];
+	if (begin > end || end > header->index_offset ||
+			!codec.Decode((const uint8_t*)data + begin, end - begin, buffer)) {
+		cerr << "Block " << b << " of the trace file is corrupt" << endl;
+		return ColumnarView();
+	}
+	return buffer.getView();
+}
@@ -0,0 +1,78 @@
+/***************************************************************************************************
+ * @brief Ring buffer with the most recent observations and actions of a system
+ * @file TraceRecorder.cpp
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#include <TraceRecorder.h>
+
+#include <algorithm>
+#include <assert.h>
+
+TraceRecorder::TraceRecorder(size_t capacity) {
+	observation_size = action_size = -1;
+	setCapacity(capacity);
+}
+
+TraceRecorder::~TraceRecorder() {
+}
+
+void TraceRecorder::setCapacity(size_t capacity) {
+	this->capacity = capacity;
+	observation_size = action_size = -1;
+	Clear();
+}
+
+void TraceRecorder::Clear() {
+	count = 0;
+}
+
+void TraceRecorder::Record(const AP_TYPE *observation, size_t observation_size,
+		const AP_TYPE *action, size_t action_size, long int t) {
+	if (!capacity) return;
+	if (this->observation_size != (int)observation_size || this->action_size != (int)action_size) {
+		assert (!count);
+		this->observation_size = observation_size;
+		this->action_size = action_size;
+		observations.resize(2 * capacity * observation_size);
+		actions.resize(2 * capacity * action_size);
+		times.resize(2 * capacity);
+	}
+	size_t slot = count % capacity;
+	size_t mirror = slot + capacity;
+	std::copy(observation, observation + observation_size, observations.data() + slot * observation_size);
+	std::copy(observation, observation + observation_size, observations.data() + mirror * observation_size);
+	std::copy(action, action + action_size, actions.data() + slot * action_size);
+	std::copy(action, action + action_size, actions.data() + mirror * action_size);
+	times[slot] = times[mirror] = t;
+	++count;
+}
+
+/**
+ * The oldest of the last n samples is in slot (count - n) % capacity. From there on n rows are
+ * contiguous, because the rows beyond the capacity mirror the first ones.
+ */
+ColumnarView TraceRecorder::getView(size_t n) const {
+	assert (n <= size());
+	if (!n) return ColumnarView(NULL, NULL, NULL, 0, observation_size, action_size);
+	size_t first = (count - n) % capacity;
+	return ColumnarView(observations.data() + first * observation_size,
+			actions.data() + first * action_size, times.data() + first, n, observation_size,
+			action_size);
+}
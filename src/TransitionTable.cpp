@@ -0,0 +1,212 @@
+/***************************************************************************************************
+ * @brief A tabular Markov decision process, sampled with alias tables
+ * @file TransitionTable.cpp
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#include <TransitionTable.h>
+
+#include <algorithm>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <assert.h>
+#include <math.h>
+
+using namespace std;
+
+//! Tolerance on the sum of the probabilities of a row
+#define TRANSITION_TOLERANCE 1e-9
+
+TransitionTable::TransitionTable(size_t nof_states, size_t nof_actions) {
+	Resize(nof_states, nof_actions);
+}
+
+void TransitionTable::Resize(size_t nof_states, size_t nof_actions) {
+	this->nof_states = nof_states;
+	this->nof_actions = nof_actions;
+	rows.assign(nof_states * nof_actions + 1, 0);
+	transitions.clear();
+	added_rows.clear();
+	thresholds.clear();
+	aliases.clear();
+	prepared = false;
+}
+
+/**
+ * An outcome outside of the table would be sorted into a row that does not exist by Prepare, so it
+ * is refused here, as is a probability that is negative or NaN.
+ */
+bool TransitionTable::Add(size_t state, size_t action, size_t next, PROB_TYPE probability,
+		AP_TYPE reward) {
+	if (state >= nof_states || action >= nof_actions || next >= nof_states || !(probability >= 0)) {
+		cerr << "Outcome " << state << " : " << action << " : " << next << " with probability "
+				<< probability << " does not fit a table of " << nof_states << " states and "
+				<< nof_actions << " actions" << endl;
+		return false;
+	}
+	if (probability == 0) return true;
+	if (prepared) {
+		// continue adding to the rows as they are
+		added_rows.clear();
+		for (size_t row = 0; row < rows.size() - 1; ++row) {
+			added_rows.insert(added_rows.end(), rows[row + 1] - rows[row], row);
+		}
+		prepared = false;
+	}
+	Transition transition = { (uint32_t)next, probability, reward };
+	transitions.push_back(transition);
+	added_rows.push_back(state * nof_actions + action);
+	return true;
+}
+
+/**
+ * The outcomes are sorted by row with a counting sort, which keeps the order within a row.
+ */
+bool TransitionTable::Prepare() {
+	if (prepared) return true;
+	size_t nof_rows = nof_states * nof_actions;
+	rows.assign(nof_rows + 1, 0);
+	for (size_t k = 0; k < added_rows.size(); ++k) {
+		++rows[added_rows[k] + 1];
+	}
+	for (size_t row = 0; row < nof_rows; ++row) {
+		rows[row + 1] += rows[row];
+	}
+	std::vector<Transition> sorted(transitions.size());
+	std::vector<uint32_t> position(rows.begin(), rows.end() - 1);
+	for (size_t k = 0; k < transitions.size(); ++k) {
+		sorted[position[added_rows[k]]++] = transitions[k];
+	}
+	transitions.swap(sorted);
+	std::sort(added_rows.begin(), added_rows.end());
+
+	for (size_t row = 0; row < nof_rows; ++row) {
+		PROB_TYPE sum = 0;
+		for (uint32_t k = rows[row]; k < rows[row + 1]; ++k) {
+			sum += transitions[k].probability;
+		}
+		if (fabs(sum - 1) > TRANSITION_TOLERANCE) {
+			cerr << "Probabilities of state " << row / nof_actions << " and action "
+					<< row % nof_actions << " sum to " << sum << " instead of 1" << endl;
+			return false;
+		}
+	}
+
+	added_rows.clear();
+	thresholds.resize(transitions.size());
+	aliases.resize(transitions.size());
+	for (size_t row = 0; row < nof_rows; ++row) {
+		BuildAliases(row);
+	}
+	prepared = true;
+	return true;
+}
+
+/**
+ * Vose's method: every outcome gets a slot of size 1/n. The outcomes with a probability below 1/n
+ * are topped up with a part of an outcome above 1/n, which then has less left over for its own
+ * slot. In the end every slot holds at most two outcomes.
+ */
+void TransitionTable::BuildAliases(size_t row) {
+	uint32_t first = rows[row], n = rows[row + 1] - first;
+	std::vector<uint32_t> small, large;
+	for (uint32_t k = first; k < first + n; ++k) {
+		thresholds[k] = transitions[k].probability * n;
+		aliases[k] = k;
+		if (thresholds[k] < 1) small.push_back(k); else large.push_back(k);
+	}
+	while (!small.empty() && !large.empty()) {
+		uint32_t s = small.back(), l = large.back();
+		small.pop_back();
+		aliases[s] = l;
+		thresholds[l] -= 1 - thresholds[s];
+		if (thresholds[l] < 1) {
+			large.pop_back();
+			small.push_back(l);
+		}
+	}
+	// what remains is 1 up to rounding errors
+	for (size_t i = 0; i < small.size(); ++i) thresholds[small[i]] = 1;
+	for (size_t i = 0; i < large.size(); ++i) thresholds[large[i]] = 1;
+}
+
+AP_TYPE TransitionTable::ExpectedReward(size_t state, size_t action) const {
+	AP_TYPE reward = 0;
+	for (const Transition *t = begin(state, action); t != end(state, action); ++t) {
+		reward += t->probability * t->reward;
+	}
+	return reward;
+}
+
+void TransitionTable::Write(std::ostream &os) const {
+	assert (prepared);
+	std::streamsize precision = os.precision(numeric_limits<PROB_TYPE>::max_digits10);
+	os << "states: " << nof_states << endl;
+	os << "actions: " << nof_actions << endl;
+	for (size_t state = 0; state < nof_states; ++state) {
+		for (size_t action = 0; action < nof_actions; ++action) {
+			for (const Transition *t = begin(state, action); t != end(state, action); ++t) {
+				os << "T: " << action << " : " << state << " : " << t->next << " "
+						<< t->probability << " " << t->reward << endl;
+			}
+		}
+	}
+	os.precision(precision);
+}
+
+/**
+ * Empty lines and lines that start with a # are skipped.
+ */
+bool TransitionTable::Read(std::istream &is) {
+	Resize(0, 0);
+	size_t states = 0, actions = 0;
+	std::string line;
+	for (int number = 1; std::getline(is, line); ++number) {
+		if (line.empty() || line[0] == '#') continue;
+		std::string words = line;
+		std::replace(words.begin(), words.end(), ':', ' ');
+		std::istringstream fields(words);
+		std::string key;
+		fields >> key;
+		bool valid = true;
+		if (key == "states") {
+			valid = (bool)(fields >> states) && !nof_states;
+		} else if (key == "actions") {
+			valid = (bool)(fields >> actions) && !nof_states;
+		} else if (key == "T") {
+			if (!nof_states) Resize(states, actions);
+			size_t action, state, next;
+			PROB_TYPE probability;
+			AP_TYPE reward;
+			valid = (bool)(fields >> action >> state >> next >> probability >> reward) &&
+					action < nof_actions && state < nof_states && next < nof_states &&
+					probability >= 0;
+			if (valid) Add(state, action, next, probability, reward);
+		} else {
+			valid = false;
+		}
+		if (!valid) {
+			cerr << "Cannot read line " << number << " of the transition table: " << line << endl;
+			return false;
+		}
+	}
+	if (!nof_states) Resize(states, actions);
+	return Prepare();
+}
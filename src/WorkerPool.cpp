@@ -0,0 +1,213 @@
+/***************************************************************************************************
+ * @brief Persistent pool of worker threads that execute a job over a range of items
+ * @file WorkerPool.cpp
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#include <WorkerPool.h>
+
+#include <assert.h>
+
+WorkerPool::WorkerPool(): generation(0), pending(0) {
+	nof_workers = 1;
+	job = NULL;
+	nof_items = 0;
+	stopping = false;
+}
+
+WorkerPool::~WorkerPool() {
+	Stop();
+}
+
+void WorkerPool::Start(size_t nof_workers) {
+	Stop();
+	stopping = false;
+	this->nof_workers = (nof_workers > 1) ? nof_workers : 1;
+	unsigned long current = generation.load(std::memory_order_relaxed);
+	for (size_t w = 1; w < nof_workers; ++w) {
+		threads.push_back(std::thread(&WorkerPool::Work, this, w, current));
+	}
+}
+
+void WorkerPool::Stop() {
+	if (threads.empty()) return;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+		generation.fetch_add(1, std::memory_order_release);
+	}
+	start_condition.notify_all();
+	for (size_t i = 0; i < threads.size(); ++i) {
+		threads[i].join();
+	}
+	threads.clear();
+	nof_workers = 1;
+}
+
+/**
+ * The generation is incremented under the mutex, so a thread that is about to block cannot miss
+ * it. The same holds for the last thread that decrements the pending count.
+ */
+void WorkerPool::Run(WorkerJob &job, size_t nof_items) {
+	if (threads.empty()) {
+		for (size_t i = 0; i < nof_items; ++i) {
+			job.Execute(i);
+		}
+		return;
+	}
+	this->job = &job;
+	this->nof_items = nof_items;
+	pending.store(threads.size(), std::memory_order_relaxed);
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		generation.fetch_add(1, std::memory_order_release);
+	}
+	start_condition.notify_all();
+
+	Execute(0);
+
+	for (int spin = 0; spin < WORKER_SPIN_COUNT; ++spin) {
+		if (!pending.load(std::memory_order_acquire)) return;
+		std::this_thread::yield();
+	}
+	std::unique_lock<std::mutex> lock(mutex);
+	while (pending.load(std::memory_order_acquire)) {
+		done_condition.wait(lock);
+	}
+}
+
+/**
+ * The generation is not reset when the pool is restarted, an earlier Run or Stop has advanced it.
+ * So the thread starts from the generation passed by Start, not from 0, or it would execute the
+ * last job again.
+ */
+void WorkerPool::Work(size_t worker, unsigned long seen) {
+	while (true) {
+		unsigned long current = generation.load(std::memory_order_acquire);
+		for (int spin = 0; spin < WORKER_SPIN_COUNT && current == seen; ++spin) {
+			std::this_thread::yield();
+			current = generation.load(std::memory_order_acquire);
+		}
+		if (current == seen) {
+			std::unique_lock<std::mutex> lock(mutex);
+			while ((current = generation.load(std::memory_order_acquire)) == seen) {
+				start_condition.wait(lock);
+			}
+		}
+		seen = current;
+		if (stopping) return;
+		Execute(worker);
+		if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+			std::lock_guard<std::mutex> lock(mutex);
+			done_condition.notify_one();
+		}
+	}
+}
+
+void WorkerPool::Execute(size_t worker) {
+	size_t nof_workers = getNofWorkers();
+	for (size_t i = worker; i < nof_items; i += nof_workers) {
+		job->Execute(i);
+	}
+}
+
+WorkerThread::WorkerThread(): posted(0), finished(0), thread_sleeping(false),
+		caller_sleeping(false) {
+	job = NULL;
+	item = 0;
+	stopping = false;
+}
+
+WorkerThread::~WorkerThread() {
+	Stop();
+}
+
+void WorkerThread::Start() {
+	if (isRunning()) return;
+	stopping = false;
+	posted.store(0);
+	finished.store(0);
+	thread = std::thread(&WorkerThread::Work, this);
+}
+
+void WorkerThread::Stop() {
+	if (!isRunning()) return;
+	Wait();
+	stopping = true;
+	Publish(posted, posted.load() + 1, thread_sleeping, mutex, posted_condition);
+	thread.join();
+}
+
+void WorkerThread::Post(WorkerJob &job, size_t i) {
+	assert (isRunning());
+	assert (finished.load(std::memory_order_acquire) == posted.load(std::memory_order_relaxed));
+	this->job = &job;
+	item = i;
+	Publish(posted, posted.load(std::memory_order_relaxed) + 1, thread_sleeping, mutex,
+			posted_condition);
+}
+
+void WorkerThread::Wait() {
+	unsigned long target = posted.load(std::memory_order_relaxed);
+	unsigned long done = finished.load(std::memory_order_acquire);
+	while (done != target) {
+		done = Await(finished, done, caller_sleeping, mutex, finished_condition);
+	}
+}
+
+void WorkerThread::Work() {
+	unsigned long seen = 0;
+	while (true) {
+		seen = Await(posted, seen, thread_sleeping, mutex, posted_condition);
+		if (stopping) return;
+		job->Execute(item);
+		Publish(finished, seen, caller_sleeping, mutex, finished_condition);
+	}
+}
+
+/**
+ * The sleeping flag and the value are both sequentially consistent: either the publisher sees the
+ * flag and notifies (under the mutex, so not before the waiter waits), or the waiter sees the new
+ * value when it checks again after setting the flag.
+ */
+unsigned long WorkerThread::Await(std::atomic<unsigned long> &value, unsigned long seen,
+		std::atomic<bool> &sleeping, std::mutex &mutex, std::condition_variable &condition) {
+	unsigned long current = value.load(std::memory_order_acquire);
+	for (int spin = 0; spin < WORKER_SPIN_COUNT && current == seen; ++spin) {
+		std::this_thread::yield();
+		current = value.load(std::memory_order_acquire);
+	}
+	if (current != seen) return current;
+	std::unique_lock<std::mutex> lock(mutex);
+	sleeping.store(true);
+	while ((current = value.load()) == seen) {
+		condition.wait(lock);
+	}
+	sleeping.store(false);
+	return current;
+}
+
+void WorkerThread::Publish(std::atomic<unsigned long> &value, unsigned long update,
+		std::atomic<bool> &sleeping, std::mutex &mutex, std::condition_variable &condition) {
+	value.store(update);
+	if (sleeping.load()) {
+		std::lock_guard<std::mutex> lock(mutex);
+		condition.notify_all();
+	}
+}
@@ -0,0 +1,280 @@
+/***************************************************************************************************
+ * @brief Checks that a steady-state tick does not allocate
+ * @file TestAllocation.cpp
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#include <TestAllocation.h>
+#include <Embodiment.h>
+#include <Information.h>
+
+#include <iostream>
+#include <new>
+#include <stdlib.h>
+
+using namespace std;
+
+//! Number of calls to operator new, in this program
+static long int allocations = 0;
+
+void *operator new(size_t size) {
+	++allocations;
+	void *p = malloc(size ? size : 1);
+	if (p == NULL) throw std::bad_alloc();
+	return p;
+}
+
+void operator delete(void *p) noexcept {
+	free(p);
+}
+
+void operator delete(void *p, size_t) noexcept {
+	free(p);
+}
+
+//! Number of ticks before counting, and while counting
+#define WARM_UP_TICKS 100
+#define COUNTED_TICKS 10000
+
+void CenteringSystem::FixedTick(const FixedObservation &observation, FixedAction &action) {
+	AP_TYPE middle = (observation[1] + observation[2]) / 2;
+	action[0] = (middle - observation[0]) / 2;
+	action[1] = observation[0];
+}
+
+void CorridorEnvironment::FixedInit(std::vector<FixedObservation> &observations,
+		std::vector<FixedState> &states) {
+	for (size_t i = 0; i < states.size(); ++i) {
+		states[i][0] = i;
+		states[i][1] = 0;
+		observations[i][0] = states[i][0];
+		observations[i][1] = -1;
+		observations[i][2] = 1;
+	}
+}
+
+void CorridorEnvironment::FixedTick(const std::vector<FixedAction> &actions,
+		std::vector<FixedObservation> &observations, std::vector<FixedState> &states) {
+	for (size_t i = 0; i < states.size(); ++i) {
+		states[i][0] += actions[i][0];
+		states[i][1] += 1;
+		// the walls move a bit, so the estimators see more than one symbol
+		observations[i][0] = states[i][0];
+		observations[i][1] = -1 + ((long int)states[i][1] % 3) * 0.25;
+		observations[i][2] = 1;
+	}
+}
+
+void EchoSystem::DiscreteTick(const SymbolObservation &observation, AP_TYPE reward,
+		SymbolAction &action) {
+	action[0] = observation[0];
+}
+
+void CounterEnvironment::DiscreteInit(std::vector<SymbolObservation> &observations,
+		std::vector<SymbolState> &states) {
+	for (size_t i = 0; i < states.size(); ++i) {
+		states[i][0] = 0;
+		observations[i][0] = 0;
+	}
+}
+
+void CounterEnvironment::DiscreteTick(const std::vector<SymbolAction> &actions,
+		std::vector<SymbolObservation> &observations, std::vector<SymbolState> &states) {
+	instantaneous_reward = 0;
+	for (size_t i = 0; i < states.size(); ++i) {
+		instantaneous_reward += (actions[i][0] == states[i][0]);
+		states[i][0] = (states[i][0] + 1) % 4;
+		observations[i][0] = states[i][0];
+	}
+	accumulated_reward += instantaneous_reward;
+}
+
+void CounterBatch::Init(size_t nof_instances, std::vector<Batch<SYMBOL8_TYPE> > &observations) {
+	times.assign(nof_instances, 0);
+	for (size_t i = 0; i < observations.size(); ++i) {
+		for (size_t m = 0; m < nof_instances; ++m) {
+			observations[i](m, 0) = 0;
+		}
+	}
+}
+
+void CounterBatch::Tick(const std::vector<Batch<SYMBOL8_TYPE> > &actions,
+		std::vector<Batch<SYMBOL8_TYPE> > &observations, Batch<AP_TYPE> &rewards, uint8_t *done) {
+	for (size_t m = 0; m < times.size(); ++m) {
+		times[m] = (times[m] + 1) % 10;
+		done[m] = !times[m];
+		for (size_t i = 0; i < actions.size(); ++i) {
+			rewards(m, i) = (actions[i](m, 0) == observations[i](m, 0));
+			observations[i](m, 0) = times[m] % 4;
+		}
+	}
+}
+
+void EchoBatch::Tick(const Batch<SYMBOL8_TYPE> &observations, const AP_TYPE *rewards,
+		const uint8_t *done, Batch<SYMBOL8_TYPE> &actions) {
+	for (size_t m = 0; m < observations.size(); ++m) {
+		actions(m, 0) = observations(m, 0);
+	}
+}
+
+int TestAllocation::Test() {
+	int failures = 0;
+	failures += Fixed();
+	failures += Discrete();
+	failures += Parallel();
+	failures += Pipelined();
+	failures += Batched();
+	return failures;
+}
+
+int TestAllocation::Check(const char *name, long int allocations) {
+	cout << name << ": " << allocations << " allocations in " << COUNTED_TICKS << " ticks" << endl;
+	return (allocations != 0);
+}
+
+int TestAllocation::Fixed() {
+	std::vector<CenteringSystem> robots(3);
+	AP_SYSTEMS systems;
+	for (size_t i = 0; i < robots.size(); ++i) {
+		systems.push_back(&robots[i]);
+	}
+	CorridorEnvironment env;
+	Embodiment embodiment;
+	Coupling coupling;
+	embodiment.SetRecording(64);
+	embodiment.Couple(env, systems, coupling);
+	Information information;
+	information.setNofBins(8);
+	information.setRange(-2, 2);
+	for (int t = 0; t < WARM_UP_TICKS; ++t) {
+		embodiment.Tick();
+		information.Add(embodiment.GetObservation(0), embodiment.GetAction(0));
+		information.Calculate();
+	}
+	long int before = allocations;
+	for (int t = 0; t < COUNTED_TICKS; ++t) {
+		embodiment.Tick();
+		information.Add(embodiment.GetObservation(0), embodiment.GetAction(0));
+		information.Calculate();
+	}
+	return Check("Fixed systems, recorded and estimated", allocations - before);
+}
+
+int TestAllocation::Discrete() {
+	int failures = 0;
+	std::vector<EchoSystem> echoes(4);
+	AP_SYSTEMS systems;
+	std::vector<EchoSystem*> pointers;
+	for (size_t i = 0; i < echoes.size(); ++i) {
+		systems.push_back(&echoes[i]);
+		pointers.push_back(&echoes[i]);
+	}
+	CounterEnvironment env;
+	Embodiment embodiment;
+	Coupling coupling;
+	embodiment.Couple(env, systems, coupling);
+	for (int t = 0; t < WARM_UP_TICKS; ++t) {
+		embodiment.Tick();
+	}
+	long int before = allocations;
+	for (int t = 0; t < COUNTED_TICKS; ++t) {
+		embodiment.Tick();
+	}
+	failures += Check("Discrete systems", allocations - before);
+
+	env.Restart();
+	env.Start(pointers.size());
+	for (int t = 0; t < WARM_UP_TICKS; ++t) {
+		env.Step(pointers);
+	}
+	before = allocations;
+	for (int t = 0; t < COUNTED_TICKS; ++t) {
+		env.Step(pointers);
+	}
+	failures += Check("Discrete systems, stepped on the environment", allocations - before);
+	return failures;
+}
+
+int TestAllocation::Parallel() {
+	std::vector<CenteringSystem> robots(8);
+	AP_SYSTEMS systems;
+	for (size_t i = 0; i < robots.size(); ++i) {
+		systems.push_back(&robots[i]);
+	}
+	CorridorEnvironment env;
+	Embodiment embodiment;
+	Coupling coupling;
+	embodiment.Couple(env, systems, coupling);
+	embodiment.SetThreads(2);
+	for (int t = 0; t < WARM_UP_TICKS; ++t) {
+		embodiment.Tick();
+	}
+	long int before = allocations;
+	for (int t = 0; t < COUNTED_TICKS; ++t) {
+		embodiment.Tick();
+	}
+	return Check("Systems on a worker pool", allocations - before);
+}
+
+int TestAllocation::Pipelined() {
+	std::vector<CenteringSystem> robots(3);
+	AP_SYSTEMS systems;
+	for (size_t i = 0; i < robots.size(); ++i) {
+		systems.push_back(&robots[i]);
+	}
+	CorridorEnvironment env;
+	Embodiment embodiment;
+	Coupling coupling;
+	embodiment.Couple(env, systems, coupling);
+	embodiment.SetPipelined(true);
+	embodiment.Restart();
+	for (int t = 0; t < WARM_UP_TICKS; ++t) {
+		embodiment.Tick();
+	}
+	long int before = allocations;
+	for (int t = 0; t < COUNTED_TICKS; ++t) {
+		embodiment.Tick();
+	}
+	return Check("Environment on a thread of its own", allocations - before);
+}
+
+int TestAllocation::Batched() {
+	CounterBatch env;
+	EchoBatch echo0, echo1;
+	std::vector<BatchSystem<SYMBOL8_TYPE>*> systems;
+	systems.push_back(&echo0);
+	systems.push_back(&echo1);
+	BatchEmbodiment<SYMBOL8_TYPE> embodiment;
+	embodiment.Couple(env, systems, 256);
+	for (int t = 0; t < WARM_UP_TICKS; ++t) {
+		embodiment.Tick();
+	}
+	long int before = allocations;
+	for (int t = 0; t < COUNTED_TICKS; ++t) {
+		embodiment.Tick();
+	}
+	return Check("Batch of instances", allocations - before);
+}
+
+int main() {
+	TestAllocation test;
+	int failures = test.Test();
+	cout << (failures ? "FAILED" : "OK") << endl;
+	return failures;
+}
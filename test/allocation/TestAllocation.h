@@ -0,0 +1,130 @@
+/***************************************************************************************************
+ * @brief Checks that a steady-state tick does not allocate
+ * @file TestAllocation.h
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#ifndef TESTALLOCATION_H_
+#define TESTALLOCATION_H_
+
+#include <System.h>
+#include <Environment.h>
+#include <BatchEmbodiment.h>
+
+/**
+ * A system that moves towards the middle of its observations.
+ */
+class CenteringSystem: public FixedSystem<CenteringSystem, 3, 2> {
+public:
+	void FixedTick(const FixedObservation &observation, FixedAction &action);
+
+	void Restart() {}
+};
+
+/**
+ * Every system has a position, the observations are the position and two walls around it.
+ */
+class CorridorEnvironment: public FixedEnvironment<CorridorEnvironment, 3, 2, 2> {
+public:
+	void FixedInit(std::vector<FixedObservation> &observations, std::vector<FixedState> &states);
+
+	void FixedTick(const std::vector<FixedAction> &actions, std::vector<FixedObservation> &observations,
+			std::vector<FixedState> &states);
+
+	void Restart() { Clear(); }
+};
+
+/**
+ * A system that repeats the symbol it observes.
+ */
+class EchoSystem: public DiscreteSystem<EchoSystem, SYMBOL8_TYPE, 1, 1> {
+public:
+	void DiscreteTick(const SymbolObservation &observation, AP_TYPE reward, SymbolAction &action);
+
+	void Restart() {}
+};
+
+/**
+ * Counts up modulo 4, the reward is 1 if a system echoed the previous count.
+ */
+class CounterEnvironment: public DiscreteEnvironment<CounterEnvironment, SYMBOL8_TYPE, 1, 1, 1> {
+public:
+	void DiscreteInit(std::vector<SymbolObservation> &observations, std::vector<SymbolState> &states);
+
+	void DiscreteTick(const std::vector<SymbolAction> &actions,
+			std::vector<SymbolObservation> &observations, std::vector<SymbolState> &states);
+
+	void Restart() { Clear(); }
+};
+
+/**
+ * The same counter, for a batch of instances, an episode lasts 10 ticks.
+ */
+class CounterBatch: public BatchEnvironment<SYMBOL8_TYPE> {
+public:
+	size_t getObservationSize() const { return 1; }
+
+	size_t getActionSize() const { return 1; }
+
+	void Init(size_t nof_instances, std::vector<Batch<SYMBOL8_TYPE> > &observations);
+
+	void Tick(const std::vector<Batch<SYMBOL8_TYPE> > &actions,
+			std::vector<Batch<SYMBOL8_TYPE> > &observations, Batch<AP_TYPE> &rewards, uint8_t *done);
+private:
+	std::vector<int> times;
+};
+
+class EchoBatch: public BatchSystem<SYMBOL8_TYPE> {
+public:
+	void Tick(const Batch<SYMBOL8_TYPE> &observations, const AP_TYPE *rewards, const uint8_t *done,
+			Batch<SYMBOL8_TYPE> &actions);
+
+	void Restart(size_t nof_instances) {}
+};
+
+/**
+ * Counts the allocations (through operator new) during ticks of the embodiment, after a few ticks
+ * to warm up. In steady state there should be none: the buffers are sized at coupling, the trace
+ * recorders at the first tick, and the histograms of the estimators only grow for new symbols.
+ */
+class TestAllocation {
+public:
+	//! Returns the number of failed checks
+	int Test();
+protected:
+	//! Fixed-size observations and actions, with recording and estimators
+	int Fixed();
+
+	//! Symbols and a separate reward, also ticked directly on the environment
+	int Discrete();
+
+	//! The systems ticked on a worker pool
+	int Parallel();
+
+	//! The environment stepped on its own thread
+	int Pipelined();
+
+	//! A batch of instances, with episodes that end
+	int Batched();
+
+	//! Compare the number of allocations with 0
+	int Check(const char *name, long int allocations);
+};
+
+#endif /* TESTALLOCATION_H_ */
@@ -0,0 +1,181 @@
+/***************************************************************************************************
+ * @brief Latency, bandwidth and ordering of the message channels between systems
+ * @file TestChannel.cpp
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#include <TestChannel.h>
+#include <Embodiment.h>
+
+#include <iostream>
+#include <stdlib.h>
+#include <math.h>
+
+using namespace std;
+
+//! Number of systems in the ring
+#define NOF_FLOCKING_SYSTEMS 8
+
+void FlockingSystem::FixedTick(const FixedObservation &observation, FixedAction &action) {
+	outbox->Send(observation[0]);
+	AP_TYPE position;
+	while (inbox->Receive(position)) {
+		target = position;
+		known = true;
+	}
+	action[0] = known ? 0.1 * (target - observation[0]) : 0;
+}
+
+void LineEnvironment::FixedInit(std::vector<FixedObservation> &observations,
+		std::vector<FixedState> &states) {
+	for (size_t i = 0; i < states.size(); ++i) {
+		states[i][0] = (i * 7) % states.size();
+		observations[i][0] = states[i][0];
+	}
+}
+
+void LineEnvironment::FixedTick(const std::vector<FixedAction> &actions,
+		std::vector<FixedObservation> &observations, std::vector<FixedState> &states) {
+	AP_TYPE mean = 0;
+	for (size_t i = 0; i < actions.size(); ++i) {
+		states[i][0] += actions[i][0];
+		observations[i][0] = states[i][0];
+		mean += states[i][0];
+	}
+	mean /= states.size();
+	instantaneous_reward = 0;
+	for (size_t i = 0; i < states.size(); ++i) {
+		instantaneous_reward -= fabs(states[i][0] - mean);
+	}
+	discounted_reward = instantaneous_reward + 0.9 * discounted_reward;
+}
+
+int TestChannel::Test() {
+	int failures = 0;
+	failures += Latency();
+	failures += Bandwidth();
+	failures += Flocking();
+	return failures;
+}
+
+int TestChannel::Latency() {
+	int failures = 0;
+	Coupling coupling;
+	MessageChannel<int> &channel = coupling.Connect<int>(0, 1, 4, 3);
+	channel.Send(7);
+	int message = 0;
+	for (long int t = 0; t < 3; ++t) {
+		coupling.setTick(t);
+		failures += channel.Receive(message);
+	}
+	coupling.setTick(3);
+	failures += !channel.Receive(message) + (message != 7);
+	failures += channel.Receive(message);
+
+	// A message sent during a tick is never received during the same one
+	MessageChannel<int> &direct = coupling.Connect<int>(1, 0, 4, 0);
+	failures += (direct.getLatency() != 1);
+	direct.Send(8);
+	failures += direct.Receive(message);
+	coupling.setTick(4);
+	failures += !direct.Receive(message) + (message != 8);
+	return failures;
+}
+
+/**
+ * Three messages are sent every tick, two can be received. The backlog grows by one per tick till
+ * the eight slots are full.
+ */
+int TestChannel::Bandwidth() {
+	int failures = 0;
+	Coupling coupling;
+	MessageChannel<int> &channel = coupling.Connect<int>(0, 1, 8, 1, 2);
+	int sent = 0, received = 0, last = -1;
+	for (long int t = 0; t < 20; ++t) {
+		coupling.setTick(t);
+		int message, count = 0;
+		while (channel.Receive(message)) {
+			failures += (message <= last);
+			last = message;
+			++count;
+		}
+		failures += (count > 2) + (t > 0 && count != 2);
+		received += count;
+		for (int i = 0; i < 3; ++i) {
+			channel.Send(sent++);
+		}
+	}
+	failures += (received + channel.size() + channel.getNofDropped() != (size_t)sent);
+	failures += (channel.size() != channel.getCapacity()) + !channel.getNofDropped();
+	coupling.Clear();
+	failures += (channel.size() != 0);
+	return failures;
+}
+
+AP_TYPE TestChannel::Flock(size_t nof_threads, long int nof_ticks) {
+	std::vector<FlockingSystem> flock(NOF_FLOCKING_SYSTEMS);
+	AP_SYSTEMS systems;
+	Coupling coupling;
+	for (size_t i = 0; i < flock.size(); ++i) {
+		systems.push_back(&flock[i]);
+		size_t next = (i + 1) % flock.size();
+		MessageChannel<AP_TYPE> &channel = coupling.Connect<AP_TYPE>(i, next, 16, 1 + i % 3, 1);
+		flock[i].setOutbox(&channel);
+		flock[next].setInbox(&channel);
+	}
+	LineEnvironment env;
+	Embodiment embodiment;
+	embodiment.Couple(env, systems, coupling);
+	embodiment.SetThreads(nof_threads);
+	embodiment.Restart();
+	for (long int t = 0; t < nof_ticks; ++t) {
+		embodiment.Tick();
+	}
+	return env.GetDiscountedReward();
+}
+
+/**
+ * With a latency of at least one tick the order in which the systems are ticked does not matter,
+ * so the result on the worker pool should be exactly the serial one. The flock should also have
+ * converged by then.
+ */
+int TestChannel::Flocking() {
+	int failures = 0;
+	AP_TYPE serial = Flock(1, 10000);
+	for (size_t n = 2; n <= 4; ++n) {
+		AP_TYPE parallel = Flock(n, 10000);
+		if (parallel != serial) {
+			cerr << "Flock on " << n << " threads gets " << parallel << " instead of " << serial << endl;
+			++failures;
+		}
+	}
+	failures += !(fabs(serial) < 1e-6);
+	return failures;
+}
+
+int main() {
+	TestChannel tc;
+	int failures = tc.Test();
+	if (failures) {
+		cout << "There are " << failures << " failures" << endl;
+		return EXIT_FAILURE;
+	}
+	cout << "All channel checks passed" << endl;
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,91 @@
+/***************************************************************************************************
+ * @brief Latency, bandwidth and ordering of the message channels between systems
+ * @file TestChannel.h
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#ifndef TESTCHANNEL_H_
+#define TESTCHANNEL_H_
+
+#include <System.h>
+#include <Environment.h>
+#include <Coupling.h>
+
+/**
+ * A system that tells the next system in a ring where it is, and moves towards where the previous
+ * one was, as far as it knows.
+ */
+class FlockingSystem: public FixedSystem<FlockingSystem, 1, 1> {
+public:
+	FlockingSystem(): inbox(NULL), outbox(NULL) { Restart(); }
+
+	void FixedTick(const FixedObservation &observation, FixedAction &action);
+
+	void Restart() { target = 0; known = false; }
+
+	inline void setInbox(MessageChannel<AP_TYPE> *inbox) { this->inbox = inbox; }
+
+	inline void setOutbox(MessageChannel<AP_TYPE> *outbox) { this->outbox = outbox; }
+private:
+	MessageChannel<AP_TYPE> *inbox, *outbox;
+
+	//! Last position received
+	AP_TYPE target;
+
+	bool known;
+};
+
+/**
+ * Every system is at a position on a line, and moves with its action. The reward is minus the
+ * spread of the positions.
+ */
+class LineEnvironment: public FixedEnvironment<LineEnvironment, 1, 1, 1> {
+public:
+	void FixedInit(std::vector<FixedObservation> &observations, std::vector<FixedState> &states);
+
+	void FixedTick(const std::vector<FixedAction> &actions, std::vector<FixedObservation> &observations,
+			std::vector<FixedState> &states);
+
+	void Restart() { Clear(); }
+};
+
+/**
+ * Checks that messages arrive in order, not before their latency has passed, not more than the
+ * bandwidth per tick, and that systems that exchange messages get the same result on any number
+ * of threads.
+ */
+class TestChannel {
+public:
+	//! Returns the number of failed checks
+	int Test();
+protected:
+	//! Messages are due after the latency, which is at least one tick
+	int Latency();
+
+	//! At most the bandwidth per tick is received, the rest is delayed and at last dropped
+	int Bandwidth();
+
+	//! A ring of flocking systems ticked in order and on a worker pool
+	int Flocking();
+
+	//! Discounted reward of a ring of flocking systems
+	AP_TYPE Flock(size_t nof_threads, long int nof_ticks);
+};
+
+#endif /* TESTCHANNEL_H_ */
@@ -0,0 +1,137 @@
+/***************************************************************************************************
+ * @brief Encodes blocks of samples with every channel encoding and decodes them again
+ * @file TestCodec.cpp
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#include <TestCodec.h>
+#include <stdlib.h>
+#include <string.h>
+#include <iostream>
+#include <math.h>
+
+#include <boost/random.hpp>
+
+using namespace std;
+using namespace boost;
+
+int TestCodec::Test() {
+	int failures = 0;
+	failures += Encodings(false);
+	failures += Encodings(true);
+	return failures;
+}
+
+/**
+ * Channel by channel: a small integer, an integer that is constant for long runs, a smooth sine, a
+ * sine read by a 12-bit converter, random bits, and doubles that are no integers although they look
+ * like it. The times mostly go up by one.
+ */
+void TestCodec::Generate(int observation_size, int action_size, size_t nof_samples,
+		ColumnarPath &path) {
+	boost::random::mt19937_64 rng(17);
+	path.setDimensions(observation_size, action_size);
+	std::vector<AP_TYPE> values(observation_size + action_size);
+	long int t = 0;
+	for (size_t i = 0; i < nof_samples; ++i) {
+		for (size_t c = 0; c < values.size(); ++c) {
+			switch (c % 6) {
+			case 0: values[c] = (i * 7 + c) % 5; break;
+			case 1: values[c] = (AP_TYPE)(i / 300) - 2; break;
+			case 2: values[c] = sin(i * 0.001 + c); break;
+			case 3: values[c] = round((sin(i * 0.01) + 1) * 2047) / 4095.0; break;
+			case 4: {
+				uint64_t bits = rng();
+				memcpy(&values[c], &bits, sizeof(bits));
+				break;
+			}
+			default: {
+				AP_TYPE special[] = { -0.0, NAN, INFINITY, 1e300, 0.5 };
+				values[c] = special[i % 5];
+			}
+			}
+		}
+		t += (i % 97) ? 1 : 3;
+		path.push_back(values.data(), values.data() + observation_size, t);
+	}
+}
+
+bool TestCodec::Equal(const ColumnarView &a, const ColumnarView &b) {
+	if (a.size() != b.size() || a.getObservationSize() != b.getObservationSize() ||
+			a.getActionSize() != b.getActionSize()) return false;
+	size_t n = a.size();
+	return !memcmp(a.getObservations(), b.getObservations(), n * a.getObservationSize() * sizeof(AP_TYPE)) &&
+			!memcmp(a.getActions(), b.getActions(), n * a.getActionSize() * sizeof(AP_TYPE)) &&
+			!memcmp(a.getTimes(), b.getTimes(), n * sizeof(long int));
+}
+
+/**
+ * Without Huffman coding no channel should be Huffman coded. With it, in a short block the code
+ * lengths of a Huffman code cost more than they save, so the smooth channels are xor-ed only. A
+ * prefix of a block misses data, so it should not decode.
+ */
+int TestCodec::Encodings(bool huffman) {
+	int failures = 0;
+	std::vector<int> used(CE_COUNT, 0);
+	size_t sizes[] = { 3000, 20 };
+	for (int s = 0; s < 2; ++s) {
+		ColumnarPath path;
+		Generate(6, 6, sizes[s], path);
+		TraceCodec codec;
+		codec.setHuffman(huffman);
+		std::vector<uint8_t> encoded;
+		codec.Encode(path.getView(), encoded);
+		for (size_t c = 0; c < codec.getEncodings().size(); ++c) {
+			used[codec.getEncodings()[c]]++;
+		}
+		ColumnarPath decoded;
+		failures += !codec.Decode(encoded.data(), encoded.size(), decoded);
+		failures += !Equal(decoded.getView(), path.getView());
+
+		// of a long block about a thousand prefixes, and all that miss only a few bytes
+		int prefixes = 0;
+		size_t step = encoded.size() / 1000 + 1;
+		for (size_t size = 0; size < encoded.size(); size += (size + 64 < encoded.size()) ? step : 1) {
+			std::vector<uint8_t> prefix(encoded.begin(), encoded.begin() + size);
+			prefixes += codec.Decode(prefix.data(), prefix.size(), decoded);
+		}
+		cout << "Block of " << path.size() * (12 * sizeof(AP_TYPE) + sizeof(long int))
+				<< " bytes encoded in " << encoded.size() << " bytes, " << prefixes
+				<< " prefixes decode" << endl;
+		failures += prefixes;
+	}
+	cout << "Channels per encoding, Huffman " << (huffman ? "on" : "off") << ":";
+	for (int e = 0; e < CE_COUNT; ++e) {
+		cout << " " << used[e];
+		failures += (e == CE_HUFFMAN && !huffman) ? (used[e] != 0) : !used[e];
+	}
+	cout << endl;
+	return failures;
+}
+
+int main() {
+	TestCodec tc;
+	int failures = tc.Test();
+	if (failures) {
+		cout << "There are " << failures << " failures" << endl;
+		return EXIT_FAILURE;
+	}
+	cout << "All codec checks passed" << endl;
+	return EXIT_SUCCESS;
+}
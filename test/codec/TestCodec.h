@@ -0,0 +1,49 @@
+/***************************************************************************************************
+ * @brief Encodes blocks of samples with every channel encoding and decodes them again
+ * @file TestCodec.h
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#ifndef TESTCODEC_H_
+#define TESTCODEC_H_
+
+#include <TraceCodec.h>
+#include <ColumnarPath.h>
+
+/**
+ * Encodes blocks of samples channel by channel and decodes them again, every value should come back
+ * bit for bit. Every channel encoding is needed by some channel, Huffman coding only if it is
+ * switched on, and a block that is cut short should not decode.
+ */
+class TestCodec {
+public:
+	//! Returns the number of failed checks
+	int Test();
+protected:
+	//! Every channel encoding, and every prefix of an encoded block, with or without Huffman coding
+	int Encodings(bool huffman);
+
+	//! Values that need all channel encodings: integers, runs, smooth, noisy and special doubles
+	void Generate(int observation_size, int action_size, size_t nof_samples, ColumnarPath &path);
+
+	//! Both matrices and the times are the same, bit for bit
+	static bool Equal(const ColumnarView &a, const ColumnarView &b);
+};
+
+#endif /* TESTCODEC_H_ */
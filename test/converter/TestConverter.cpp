@@ -0,0 +1,164 @@
+/***************************************************************************************************
+ * @brief Checks the dense and sparse joint counts of the random variable converter
+ * @file TestConverter.cpp
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#include <TestConverter.h>
+#include <stdlib.h>
+#include <iostream>
+#include <algorithm>
+#include <map>
+#include <math.h>
+
+#include <boost/random.hpp>
+
+using namespace std;
+using namespace boost;
+
+TestConverter::TestConverter() {
+	entropy = new Entropy();
+	entropy->setEstimator(EE_PLUGIN);
+}
+
+TestConverter::~TestConverter() {
+	delete entropy;
+}
+
+int TestConverter::Test() {
+	int failures = 0;
+	failures += DenseSparse();
+	failures += Fallbacks();
+	return failures;
+}
+
+/**
+ * Every sample has a hidden value in [0,1], the observations and actions are that value plus some
+ * noise, so they share information.
+ */
+void TestConverter::Generate(int observation_size, int action_size, int nof_samples,
+		ColumnarPath &path) {
+	mt19937 rng(42);
+	boost::random::uniform_real_distribution<AP_TYPE> uniform(0, 1);
+	path.setDimensions(observation_size, action_size);
+	std::vector<AP_TYPE> observation(observation_size), action(action_size);
+	for (int t = 0; t < nof_samples; ++t) {
+		AP_TYPE hidden = uniform(rng);
+		for (int i = 0; i < observation_size; ++i) {
+			observation[i] = hidden + 0.2 * (uniform(rng) - 0.5);
+		}
+		for (int i = 0; i < action_size; ++i) {
+			action[i] = hidden + 0.2 * (uniform(rng) - 0.5);
+		}
+		path.push_back(observation.data(), action.data(), t);
+	}
+}
+
+PROB_TYPE TestConverter::MutualInformation(const RandomVariableConverter &converter) {
+	return entropy->calculate(converter.getSensorCounts()) + entropy->calculate(converter.getMotorCounts())
+			- entropy->calculate(converter.getSensorimotorCounts());
+}
+
+PROB_TYPE TestConverter::Reference(RandomVariableConverter &converter, const ColumnarPath &path) {
+	const Quantizer &quantizer = converter.getQuantizer();
+	int observation_size = path.getObservationSize(), action_size = path.getActionSize();
+	std::map<std::vector<int>, FREQ_TYPE> sensor, motor, joint;
+	for (size_t t = 0; t < path.size(); ++t) {
+		std::vector<int> s, m;
+		for (int i = 0; i < observation_size; ++i) {
+			s.push_back(quantizer.GetBin(i, path.getObservations()[t * observation_size + i]));
+		}
+		for (int i = 0; i < action_size; ++i) {
+			m.push_back(quantizer.GetBin(observation_size + i, path.getActions()[t * action_size + i]));
+		}
+		sensor[s]++;
+		motor[m]++;
+		std::vector<int> sm(s);
+		sm.insert(sm.end(), m.begin(), m.end());
+		joint[sm]++;
+	}
+	std::map<std::vector<int>, FREQ_TYPE> *histograms[] = { &sensor, &motor, &joint };
+	PROB_TYPE H[3];
+	for (int h = 0; h < 3; ++h) {
+		std::vector<FREQ_TYPE> counts;
+		for (std::map<std::vector<int>, FREQ_TYPE>::const_iterator i = histograms[h]->begin();
+				i != histograms[h]->end(); ++i) {
+			counts.push_back(i->second);
+		}
+		H[h] = entropy->calculate(counts);
+	}
+	return H[0] + H[1] - H[2];
+}
+
+int TestConverter::Compare(const char *name, HistogramMode mode, const ColumnarPath &path,
+		bool sparse, bool hashed) {
+	RandomVariableConverter converter;
+	converter.setNofBins(6);
+	converter.setHistogramMode(mode);
+	converter.setSensorimotorPath(&path);
+	converter.CalculateJointRandomVariables();
+	PROB_TYPE I = MutualInformation(converter);
+	PROB_TYPE expected = Reference(converter, path);
+	cout << name << ": " << I << " bits (should be " << expected << "), "
+			<< (converter.isSparse() ? (converter.isHashed() ? "hashed" : "sparse") : "dense") << endl;
+	int failures = 0;
+	failures += (fabs(I - expected) > 1e-9);
+	failures += (converter.isSparse() != sparse) + (converter.isHashed() != hashed);
+	return failures;
+}
+
+int TestConverter::DenseSparse() {
+	int failures = 0;
+	ColumnarPath path;
+	Generate(2, 1, 10000, path);
+	failures += Compare("Dense", HM_DENSE, path, false);
+	failures += Compare("Sparse", HM_SPARSE, path, true);
+	failures += Compare("Automatic, few channels", HM_AUTOMATIC, path, false);
+
+	// 6^12 dense bins cannot be filled by 10000 samples
+	ColumnarPath wide;
+	Generate(8, 4, 10000, wide);
+	failures += Compare("Automatic, many channels", HM_AUTOMATIC, wide, true);
+	return failures;
+}
+
+/**
+ * Dense mode with 6^12 bins is refused, and 30 channels of 3 bits do not fit in a key.
+ */
+int TestConverter::Fallbacks() {
+	int failures = 0;
+	ColumnarPath wide;
+	Generate(8, 4, 10000, wide);
+	failures += Compare("Dense, too many bins", HM_DENSE, wide, true);
+	ColumnarPath wider;
+	Generate(20, 10, 10000, wider);
+	failures += Compare("Sparse, too many bits", HM_SPARSE, wider, true, true);
+	return failures;
+}
+
+int main() {
+	TestConverter tc;
+	int failures = tc.Test();
+	if (failures) {
+		cout << "There are " << failures << " failures" << endl;
+		return EXIT_FAILURE;
+	}
+	cout << "All converter checks passed" << endl;
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,66 @@
+/***************************************************************************************************
+ * @brief Checks the dense and sparse joint counts of the random variable converter
+ * @file TestConverter.h
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#ifndef TESTCONVERTER_H_
+#define TESTCONVERTER_H_
+
+#include <RandomVariableConverter.h>
+#include <Entropy.h>
+
+/**
+ * Checks that the dense and the sparse counts of the RandomVariableConverter give the same mutual
+ * information as counting the binned values in a std::map, also when the mode is chosen
+ * automatically or the keys are hashed. The hash table, the binning and the quantile sketch have
+ * their own benches: test/counttable, test/quantizer and test/quantile.
+ */
+class TestConverter {
+public:
+	TestConverter();
+
+	~TestConverter();
+
+	//! Returns the number of failed checks
+	int Test();
+protected:
+	//! Dense, sparse and automatic counts on the same path
+	int DenseSparse();
+
+	//! Too many channels for a dense buffer or for a 64-bit key
+	int Fallbacks();
+
+	//! A path in which the actions follow the observations, with noise
+	void Generate(int observation_size, int action_size, int nof_samples, ColumnarPath &path);
+
+	//! The plug-in mutual information between sensor and motor symbols in bits
+	PROB_TYPE MutualInformation(const RandomVariableConverter &converter);
+
+	//! The same, from the bins of every value counted in a std::map
+	PROB_TYPE Reference(RandomVariableConverter &converter, const ColumnarPath &path);
+
+	//! Calculate with the given mode, compare with the reference, and tell if the counts were sparse
+	int Compare(const char *name, HistogramMode mode, const ColumnarPath &path, bool sparse,
+			bool hashed = false);
+private:
+	Entropy *entropy;
+};
+
+#endif /* TESTCONVERTER_H_ */
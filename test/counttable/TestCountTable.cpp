@@ -0,0 +1,83 @@
+/***************************************************************************************************
+ * @brief Checks the hash table behind the sparse joint counts
+ * @file TestCountTable.cpp
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#include <TestCountTable.h>
+#include <stdlib.h>
+#include <iostream>
+#include <map>
+
+#include <boost/random.hpp>
+
+using namespace std;
+using namespace boost;
+
+int TestCountTable::Test() {
+	int failures = 0;
+	failures += Counts();
+	return failures;
+}
+
+/**
+ * Enough keys to make the table grow a few times, some of them very large.
+ */
+int TestCountTable::Counts() {
+	mt19937 rng(7);
+	boost::random::uniform_int_distribution<int> key(0, 5000);
+	CountTable table;
+	std::map<uint64_t, FREQ_TYPE> reference;
+	for (int i = 0; i < 100000; ++i) {
+		uint64_t k = key(rng);
+		k = (k & 1) ? k : k << 40;
+		table.Increment(k);
+		reference[k]++;
+	}
+	table.Increment(COUNTTABLE_EMPTY_KEY - 1);
+	reference[COUNTTABLE_EMPTY_KEY - 1]++;
+
+	int failures = 0;
+	failures += (table.size() != reference.size());
+	for (std::map<uint64_t, FREQ_TYPE>::const_iterator i = reference.begin(); i != reference.end(); ++i) {
+		failures += (table.Count(i->first) != i->second);
+	}
+	failures += (table.Count(5002ULL << 40) != 0);
+
+	std::vector<uint64_t> keys;
+	std::vector<FREQ_TYPE> counts;
+	table.Export(keys, counts);
+	failures += (keys.size() != reference.size()) + (counts.size() != reference.size());
+	for (size_t i = 0; i < keys.size(); ++i) {
+		failures += (reference[keys[i]] != counts[i]);
+	}
+	cout << "Hash table of " << table.size() << " keys (should be " << reference.size() << ")" << endl;
+	return failures;
+}
+
+int main() {
+	TestCountTable tct;
+	int failures = tct.Test();
+	if (failures) {
+		cout << "There are " << failures << " failures" << endl;
+		return EXIT_FAILURE;
+	}
+	cout << "All hash table checks passed" << endl;
+	return EXIT_SUCCESS;
+}
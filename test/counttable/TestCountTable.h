@@ -0,0 +1,41 @@
+/***************************************************************************************************
+ * @brief Checks the hash table behind the sparse joint counts
+ * @file TestCountTable.h
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#ifndef TESTCOUNTTABLE_H_
+#define TESTCOUNTTABLE_H_
+
+#include <CountTable.h>
+
+/**
+ * Checks the open-addressing hash table that counts the joint symbols of the sparse histograms
+ * against a std::map, with keys that make it grow and keys next to the empty key.
+ */
+class TestCountTable {
+public:
+	//! Returns the number of failed checks
+	int Test();
+protected:
+	//! Keys and counts of the hash table against a std::map
+	int Counts();
+};
+
+#endif /* TESTCOUNTTABLE_H_ */
@@ -0,0 +1,140 @@
+/***************************************************************************************************
+ * @brief
+ * @file TestEntropy.cpp
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#include <TestEntropy.h>
+#include <stdlib.h>
+#include <iostream>
+#include <math.h>
+
+#include <boost/random.hpp>
+
+using namespace std;
+using namespace boost;
+
+TestEntropy::TestEntropy() {
+	entropy = new Entropy();
+}
+
+TestEntropy::~TestEntropy() {
+	delete entropy;
+}
+
+int TestEntropy::Test() {
+	int failures = 0;
+	failures += Log();
+	failures += Exact();
+	failures += Undersampled();
+	return failures;
+}
+
+int TestEntropy::Log() {
+	std::vector<PROB_TYPE> x, y;
+	for (PROB_TYPE v = 1e-300; v < 1e300; v *= 1.37) {
+		x.push_back(v);
+	}
+	y.resize(x.size());
+	vlog(&x[0], &y[0], x.size());
+	PROB_TYPE max_error = 0;
+	for (size_t i = 0; i < x.size(); ++i) {
+		PROB_TYPE error = fabs(y[i] - log(x[i])) / (1 + fabs(log(x[i])));
+		if (error > max_error) max_error = error;
+	}
+	cout << "Maximum relative error of vlog is " << max_error << endl;
+	return (max_error > 1e-12);
+}
+
+int TestEntropy::Exact() {
+	int failures = 0;
+	entropy->setEstimator(EE_PLUGIN);
+
+	// uniform over 8 bins is 3 bits, counts beyond the n*log(n) table should give the same
+	std::vector<FREQ_TYPE> counts(8, 5);
+	PROB_TYPE H = entropy->calculate(counts);
+	std::vector<FREQ_TYPE> large_counts(8, 5 * NLOGN_TABLE_SIZE);
+	PROB_TYPE H_large = entropy->calculate(large_counts);
+	cout << "Uniform over 8 bins: " << H << " and " << H_large << " (should be 3)" << endl;
+	failures += (fabs(H - 3) > 1e-9) + (fabs(H_large - 3) > 1e-9);
+
+	// empty bins may be left out
+	counts.resize(16, 0);
+	PROB_TYPE H_zeros = entropy->calculate(counts);
+	failures += (fabs(H_zeros - 3) > 1e-9);
+
+	// probabilities
+	Point p(4, 0.25);
+	PROB_TYPE H_p = entropy->calculate(p);
+	cout << "Uniform over 4 probabilities: " << H_p << " (should be 2)" << endl;
+	failures += (fabs(H_p - 2) > 1e-9);
+
+	// Miller-Madow adds (K-1)/2N nats
+	entropy->setEstimator(EE_MILLER_MADOW);
+	PROB_TYPE H_mm = entropy->calculate(counts);
+	PROB_TYPE expected = 3 + 7 / (2.0 * 40) / M_LN2;
+	cout << "Miller-Madow: " << H_mm << " (should be " << expected << ")" << endl;
+	failures += (fabs(H_mm - expected) > 1e-9);
+	return failures;
+}
+
+/**
+ * With N=300 samples from a uniform distribution over K=1000 symbols the plug-in estimate is way off.
+ * The NSB estimator should be much closer to log2(1000), also when the empty bins are not stored.
+ */
+int TestEntropy::Undersampled() {
+	int K = 1000, N = 300;
+	mt19937 rng(42);
+	boost::random::uniform_int_distribution<> symbol(0, K - 1);
+	std::vector<FREQ_TYPE> counts(K, 0);
+	for (int i = 0; i < N; ++i) {
+		counts[symbol(rng)]++;
+	}
+	std::vector<FREQ_TYPE> sparse;
+	for (int i = 0; i < K; ++i) {
+		if (counts[i]) sparse.push_back(counts[i]);
+	}
+
+	PROB_TYPE truth = log(K) / M_LN2;
+	entropy->setEstimator(EE_PLUGIN);
+	PROB_TYPE H_ml = entropy->calculate(counts);
+	entropy->setEstimator(EE_MILLER_MADOW);
+	PROB_TYPE H_mm = entropy->calculate(counts);
+	entropy->setEstimator(EE_NSB);
+	PROB_TYPE H_nsb = entropy->calculate(counts);
+	PROB_TYPE H_nsb_sparse = entropy->calculate(sparse, K);
+	cout << "Undersampled uniform, truth " << truth << ": plug-in " << H_ml << ", Miller-Madow "
+			<< H_mm << ", NSB " << H_nsb << " (sparse " << H_nsb_sparse << ")" << endl;
+	int failures = 0;
+	failures += !(fabs(H_mm - truth) < fabs(H_ml - truth));
+	failures += !(fabs(H_nsb - truth) < fabs(H_mm - truth));
+	failures += (fabs(H_nsb - H_nsb_sparse) > 1e-9);
+	return failures;
+}
+
+int main() {
+	TestEntropy te;
+	int failures = te.Test();
+	if (failures) {
+		cout << "There are " << failures << " failures" << endl;
+		return EXIT_FAILURE;
+	}
+	cout << "All entropy checks passed" << endl;
+	return EXIT_SUCCESS;
+}
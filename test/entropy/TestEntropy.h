@@ -0,0 +1,55 @@
+/***************************************************************************************************
+ * @brief
+ * @file TestEntropy.h
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+
+#ifndef TESTENTROPY_H_
+#define TESTENTROPY_H_
+
+#include <Entropy.h>
+
+/**
+ * Checks the entropy kernels against analytic values. The bias corrections are checked on an
+ * undersampled uniform distribution, for which the plug-in estimate is known to be far too low.
+ */
+class TestEntropy {
+public:
+	TestEntropy();
+
+	~TestEntropy();
+
+	//! Returns the number of failed checks
+	int Test();
+protected:
+	//! Accuracy of the vectorized logarithm
+	int Log();
+
+	//! Histograms for which the entropy is known exactly
+	int Exact();
+
+	//! Uniform distribution over many bins, with few samples
+	int Undersampled();
+private:
+	Entropy *entropy;
+};
+
+
+#endif /* TESTENTROPY_H_ */
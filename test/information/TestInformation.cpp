@@ -0,0 +1,148 @@
+/***************************************************************************************************
+ * @brief Checks the running information metrics against counts from scratch
+ * @file TestInformation.cpp
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+
+#include <TestInformation.h>
+#include <stdlib.h>
+#include <iostream>
+#include <map>
+#include <math.h>
+
+#include <boost/random.hpp>
+
+using namespace std;
+
+int TestInformation::Test() {
+	int failures = 0;
+	failures += Incremental();
+	failures += Refused();
+	return failures;
+}
+
+template<typename Key>
+PROB_TYPE TestInformation::Entropy(const std::vector<Key> &keys) {
+	std::map<Key, int> counts;
+	for (size_t i = 0; i < keys.size(); ++i) {
+		counts[keys[i]]++;
+	}
+	PROB_TYPE H = 0;
+	for (typename std::map<Key, int>::const_iterator it = counts.begin(); it != counts.end(); ++it) {
+		PROB_TYPE p = it->second / (PROB_TYPE)keys.size();
+		H -= p * log2(p);
+	}
+	return H;
+}
+
+/**
+ * The action is a noisy copy of the observation, so the mutual information is well above zero.
+ * The reference bins every value with its own quantizer and counts the bins as vectors.
+ */
+int TestInformation::Incremental() {
+	int failures = 0;
+	boost::mt19937 rng(5);
+	boost::random::uniform_real_distribution<AP_TYPE> uniform(0, 1);
+	boost::random::normal_distribution<AP_TYPE> noise(0, 0.1);
+	Information information;
+	information.setEstimator(EE_PLUGIN);
+	information.setNofBins(6);
+	Quantizer quantizer;
+	quantizer.setNofBins(6);
+	quantizer.setChannels(3);
+	typedef std::vector<int> Bins;
+	std::vector<Bins> sensor, motor, joint;
+	PROB_TYPE max_error = 0;
+	for (int t = 0; t < 2000; ++t) {
+		Observation observation(2);
+		Action action(1);
+		observation[0] = uniform(rng);
+		observation[1] = uniform(rng);
+		action[0] = observation[0] + noise(rng);
+		information.Add(observation, action);
+		Bins s(2), m(1);
+		s[0] = quantizer.GetBin(0, observation[0]);
+		s[1] = quantizer.GetBin(1, observation[1]);
+		m[0] = quantizer.GetBin(2, action[0]);
+		Bins j(s);
+		j.push_back(m[0]);
+		sensor.push_back(s);
+		motor.push_back(m);
+		joint.push_back(j);
+		if (t % 97 && t != 1999) continue;
+		PROB_TYPE I = Entropy(sensor) + Entropy(motor) - Entropy(joint);
+		PROB_TYPE error = fabs(information.getMutualInformation() - I);
+		error += fabs(information.getSensorimotorEntropy() - Entropy(joint));
+		max_error = (error > max_error) ? error : max_error;
+	}
+	failures += (max_error > 1e-9) + (information.getCount() != 2000);
+	failures += (information.getMutualInformation() < 0.5);
+	cout << "Running metrics differ at most " << max_error << " from counts from scratch, I = "
+			<< information.getMutualInformation() << " bits" << endl;
+	return failures;
+}
+
+/**
+ * With 1000 bins six values give 10^18 symbols, which fits in 64 bits, seven do not.
+ */
+int TestInformation::Refused() {
+	int failures = 0;
+	Information information;
+	Observation pair(1, 0.5), triple(3, 0.5);
+	Action action(1, 0.5);
+	information.Add(pair, action);
+	information.Add(triple, action);
+	failures += (information.getCount() != 1);
+	failures += information.setNofBins(4) + information.setRange(-1, 1);
+	information.Clear();
+	failures += !information.setRange(-1, 1) + information.setRange(1, 1);
+	information.Add(triple, action);
+	failures += (information.getCount() != 1);
+
+	information.Clear();
+	failures += !information.setNofBins(1000) + information.setNofBins(0);
+	Observation wide(6, 0.5), wider(7, 0.5);
+	Action none;
+	information.Add(wide, none);
+	failures += (information.getCount() != 1);
+	information.Clear();
+	information.Add(wider, none);
+	information.Add(wider, none);
+	information.Add(wide, action);
+	failures += (information.getCount() != 0);
+	information.Clear();
+	information.Add(wide, none);
+	failures += (information.getCount() != 1);
+	if (failures) {
+		cerr << "Pairs that cannot be counted are not refused" << endl;
+	}
+	return failures;
+}
+
+int main() {
+	TestInformation ti;
+	int failures = ti.Test();
+	if (failures) {
+		cout << "There are " << failures << " failures" << endl;
+		return EXIT_FAILURE;
+	}
+	cout << "All information checks passed" << endl;
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,51 @@
+/***************************************************************************************************
+ * @brief Checks the running information metrics against counts from scratch
+ * @file TestInformation.h
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+
+#ifndef TESTINFORMATION_H_
+#define TESTINFORMATION_H_
+
+#include <Information.h>
+
+#include <vector>
+
+/**
+ * Checks that the entropies and mutual information that are maintained per pair are the same as
+ * those of the pairs counted all at once, and that pairs that cannot be counted are skipped.
+ */
+class TestInformation {
+public:
+	//! Returns the number of failed checks
+	int Test();
+protected:
+	//! After every pair the metrics equal those computed from scratch
+	int Incremental();
+
+	//! Pairs of other sizes, or with too many symbols for 64 bits, are not counted
+	int Refused();
+
+	//! The plug-in entropy in bits of the counts of the keys
+	template<typename Key>
+	PROB_TYPE Entropy(const std::vector<Key> &keys);
+};
+
+#endif /* TESTINFORMATION_H_ */
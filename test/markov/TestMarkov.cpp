@@ -0,0 +1,169 @@
+/***************************************************************************************************
+ * @brief Stationary distributions, reward curves and return variances of Markov chains
+ * @file TestMarkov.cpp
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#include <TestMarkov.h>
+#include <CounterRandom.h>
+
+#include <iostream>
+#include <vector>
+#include <stdlib.h>
+#include <math.h>
+
+using namespace std;
+
+int TestMarkov::Test() {
+	int failures = 0;
+	failures += Stationary();
+	failures += Simulation();
+	failures += Invalid();
+	return failures;
+}
+
+/**
+ * The first matrix of transeigen.m is the product of two chains with stationary distribution
+ * (10/13, 3/13), so its stationary distribution is (100, 30, 30, 9) / 169.
+ */
+int TestMarkov::Stationary() {
+	int failures = 0;
+	PROB_TYPE matrix[4][4] = { { 0.49, 0.21, 0.21, 0.09 }, { 0.7, 0, 0.3, 0 }, { 0.7, 0.3, 0, 0 },
+			{ 1, 0, 0, 0 } };
+	PROB_TYPE expected[4] = { 100.0 / 169, 30.0 / 169, 30.0 / 169, 9.0 / 169 };
+	TransitionTable table(4, 1);
+	for (int s = 0; s < 4; ++s) {
+		for (int next = 0; next < 4; ++next) {
+			table.Add(s, 0, next, matrix[s][next], s == 0 ? 1 : 0);
+		}
+	}
+	failures += !table.Prepare();
+	MarkovChain chain;
+	chain.Build(table, std::vector<uint32_t>(4, 0));
+	std::vector<PROB_TYPE> distribution;
+	failures += !chain.Stationary(distribution);
+	for (int s = 0; s < 4; ++s) {
+		failures += (fabs(distribution[s] - expected[s]) > 1e-9);
+	}
+	failures += (fabs(chain.Mean(distribution) - expected[0]) > 1e-9);
+
+	// a cycle of two states, the plain power iteration would alternate forever
+	TransitionTable cycle(2, 1);
+	cycle.Add(0, 0, 1, 1, 0);
+	cycle.Add(1, 0, 0, 1, 0);
+	failures += !cycle.Prepare();
+	chain.Build(cycle, std::vector<uint32_t>(2, 0));
+	distribution.assign(1, 1);
+	distribution.push_back(0);
+	failures += !chain.Stationary(distribution);
+	failures += (fabs(distribution[0] - 0.5) > 1e-9);
+	return failures;
+}
+
+/**
+ * A random chain of 20 states with a few outcomes per state and rewards in [-1,1], simulated from
+ * state 0 for 200 ticks (gamma^200 is negligible). The simulated means should be within 5 standard
+ * errors of the exact ones, and the simulated variances within 5%.
+ */
+int TestMarkov::Simulation() {
+	int failures = 0;
+	const size_t n = 20;
+	const AP_TYPE gamma = 0.9;
+	CounterRandom random(3);
+	TransitionTable table(n, 1);
+	for (size_t s = 0; s < n; ++s) {
+		size_t outcomes = 1 + random.Bits() % 3;
+		for (size_t k = 0; k < outcomes; ++k) {
+			table.Add(s, 0, random.Bits() % n, PROB_TYPE(1) / outcomes, 2 * random.Uniform() - 1);
+		}
+	}
+	failures += !table.Prepare();
+	MarkovChain chain;
+	chain.Build(table, std::vector<uint32_t>(n, 0));
+
+	const int horizon = 200, trials = 100000;
+	std::vector<PROB_TYPE> start(n, 0);
+	start[0] = 1;
+	std::vector<AP_TYPE> means, variances, values, return_variances;
+	chain.RewardCurve(start, horizon, means, variances);
+	failures += !chain.Return(gamma, values, return_variances);
+
+	std::vector<AP_TYPE> sums(horizon, 0), squares(horizon, 0);
+	AP_TYPE return_sum = 0, return_square = 0;
+	for (int trial = 0; trial < trials; ++trial) {
+		size_t state = 0;
+		AP_TYPE discounted = 0, weight = 1;
+		for (int t = 0; t < horizon; ++t) {
+			const Transition &transition = table.Sample(state, 0, random.Uniform());
+			sums[t] += transition.reward;
+			squares[t] += transition.reward * transition.reward;
+			discounted += weight * transition.reward;
+			weight *= gamma;
+			state = transition.next;
+		}
+		return_sum += discounted;
+		return_square += discounted * discounted;
+	}
+	for (int t = 0; t < horizon; t += 10) {
+		AP_TYPE mean = sums[t] / trials, variance = squares[t] / trials - mean * mean;
+		failures += (fabs(mean - means[t]) > 5 * sqrt(variances[t] / trials) + 1e-12);
+		failures += (fabs(variance - variances[t]) > 0.05 * variances[t] + 1e-12);
+	}
+	AP_TYPE mean = return_sum / trials, variance = return_square / trials - mean * mean;
+	failures += (fabs(mean - values[0]) > 5 * sqrt(return_variances[0] / trials));
+	failures += (fabs(variance - return_variances[0]) > 0.05 * return_variances[0]);
+	cout << "Discounted return from state 0: " << values[0] << " (simulated " << mean
+			<< "), variance " << return_variances[0] << " (simulated " << variance << ")" << endl;
+	return failures;
+}
+
+int TestMarkov::Invalid() {
+	int failures = 0;
+	TransitionTable table(2, 2);
+	table.Add(0, 0, 1, 1, 1);
+	table.Add(0, 1, 0, 1, 0);
+	table.Add(1, 0, 0, 1, 0);
+	table.Add(1, 1, 1, 1, 0);
+	failures += !table.Prepare();
+	MarkovChain chain;
+	std::vector<PROB_TYPE> distribution;
+	failures += chain.Stationary(distribution);
+	failures += chain.Build(table, std::vector<uint32_t>(3, 0));
+	failures += chain.Build(table, std::vector<uint32_t>(2, 2)) + (chain.size() != 0);
+	failures += chain.Stationary(distribution);
+	failures += !chain.Build(table, std::vector<uint32_t>(2, 0)) + (chain.size() != 2);
+	std::vector<AP_TYPE> means, variances;
+	failures += chain.RewardCurve(std::vector<PROB_TYPE>(3, 0), 10, means, variances);
+	failures += chain.Return(1, means, variances);
+	if (failures) {
+		cerr << "Invalid chains are not refused" << endl;
+	}
+	return failures;
+}
+
+int main() {
+	TestMarkov tm;
+	int failures = tm.Test();
+	if (failures) {
+		cout << "There are " << failures << " failures" << endl;
+		return EXIT_FAILURE;
+	}
+	cout << "All Markov chain checks passed" << endl;
+	return EXIT_SUCCESS;
+}
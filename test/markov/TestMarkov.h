@@ -0,0 +1,48 @@
+/***************************************************************************************************
+ * @brief Stationary distributions, reward curves and return variances of Markov chains
+ * @file TestMarkov.h
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#ifndef TESTMARKOV_H_
+#define TESTMARKOV_H_
+
+#include <MarkovChain.h>
+
+/**
+ * The stationary distribution of the chain in scripts/transeigen.m, which is known in closed form,
+ * and of a chain that cycles. The reward curve and the mean and variance of the discounted return
+ * of a random chain are compared with simulated trials.
+ */
+class TestMarkov {
+public:
+	//! Returns the number of failed checks
+	int Test();
+protected:
+	//! Known stationary distributions
+	int Stationary();
+
+	//! Exact moments against simulated ones
+	int Simulation();
+
+	//! Policies that do not fit the table, empty chains and distributions of the wrong size
+	int Invalid();
+};
+
+#endif /* TESTMARKOV_H_ */
@@ -0,0 +1,148 @@
+/***************************************************************************************************
+ * @brief Value iteration, policy iteration and modified policy iteration on random problems
+ * @file TestMDP.cpp
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#include <TestMDP.h>
+#include <CounterRandom.h>
+
+#include <iostream>
+#include <vector>
+#include <stdlib.h>
+#include <math.h>
+#include <sys/time.h>
+
+using namespace std;
+
+static double now() {
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+int TestMDP::Test() {
+	int failures = 0;
+	failures += Solve(2, 2, 0.5, 1);
+	failures += Solve(10, 3, 0.9, 2);
+	failures += Solve(50, 4, 0.95, 3);
+	failures += Solve(200, 5, 0.99, 4);
+	failures += Invalid();
+	return failures;
+}
+
+int TestMDP::Invalid() {
+	int failures = 0;
+	TransitionTable table;
+	MDPSolver solver;
+	std::vector<AP_TYPE> values;
+	Generate(table, 4, 2, 5);
+	TransitionTable unprepared(4, 2);
+	unprepared.Add(0, 0, 1, 0.5, 1);
+	failures += solver.ValueIteration(unprepared) + solver.PolicyIteration(unprepared);
+	failures += solver.Evaluate(unprepared, std::vector<uint32_t>(4, 0), values);
+	solver.setDiscountFactor(1);
+	failures += solver.ValueIteration(table) + solver.ModifiedPolicyIteration(table);
+	failures += solver.PolicyIteration(table) + !solver.getValues().empty();
+	solver.setDiscountFactor(0.9);
+	failures += solver.Evaluate(table, std::vector<uint32_t>(3, 0), values);
+	failures += solver.Evaluate(table, std::vector<uint32_t>(4, 2), values) + !values.empty();
+	failures += !solver.Evaluate(table, std::vector<uint32_t>(4, 1), values) + (values.size() != 4);
+	if (failures) {
+		cerr << "Invalid problems are not refused by the solver" << endl;
+	}
+	return failures;
+}
+
+void TestMDP::Generate(TransitionTable &table, size_t nof_states, size_t nof_actions,
+		uint32_t seed) {
+	CounterRandom random(seed);
+	table.Resize(nof_states, nof_actions);
+	for (size_t s = 0; s < nof_states; ++s) {
+		for (size_t a = 0; a < nof_actions; ++a) {
+			size_t n = 1 + random.Bits() % 4;
+			std::vector<PROB_TYPE> weights(n);
+			PROB_TYPE sum = 0;
+			for (size_t k = 0; k < n; ++k) {
+				weights[k] = random.Uniform() + 0.01;
+				sum += weights[k];
+			}
+			for (size_t k = 0; k < n; ++k) {
+				size_t next = random.Bits() % nof_states;
+				AP_TYPE reward = (next == nof_states - 1) ? 10 : random.Uniform() - 0.5;
+				table.Add(s, a, next, weights[k] / sum, reward);
+			}
+		}
+	}
+	table.Prepare();
+}
+
+int TestMDP::Solve(size_t nof_states, size_t nof_actions, AP_TYPE discount_factor, uint32_t seed) {
+	int failures = 0;
+	TransitionTable table;
+	Generate(table, nof_states, nof_actions, seed);
+	MDPSolver solver;
+	solver.setDiscountFactor(discount_factor);
+	solver.setTolerance(1e-6);
+
+	double start = now();
+	failures += !solver.PolicyIteration(table);
+	double time_pi = now() - start;
+	std::vector<AP_TYPE> optimal = solver.getValues();
+	int iterations_pi = solver.getIterations();
+
+	const char *names[] = { "value iteration (Jacobi)", "value iteration (Gauss-Seidel)",
+			"modified policy iteration" };
+	int iterations[3];
+	cout << nof_states << " states, " << nof_actions << " actions, gamma " << discount_factor
+			<< ": policy iteration " << iterations_pi << " policies (" << time_pi * 1e3 << " ms)";
+	for (int method = 0; method < 3; ++method) {
+		solver.setGaussSeidel(method > 0);
+		start = now();
+		bool converged = (method < 2) ? solver.ValueIteration(table) :
+				solver.ModifiedPolicyIteration(table);
+		double time = now() - start;
+		failures += !converged;
+		iterations[method] = solver.getIterations();
+		cout << ", " << names[method] << " " << iterations[method] << " iterations (" << time * 1e3
+				<< " ms)";
+
+		// the values are within the bound, the policy within the tolerance
+		std::vector<AP_TYPE> values;
+		solver.Evaluate(table, solver.getPolicy(), values);
+		for (size_t s = 0; s < nof_states; ++s) {
+			failures += (fabs(solver.getValues()[s] - optimal[s]) > solver.getBound() + 1e-9);
+			failures += (values[s] < optimal[s] - 1e-6);
+		}
+	}
+	cout << endl;
+	failures += (iterations[1] > iterations[0]);
+	return failures;
+}
+
+int main() {
+	TestMDP tm;
+	int failures = tm.Test();
+	if (failures) {
+		cout << "There are " << failures << " failures" << endl;
+		return EXIT_FAILURE;
+	}
+	cout << "All solver checks passed" << endl;
+	return EXIT_SUCCESS;
+}
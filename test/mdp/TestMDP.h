@@ -0,0 +1,48 @@
+/***************************************************************************************************
+ * @brief Value iteration, policy iteration and modified policy iteration on random problems
+ * @file TestMDP.h
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#ifndef TESTMDP_H_
+#define TESTMDP_H_
+
+#include <MDPSolver.h>
+
+/**
+ * The solvers should agree on random problems: policy iteration is exact, the values of the
+ * others should be within their bound of it, and the value of the policies they return within the
+ * tolerance. Gauss-Seidel sweeps should need fewer iterations than Jacobi sweeps.
+ */
+class TestMDP {
+public:
+	//! Returns the number of failed checks
+	int Test();
+protected:
+	//! A problem with a few outcomes per row, and a state with a lot of reward
+	void Generate(TransitionTable &table, size_t nof_states, size_t nof_actions, uint32_t seed);
+
+	//! All solvers on one problem
+	int Solve(size_t nof_states, size_t nof_actions, AP_TYPE discount_factor, uint32_t seed);
+
+	//! Tables that are not prepared, discount factors of 1 or more, and policies that do not fit
+	int Invalid();
+};
+
+#endif /* TESTMDP_H_ */
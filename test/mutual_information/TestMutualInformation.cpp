@@ -109,11 +109,12 @@ void TestMutualInformation::Normal() {
 	ofstream fout;
 	fout.open("data.txt");
 
-	SensorimotorPath path;
+	Arena arena;
+	SensorimotorPath path((ArenaAllocator<SensationActionPair*>(&arena)));
 	int action_vector = 1; int observation_vector = 1;
 	int timespan = 1000;
 	for (int t = 1; t < timespan+1; ++t) {
-		SensationActionPair *sa = new SensationActionPair();
+		SensationActionPair *sa = arena.New<SensationActionPair>(&arena);
 		sa->t = t;
 		for (int a = 0; a < action_vector; ++a) {
 			AP_TYPE action = var_norm();
@@ -135,17 +136,26 @@ void TestMutualInformation::Normal() {
 
 	PROB_TYPE result = mi->calculate(path);
 	cout << "Mutual information is " << result << endl;
+
+	ColumnarPath columnar_path;
+	columnar_path.assign(path);
+	PROB_TYPE columnar_result = mi->calculate(columnar_path);
+	cout << "Mutual information on columnar path is " << columnar_result << endl;
+	if (fabs(columnar_result - result) > 1e-9) {
+		cout << "Columnar path should give the same result" << endl;
+	}
 }
 
 void TestMutualInformation::Sinus() {
 
 	mi->setMIApproximation(MI_K_NEAREST_NEIGHBOUR);
 
-	SensorimotorPath path;
+	Arena arena;
+	SensorimotorPath path((ArenaAllocator<SensationActionPair*>(&arena)));
 	int action_vector = 1; int observation_vector = 1;
 	int timespan = 500;
 	for (int t = 1; t < timespan+1; ++t) {
-		SensationActionPair *sa = new SensationActionPair();
+		SensationActionPair *sa = arena.New<SensationActionPair>(&arena);
 		cout << "t=" << t;
 		sa->t = t;
 		for (int a = 0; a < action_vector; ++a) {
@@ -171,11 +181,12 @@ void TestMutualInformation::Sinus() {
 void TestMutualInformation::Independent() {
 	mi->setMIApproximation(MI_K_NEAREST_NEIGHBOUR);
 
-	SensorimotorPath path;
+	Arena arena;
+	SensorimotorPath path((ArenaAllocator<SensationActionPair*>(&arena)));
 	int action_vector = 1; int observation_vector = 1;
 	int timespan = 500;
 	for (int t = 1; t < timespan+1; ++t) {
-		SensationActionPair *sa = new SensationActionPair();
+		SensationActionPair *sa = arena.New<SensationActionPair>(&arena);
 		cout << "t=" << t;
 		sa->t = t;
 		for (int a = 0; a < action_vector; ++a) {
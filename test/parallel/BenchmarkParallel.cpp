@@ -0,0 +1,172 @@
+/***************************************************************************************************
+ * @brief Speed-up of ticking systems in parallel, for different numbers and costs of systems
+ * @file BenchmarkParallel.cpp
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#include <BenchmarkParallel.h>
+#include <Embodiment.h>
+
+#include <iostream>
+#include <iomanip>
+#include <thread>
+#include <chrono>
+#include <math.h>
+#include <sys/time.h>
+
+using namespace std;
+
+void CostlySystem::FixedTick(const FixedObservation &observation, FixedAction &action) {
+	AP_TYPE x = 0.5 + 0.4 * sin(observation[0]);
+	for (int i = 0; i < cost; ++i) {
+		x = 3.9 * x * (1 - x);
+	}
+	action[0] = x - 0.5;
+}
+
+void SumEnvironment::FixedInit(std::vector<FixedObservation> &observations,
+		std::vector<FixedState> &states) {
+	for (size_t i = 0; i < states.size(); ++i) {
+		states[i][0] = i;
+		observations[i][0] = states[i][0];
+	}
+}
+
+void SumEnvironment::FixedTick(const std::vector<FixedAction> &actions,
+		std::vector<FixedObservation> &observations, std::vector<FixedState> &states) {
+	instantaneous_reward = 0;
+	for (size_t i = 0; i < actions.size(); ++i) {
+		states[i][0] += actions[i][0];
+		observations[i][0] = states[i][0];
+		instantaneous_reward += actions[i][0];
+	}
+	discounted_reward = instantaneous_reward + 0.9 * discounted_reward;
+}
+
+static double now() {
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+double BenchmarkParallel::Measure(size_t nof_systems, int cost, size_t nof_threads,
+		long int nof_ticks, AP_TYPE &result) {
+	std::vector<CostlySystem> robots(nof_systems, CostlySystem(cost));
+	AP_SYSTEMS systems;
+	for (size_t i = 0; i < nof_systems; ++i) {
+		systems.push_back(&robots[i]);
+	}
+	SumEnvironment env;
+	Embodiment embodiment;
+	Coupling coupling;
+	embodiment.Couple(env, systems, coupling);
+	embodiment.SetThreads(nof_threads);
+	embodiment.Restart();
+	double start = now();
+	for (long int t = 0; t < nof_ticks; ++t) {
+		embodiment.Tick();
+	}
+	double duration = now() - start;
+	result = env.GetDiscountedReward();
+	return duration;
+}
+
+/**
+ * Restart a pool with a different number of workers after a job, the way SetThreads does. The new
+ * threads should wait for the next job, not execute the previous one again. The pause gives them
+ * the time to do so if they would.
+ */
+int BenchmarkParallel::Restarts() {
+	int failures = 0;
+	WorkerPool pool;
+	CountingJob job;
+	size_t worker_counts[] = { 2, 4, 3, 2, 1, 4 };
+	long int expected = 0;
+	for (int r = 0; r < 6; ++r) {
+		pool.Start(worker_counts[r]);
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		if (job.count.load() != expected) {
+			cerr << "Pool restarted with " << worker_counts[r] << " workers executed "
+					<< job.count.load() - expected << " items without a run" << endl;
+			++failures;
+			expected = job.count.load();
+		}
+		for (int run = 0; run < 4; ++run) {
+			pool.Run(job, 10);
+			expected += 10;
+		}
+		if (job.count.load() != expected) {
+			cerr << "Pool with " << worker_counts[r] << " workers executed " << job.count.load()
+					<< " items instead of " << expected << endl;
+			++failures;
+			expected = job.count.load();
+		}
+	}
+	return failures;
+}
+
+/**
+ * The number of ticks is chosen such that every run does about the same amount of work. The
+ * parallel runs use all hardware threads (at least 2), and half of them.
+ */
+int BenchmarkParallel::Run() {
+	int failures = 0;
+	size_t hardware = std::max<size_t>(std::thread::hardware_concurrency(), 2);
+	size_t thread_counts[] = { hardware / 2, hardware };
+	size_t system_counts[] = { 2, 8, 32, 128 };
+	int costs[] = { 0, 100, 1000, 10000 };
+	cout << "Hardware threads: " << std::thread::hardware_concurrency() << endl;
+	if (std::thread::hardware_concurrency() <= 1) {
+		cout << "With a single hardware thread the parallel runs only show the overhead" << endl;
+	}
+	cout << setw(8) << "systems" << setw(8) << "cost" << setw(8) << "threads" << setw(14)
+			<< "ticks/s" << setw(10) << "speed-up" << endl;
+	for (int s = 0; s < 4; ++s) {
+		for (int c = 0; c < 4; ++c) {
+			size_t nof_systems = system_counts[s];
+			int cost = costs[c];
+			long int nof_ticks = std::max<long int>(20000000 / (nof_systems * (cost + 20)), 10);
+			AP_TYPE serial_result, result;
+			double serial = Measure(nof_systems, cost, 1, nof_ticks, serial_result);
+			cout << setw(8) << nof_systems << setw(8) << cost << setw(8) << 1 << setw(14)
+					<< (long int)(nof_ticks / serial) << setw(10) << 1.0 << endl;
+			for (int n = 0; n < 2; ++n) {
+				if (thread_counts[n] < 2 || (n && thread_counts[n] == thread_counts[0])) continue;
+				double parallel = Measure(nof_systems, cost, thread_counts[n], nof_ticks, result);
+				cout << setw(8) << nof_systems << setw(8) << cost << setw(8) << thread_counts[n]
+						<< setw(14) << (long int)(nof_ticks / parallel) << setw(10) << setprecision(3)
+						<< serial / parallel << endl;
+				if (result != serial_result) {
+					cerr << "Result with " << thread_counts[n] << " threads differs: " << result
+							<< " instead of " << serial_result << endl;
+					++failures;
+				}
+			}
+		}
+	}
+	return failures;
+}
+
+int main() {
+	BenchmarkParallel benchmark;
+	int failures = benchmark.Restarts();
+	failures += benchmark.Run();
+	cout << (failures ? "FAILED" : "OK") << endl;
+	return failures;
+}
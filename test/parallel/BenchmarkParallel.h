@@ -0,0 +1,91 @@
+/***************************************************************************************************
+ * @brief Speed-up of ticking systems in parallel, for different numbers and costs of systems
+ * @file BenchmarkParallel.h
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#ifndef BENCHMARKPARALLEL_H_
+#define BENCHMARKPARALLEL_H_
+
+#include <System.h>
+#include <Environment.h>
+#include <WorkerPool.h>
+
+#include <atomic>
+#include <stddef.h>
+
+/**
+ * A system that "plans": it iterates a chaotic map a fixed number of times, starting from its
+ * observation, so its cost per tick can be set while the result stays deterministic.
+ */
+class CostlySystem: public FixedSystem<CostlySystem, 1, 1> {
+public:
+	CostlySystem(int cost = 0): cost(cost) {}
+
+	void FixedTick(const FixedObservation &observation, FixedAction &action);
+
+	void Restart() {}
+private:
+	//! Iterations per tick
+	int cost;
+};
+
+/**
+ * Every system has one state value, it moves with the action of the system. The reward is the sum
+ * over all actions, so it depends on every system.
+ */
+class SumEnvironment: public FixedEnvironment<SumEnvironment, 1, 1, 1> {
+public:
+	void FixedInit(std::vector<FixedObservation> &observations, std::vector<FixedState> &states);
+
+	void FixedTick(const std::vector<FixedAction> &actions, std::vector<FixedObservation> &observations,
+			std::vector<FixedState> &states);
+
+	void Restart() { Clear(); }
+};
+
+/**
+ * Counts how often its items are executed.
+ */
+class CountingJob: public WorkerJob {
+public:
+	CountingJob(): count(0) {}
+
+	void Execute(size_t i) { count.fetch_add(1); }
+
+	std::atomic<long int> count;
+};
+
+/**
+ * Measures ticks per second of an embodiment with serial and with parallel system ticks.
+ */
+class BenchmarkParallel {
+public:
+	//! Returns the number of runs of which the result differs from the serial run
+	int Run();
+
+	//! Returns the number of times a restarted pool executed a job more or less often than run
+	int Restarts();
+protected:
+	//! Run "nof_ticks" ticks and return the time in seconds, the discounted reward is the result
+	double Measure(size_t nof_systems, int cost, size_t nof_threads, long int nof_ticks,
+			AP_TYPE &result);
+};
+
+#endif /* BENCHMARKPARALLEL_H_ */
@@ -0,0 +1,147 @@
+/***************************************************************************************************
+ * @brief Throughput of stepping the environment alongside the systems, against one tick of delay
+ * @file BenchmarkPipeline.cpp
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#include <BenchmarkPipeline.h>
+#include <Embodiment.h>
+
+#include <iostream>
+#include <iomanip>
+#include <thread>
+#include <math.h>
+#include <sys/time.h>
+
+using namespace std;
+
+//! Number of systems in every run
+#define NOF_PIPELINE_SYSTEMS 8
+
+void PlanningSystem::FixedTick(const FixedObservation &observation, FixedAction &action) {
+	AP_TYPE x = 0.5 + 0.4 * sin(observation[0]);
+	for (int i = 0; i < cost; ++i) {
+		x = 3.9 * x * (1 - x);
+	}
+	action[0] = x - 0.5;
+}
+
+void DelayedSystem::FixedTick(const FixedObservation &observation, FixedAction &action) {
+	action = previous;
+	system.FixedTick(observation, previous);
+}
+
+void PhysicsEnvironment::FixedInit(std::vector<FixedObservation> &observations,
+		std::vector<FixedState> &states) {
+	for (size_t i = 0; i < states.size(); ++i) {
+		states[i][0] = i;
+		observations[i][0] = states[i][0];
+	}
+}
+
+void PhysicsEnvironment::FixedTick(const std::vector<FixedAction> &actions,
+		std::vector<FixedObservation> &observations, std::vector<FixedState> &states) {
+	instantaneous_reward = 0;
+	for (size_t i = 0; i < actions.size(); ++i) {
+		states[i][0] += actions[i][0];
+		AP_TYPE x = 0.5 + 0.4 * cos(states[i][0]);
+		for (int j = 0; j < cost; ++j) {
+			x = 3.9 * x * (1 - x);
+		}
+		observations[i][0] = states[i][0] + 0.01 * x;
+		instantaneous_reward += actions[i][0];
+	}
+	discounted_reward = instantaneous_reward + 0.9 * discounted_reward;
+}
+
+static double now() {
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+template<class SystemType>
+double BenchmarkPipeline::Measure(int system_cost, int environment_cost, bool pipelined,
+		long int nof_ticks, AP_TYPE &result) {
+	std::vector<SystemType> robots(NOF_PIPELINE_SYSTEMS, SystemType(system_cost));
+	AP_SYSTEMS systems;
+	for (size_t i = 0; i < robots.size(); ++i) {
+		systems.push_back(&robots[i]);
+	}
+	PhysicsEnvironment env(environment_cost);
+	Embodiment embodiment;
+	Coupling coupling;
+	embodiment.Couple(env, systems, coupling);
+	embodiment.SetPipelined(pipelined);
+	embodiment.Restart();
+	double start = now();
+	for (long int t = 0; t < nof_ticks; ++t) {
+		embodiment.Tick();
+	}
+	double duration = now() - start;
+	result = env.GetDiscountedReward();
+	return duration;
+}
+
+/**
+ * Sequential, a tick takes the time of the systems plus that of the environment. Pipelined, it
+ * takes the longest of both (plus the handoff), so the gain is largest when both are equally
+ * costly. The price is latency: an action reaches the environment one tick after the observation
+ * it is based on. The latency columns are the time from an observation till the environment has
+ * applied the action to it: one tick sequential, two pipelined. The pipelined result should be
+ * exactly that of systems that give their actions one tick late, stepped in order.
+ */
+int BenchmarkPipeline::Run() {
+	int failures = 0;
+	int costs[] = { 0, 100, 1000, 10000 };
+	cout << "Hardware threads: " << std::thread::hardware_concurrency() << endl;
+	cout << setw(8) << "system" << setw(8) << "physics" << setw(14) << "sequential" << setw(14)
+			<< "pipelined" << setw(10) << "speed-up" << setw(12) << "latency(us)" << setw(12)
+			<< "pipelined" << endl;
+	for (int s = 0; s < 4; ++s) {
+		for (int e = 0; e < 4; ++e) {
+			int system_cost = costs[s], environment_cost = costs[e];
+			long int nof_ticks = std::max<long int>(20000000 /
+					(NOF_PIPELINE_SYSTEMS * (system_cost + environment_cost + 40)), 10);
+			AP_TYPE sequential_result, delayed_result, pipelined_result;
+			double sequential = Measure<PlanningSystem>(system_cost, environment_cost, false,
+					nof_ticks, sequential_result);
+			double pipelined = Measure<PlanningSystem>(system_cost, environment_cost, true,
+					nof_ticks, pipelined_result);
+			Measure<DelayedSystem>(system_cost, environment_cost, false, nof_ticks, delayed_result);
+			cout << setw(8) << system_cost << setw(8) << environment_cost << setw(14)
+					<< (long int)(nof_ticks / sequential) << setw(14) << (long int)(nof_ticks / pipelined)
+					<< setw(10) << setprecision(3) << sequential / pipelined << setw(12)
+					<< 1e6 * sequential / nof_ticks << setw(12) << 2e6 * pipelined / nof_ticks << endl;
+			if (pipelined_result != delayed_result) {
+				cerr << "Pipelined result differs: " << pipelined_result << " instead of "
+						<< delayed_result << endl;
+				++failures;
+			}
+		}
+	}
+	return failures;
+}
+
+int main() {
+	BenchmarkPipeline benchmark;
+	int failures = benchmark.Run();
+	cout << (failures ? "FAILED" : "OK") << endl;
+	return failures;
+}
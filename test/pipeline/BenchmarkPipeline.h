@@ -0,0 +1,100 @@
+/***************************************************************************************************
+ * @brief Throughput of stepping the environment alongside the systems, against one tick of delay
+ * @file BenchmarkPipeline.h
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#ifndef BENCHMARKPIPELINE_H_
+#define BENCHMARKPIPELINE_H_
+
+#include <System.h>
+#include <Environment.h>
+
+#include <stddef.h>
+
+/**
+ * A system that "plans": it iterates a chaotic map a fixed number of times, starting from its
+ * observation, so its cost per tick can be set while the result stays deterministic.
+ */
+class PlanningSystem: public FixedSystem<PlanningSystem, 1, 1> {
+public:
+	PlanningSystem(int cost = 0): cost(cost) {}
+
+	void FixedTick(const FixedObservation &observation, FixedAction &action);
+
+	void Restart() {}
+private:
+	//! Iterations per tick
+	int cost;
+};
+
+/**
+ * The same system, but its action is the one of the previous tick (zero after a restart). Ticked
+ * in order, this is what a pipelined embodiment does with a planning system.
+ */
+class DelayedSystem: public FixedSystem<DelayedSystem, 1, 1> {
+public:
+	DelayedSystem(int cost = 0): system(cost) { Restart(); }
+
+	void FixedTick(const FixedObservation &observation, FixedAction &action);
+
+	void Restart() { previous[0] = 0; }
+private:
+	PlanningSystem system;
+
+	//! The action that is given at the next tick
+	FixedAction previous;
+};
+
+/**
+ * Every system has one state value, it moves with the action of the system. The "physics" costs
+ * a number of iterations per system, after which the observation is the state plus a bit of the
+ * result. The reward is the sum over all actions.
+ */
+class PhysicsEnvironment: public FixedEnvironment<PhysicsEnvironment, 1, 1, 1> {
+public:
+	PhysicsEnvironment(int cost = 0): cost(cost) {}
+
+	void FixedInit(std::vector<FixedObservation> &observations, std::vector<FixedState> &states);
+
+	void FixedTick(const std::vector<FixedAction> &actions, std::vector<FixedObservation> &observations,
+			std::vector<FixedState> &states);
+
+	void Restart() { Clear(); }
+private:
+	//! Iterations per system per tick
+	int cost;
+};
+
+/**
+ * Measures ticks per second of an embodiment that steps the environment after the systems and of
+ * one that steps it at the same time (with the actions one tick late).
+ */
+class BenchmarkPipeline {
+public:
+	//! Returns the number of pipelined runs of which the result differs from the delayed run
+	int Run();
+protected:
+	//! Run "nof_ticks" ticks and return the time in seconds, the discounted reward is the result
+	template<class SystemType>
+	double Measure(int system_cost, int environment_cost, bool pipelined, long int nof_ticks,
+			AP_TYPE &result);
+};
+
+#endif /* BENCHMARKPIPELINE_H_ */
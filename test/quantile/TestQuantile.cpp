@@ -0,0 +1,174 @@
+/***************************************************************************************************
+ * @brief Checks the quantile sketch and the equal-frequency bins learned by it
+ * @file TestQuantile.cpp
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#include <TestQuantile.h>
+#include <stdlib.h>
+#include <iostream>
+#include <algorithm>
+#include <vector>
+#include <math.h>
+
+#include <boost/random.hpp>
+
+using namespace std;
+using namespace boost;
+
+int TestQuantile::Test() {
+	int failures = 0;
+	failures += EqualFrequency();
+	failures += Quantiles();
+	failures += LopsidedMerge();
+	return failures;
+}
+
+/**
+ * The values are log-normal, so equal-width bins would put nearly all of them in the first bin.
+ * With equal-frequency bins every bin should get about the same number of values, also when the
+ * edges are learned from two shards that are merged.
+ */
+int TestQuantile::EqualFrequency() {
+	int N = 100000, nof_bins = 8;
+	mt19937 rng(11);
+	boost::random::lognormal_distribution<AP_TYPE> lognormal(0, 2);
+	std::vector<AP_TYPE> values(N);
+	for (int i = 0; i < N; ++i) {
+		values[i] = lognormal(rng);
+	}
+
+	Quantizer quantizer, shard;
+	quantizer.setNofBins(nof_bins);
+	quantizer.setMode(QM_EQUAL_FREQUENCY);
+	quantizer.setChannels(1);
+	shard.setNofBins(nof_bins);
+	shard.setMode(QM_EQUAL_FREQUENCY);
+	shard.setChannels(1);
+	quantizer.Learn(0, values.data(), N / 2);
+	shard.Learn(0, values.data() + N / 2, N - N / 2);
+	quantizer.Merge(shard);
+
+	std::vector<BIN_TYPE> bins(N);
+	quantizer.Quantize(0, values.data(), N, bins.data());
+	std::vector<int> counts(nof_bins, 0);
+	for (int i = 0; i < N; ++i) {
+		counts[bins[i]]++;
+	}
+	PROB_TYPE max_error = 0;
+	for (int k = 0; k < nof_bins; ++k) {
+		PROB_TYPE error = fabs(counts[k] / (PROB_TYPE)N - 1.0 / nof_bins);
+		max_error = (error > max_error) ? error : max_error;
+	}
+	cout << "Equal-frequency bins differ at most " << max_error << " from a fraction of "
+			<< 1.0 / nof_bins << endl;
+	return (max_error > 0.005);
+}
+
+/**
+ * The error of a quantile is measured as the fraction of values between the estimate and the true
+ * quantile. With a compression of 100 it should be well below 1%, and much smaller in the tails.
+ */
+int TestQuantile::Quantiles() {
+	int N = 100000;
+	mt19937 rng(5);
+	boost::random::normal_distribution<AP_TYPE> normal(0, 1);
+	std::vector<AP_TYPE> values(N);
+	for (int i = 0; i < N; ++i) {
+		values[i] = normal(rng);
+	}
+	QuantileSketch sketch, merged;
+	sketch.Add(values.data(), N);
+	for (int s = 0; s < 4; ++s) {
+		QuantileSketch shard;
+		shard.Add(values.data() + s * N / 4, N / 4);
+		merged.Merge(shard);
+	}
+	std::vector<AP_TYPE> sorted(values);
+	std::sort(sorted.begin(), sorted.end());
+
+	int failures = 0;
+	failures += (sketch.getCount() != N) + (merged.getCount() != N);
+	PROB_TYPE qs[] = { 0.001, 0.01, 0.1, 0.25, 0.5, 0.75, 0.9, 0.99, 0.999 };
+	PROB_TYPE max_error = 0, max_merged_error = 0;
+	for (int i = 0; i < 9; ++i) {
+		PROB_TYPE q = qs[i];
+		// the bound is tighter towards the tails, like the centroids
+		PROB_TYPE bound = 0.01 * 4 * q * (1 - q) + 0.0005;
+		QuantileSketch *sketches[] = { &sketch, &merged };
+		for (int j = 0; j < 2; ++j) {
+			AP_TYPE estimate = sketches[j]->Quantile(q);
+			PROB_TYPE rank = (std::lower_bound(sorted.begin(), sorted.end(), estimate) - sorted.begin())
+					/ (PROB_TYPE)N;
+			PROB_TYPE error = fabs(rank - q);
+			failures += (error > bound);
+			PROB_TYPE &max = j ? max_merged_error : max_error;
+			max = (error > max) ? error : max;
+		}
+	}
+	cout << "Largest error in the rank of a quantile " << max_error << ", after merging "
+			<< max_merged_error << " (" << sketch.getNofCentroids() << " and " << merged.getNofCentroids()
+			<< " centroids)" << endl;
+	return failures;
+}
+
+/**
+ * The large sketch has its centroids and a buffer of 450 values, so merging it into a sketch of 10
+ * values compresses halfway. The centroids should then be sized for the weight of both sketches.
+ */
+int TestQuantile::LopsidedMerge() {
+	int N = 100450;
+	mt19937 rng(9);
+	boost::random::uniform_real_distribution<AP_TYPE> uniform(0, 1);
+	std::vector<AP_TYPE> values(N + 10);
+	for (size_t i = 0; i < values.size(); ++i) {
+		values[i] = uniform(rng);
+	}
+	QuantileSketch small, large;
+	small.Add(values.data() + N, 10);
+	large.Add(values.data(), N);
+	small.Merge(large);
+	std::sort(values.begin(), values.end());
+
+	int failures = (small.getCount() != (AP_TYPE)values.size());
+	PROB_TYPE max_error = 0;
+	for (int i = 1; i < 100; ++i) {
+		PROB_TYPE q = i / 100.0;
+		AP_TYPE estimate = small.Quantile(q);
+		PROB_TYPE rank = (std::lower_bound(values.begin(), values.end(), estimate) - values.begin())
+				/ (PROB_TYPE)values.size();
+		PROB_TYPE error = fabs(rank - q);
+		failures += (error > 0.01 * 4 * q * (1 - q) + 0.0005);
+		max_error = (error > max_error) ? error : max_error;
+	}
+	cout << "Largest error in the rank of a quantile after a lopsided merge " << max_error << " ("
+			<< small.getNofCentroids() << " centroids)" << endl;
+	return failures;
+}
+
+int main() {
+	TestQuantile tq;
+	int failures = tq.Test();
+	if (failures) {
+		cout << "There are " << failures << " failures" << endl;
+		return EXIT_FAILURE;
+	}
+	cout << "All quantile checks passed" << endl;
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,48 @@
+/***************************************************************************************************
+ * @brief Checks the quantile sketch and the equal-frequency bins learned by it
+ * @file TestQuantile.h
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#ifndef TESTQUANTILE_H_
+#define TESTQUANTILE_H_
+
+#include <QuantileSketch.h>
+#include <Quantizer.h>
+
+/**
+ * Checks the ranks of the quantiles of the t-digest sketch, also after merging the sketches of
+ * shards, and that the equal-frequency bins learned by it get the same number of values each.
+ */
+class TestQuantile {
+public:
+	//! Returns the number of failed checks
+	int Test();
+protected:
+	//! Equal-frequency bins on heavy-tailed values
+	int EqualFrequency();
+
+	//! Quantiles of a sketch, and of sketches of shards merged together
+	int Quantiles();
+
+	//! A large sketch, with many values still buffered, merged into a small one
+	int LopsidedMerge();
+};
+
+#endif /* TESTQUANTILE_H_ */
@@ -0,0 +1,114 @@
+/***************************************************************************************************
+ * @brief Checks the binning of whole columns of values
+ * @file TestQuantizer.cpp
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#include <TestQuantizer.h>
+#include <stdlib.h>
+#include <iostream>
+#include <vector>
+#include <math.h>
+
+#include <boost/random.hpp>
+
+using namespace std;
+using namespace boost;
+
+int TestQuantizer::Test() {
+	int failures = 0;
+	failures += Bins();
+	failures += InvalidSettings();
+	return failures;
+}
+
+/**
+ * Values inside and outside the range and exactly on the edges, in columns that do not end on a
+ * whole vector, also with a stride.
+ */
+int TestQuantizer::Bins() {
+	mt19937 rng(3);
+	boost::random::uniform_real_distribution<AP_TYPE> uniform(-0.5, 1.5);
+	std::vector<AP_TYPE> values;
+	for (int i = 0; i < 10003; ++i) {
+		values.push_back(uniform(rng));
+	}
+	for (int k = 0; k <= 10; ++k) {
+		values.push_back(k / 10.0);
+	}
+
+	int failures = 0;
+	int nof_bins[] = { 10, 7, 300 };
+	for (int b = 0; b < 3; ++b) {
+		for (int mode = 0; mode < QM_COUNT; ++mode) {
+			Quantizer quantizer;
+			quantizer.setNofBins(nof_bins[b]);
+			quantizer.setMode((QuantizerMode)mode);
+			quantizer.setChannels(2);
+			if (mode == QM_EQUAL_FREQUENCY) {
+				quantizer.Learn(0, values.data(), values.size() / 2);
+			}
+			for (size_t stride = 1; stride <= 3; stride += 2) {
+				size_t size = values.size() / stride;
+				std::vector<BIN_TYPE> bins(size);
+				quantizer.Quantize(0, values.data(), size, bins.data(), stride);
+				for (size_t i = 0; i < size; ++i) {
+					failures += (bins[i] != quantizer.GetBin(0, values[i * stride]));
+				}
+			}
+		}
+	}
+	cout << "Bins of columns and of single values differ " << failures << " times" << endl;
+	return failures;
+}
+
+/**
+ * Every refused setting leaves the quantizer as it was, so the bins stay the same.
+ */
+int TestQuantizer::InvalidSettings() {
+	int failures = 0;
+	Quantizer quantizer, other;
+	quantizer.setChannels(2, -1, 1);
+	failures += quantizer.setNofBins(0) + quantizer.setNofBins(MAX_NOF_BINS + 1);
+	failures += (quantizer.getNofBins() != 10);
+	failures += quantizer.setChannels(-1) + quantizer.setChannels(3, 1, 0);
+	failures += quantizer.setRange(2, 0, 1) + quantizer.setRange(-1, 0, 1);
+	failures += quantizer.setRange(0, 1, 0) + quantizer.setRange(0, NAN, 1);
+	AP_TYPE nan = NAN;
+	failures += quantizer.Learn(2, &nan, 1) + quantizer.Learn(0, &nan, 1);
+	other.setChannels(3);
+	failures += quantizer.Merge(other);
+	failures += (quantizer.getNofChannels() != 2) + (quantizer.getMin(0) != -1);
+	failures += (quantizer.getMax(0) != 1) + (quantizer.GetBin(0, 0.05) != 5);
+	if (failures) {
+		cerr << "Invalid settings of the quantizer are not refused" << endl;
+	}
+	return failures;
+}
+
+int main() {
+	TestQuantizer tq;
+	int failures = tq.Test();
+	if (failures) {
+		cout << "There are " << failures << " failures" << endl;
+		return EXIT_FAILURE;
+	}
+	cout << "All quantizer checks passed" << endl;
+	return EXIT_SUCCESS;
+}
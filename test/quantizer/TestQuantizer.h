@@ -0,0 +1,44 @@
+/***************************************************************************************************
+ * @brief Checks the binning of whole columns of values
+ * @file TestQuantizer.h
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#ifndef TESTQUANTIZER_H_
+#define TESTQUANTIZER_H_
+
+#include <Quantizer.h>
+
+/**
+ * Checks that the vectorized binning of a column gives the same bins as binning its values one by
+ * one, for equal-width and equal-frequency bins, and that invalid settings are refused.
+ */
+class TestQuantizer {
+public:
+	//! Returns the number of failed checks
+	int Test();
+protected:
+	//! Vectorized bins against the bins of single values
+	int Bins();
+
+	//! Numbers of bins, ranges and channels that are refused
+	int InvalidSettings();
+};
+
+#endif /* TESTQUANTIZER_H_ */
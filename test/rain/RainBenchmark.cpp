@@ -27,20 +27,6 @@
 #include <stddef.h>
 #include <stdint.h>
 
-//! Use xorshift (wikipedia), or something else simple, but under control
-//! It would be nice to have just one seed necessary though.
-uint32_t xor128(void) {
-  static uint32_t x = 123456789;
-  static uint32_t y = 362436069;
-  static uint32_t z = 521288629;
-  static uint32_t w = 88675123;
-  uint32_t t;
-
-  t = x ^ (x << 11);
-  x = y; y = z; z = w;
-  return w = w ^ (w >> 19) ^ (t ^ (t >> 8));
-}
-
 
 RainBenchmark::RainBenchmark()
 {
@@ -62,6 +48,12 @@ void RainBenchmark::Tick(const Action &action, Observation &observation)
 	robot_position += (act > 0) ? 1 : world_size -1;
 	robot_position %= world_size;
 	sky->fall();
+	// every position at the top gets an energy drop with probability 1/8, a harmful one with 1/8
+	for (int x = 0; x < world_size; ++x)
+	{
+		uint32_t r = random.Bits() & 7;
+		sky->setDrop(x, (r < 2) ? (RAIN_TYPE)(r + 1) : 0);
+	}
 	for (int w = 0; w < whisker_count; ++w)
 	{
 		RAIN_TYPE drop = sky->firstDrop(w+robot_position-whisker_count/2, whisker_length);
@@ -96,6 +88,7 @@ void RainBenchmark::setWhiskerLength(int whiskerLength)
 void RainBenchmark::setRainDistribution(int seed)
 {
 	rain_seed = seed;
+	random.Seed(seed);
 }
 
 
@@ -28,6 +28,7 @@
 #include <vector>
 
 #include <Environment.h>
+#include <CounterRandom.h>
 #include <Sky.h>
 
 /*
@@ -66,6 +67,9 @@ private:
 
 	int rain_seed;
 
+	//! Simple, but under control, and with just one seed: the rain of this benchmark only
+	CounterRandom random;
+
 	Sky *sky;
 };
 
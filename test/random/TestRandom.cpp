@@ -0,0 +1,173 @@
+/***************************************************************************************************
+ * @brief Known answers, skipping ahead and independence of the counter-based random numbers
+ * @file TestRandom.cpp
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#include <TestRandom.h>
+#include <CounterRandom.h>
+#include <RandomStreams.h>
+
+#include <iostream>
+#include <vector>
+#include <stdlib.h>
+#include <math.h>
+#include <sys/time.h>
+
+using namespace std;
+
+static double now() {
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+int TestRandom::Test() {
+	int failures = 0;
+	failures += KnownAnswers();
+	failures += Skip();
+	failures += Streams();
+	failures += Uniformity();
+	return failures;
+}
+
+int TestRandom::KnownAnswers() {
+	int failures = 0;
+	uint32_t counters[3][4] = { { 0, 0, 0, 0 },
+			{ 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff },
+			{ 0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344 } };
+	uint32_t keys[3][2] = { { 0, 0 }, { 0xffffffff, 0xffffffff }, { 0xa4093822, 0x299f31d0 } };
+	uint32_t answers[3][4] = { { 0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8 },
+			{ 0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd },
+			{ 0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1 } };
+	for (int t = 0; t < 3; ++t) {
+		uint32_t *c = counters[t];
+		philox(c[0], c[1], c[2], c[3], keys[t][0], keys[t][1]);
+		for (int w = 0; w < 4; ++w) {
+			failures += (c[w] != answers[t][w]);
+		}
+	}
+	return failures;
+}
+
+int TestRandom::Skip() {
+	int failures = 0;
+	uint64_t skips[] = { 0, 1, 3, 4, 5, 1000, 12345 };
+	for (int s = 0; s < 7; ++s) {
+		CounterRandom drawn(42, 7, 3), skipped(42, 7, 3);
+		for (uint64_t i = 0; i < skips[s]; ++i) {
+			drawn.Bits();
+		}
+		skipped.Skip(skips[s]);
+		for (int i = 0; i < 10; ++i) {
+			failures += (drawn.Bits() != skipped.Bits());
+		}
+		// the same for the streams of a batch, after one draw to be in the middle of a block
+		RandomStreams batch_drawn(5, 42), batch_skipped(5, 42);
+		std::vector<uint32_t> a(5), b(5);
+		batch_drawn.Bits(&a[0]);
+		batch_skipped.Bits(&b[0]);
+		for (uint64_t i = 0; i < skips[s]; ++i) {
+			batch_drawn.Bits(&a[0]);
+		}
+		batch_skipped.Skip(skips[s]);
+		for (int i = 0; i < 10; ++i) {
+			batch_drawn.Bits(&a[0]);
+			batch_skipped.Bits(&b[0]);
+			failures += (a != b);
+		}
+	}
+	return failures;
+}
+
+/**
+ * Stream m of a batch is instance m of the same seed. The numbers of an instance are the same in
+ * a batch of 3 and one of 100. Stream 1 is reseeded halfway through a block, it continues at the
+ * same place in the block of its new stream.
+ */
+int TestRandom::Streams() {
+	int failures = 0;
+	RandomStreams small(3, 2012), large(100, 2012);
+	std::vector<CounterRandom> single;
+	for (uint32_t m = 0; m < 3; ++m) {
+		single.push_back(CounterRandom(2012, m));
+	}
+	std::vector<uint32_t> a(3), b(100);
+	for (int i = 0; i < 10; ++i) {
+		if (i == 6) {
+			small.Reseed(1, 99, 5);
+			large.Reseed(1, 99, 5);
+			single[1] = CounterRandom(99, 1, 5);
+			single[1].Skip(2);
+		}
+		small.Bits(&a[0]);
+		large.Bits(&b[0]);
+		for (int m = 0; m < 3; ++m) {
+			failures += (a[m] != b[m]) + (a[m] != single[m].Bits());
+		}
+	}
+	return failures;
+}
+
+/**
+ * The mean and the correlation of consecutive numbers of one stream, and the correlation of the
+ * first numbers of consecutive instances, for which a simple generator with consecutive seeds
+ * would fail.
+ */
+int TestRandom::Uniformity() {
+	int failures = 0;
+	const int n = 1 << 20;
+	CounterRandom random(1);
+	AP_TYPE sum = 0, product = 0, previous = random.Uniform();
+	double start = now();
+	for (int i = 0; i < n; ++i) {
+		AP_TYPE x = random.Uniform();
+		sum += x;
+		product += (x - 0.5) * (previous - 0.5);
+		previous = x;
+	}
+	double single = now() - start;
+	failures += (fabs(sum / n - 0.5) > 0.005) + (fabs(product / n) > 0.005);
+
+	RandomStreams streams(n, 1);
+	std::vector<AP_TYPE> x(n);
+	start = now();
+	streams.Uniform(&x[0]);
+	double batched = now() - start;
+	sum = product = 0;
+	for (int i = 1; i < n; ++i) {
+		sum += x[i];
+		product += (x[i] - 0.5) * (x[i - 1] - 0.5);
+	}
+	failures += (fabs(sum / n - 0.5) > 0.005) + (fabs(product / n) > 0.005);
+	cout << "One stream: " << single / n * 1e9 << " ns per number, a block of " << n
+			<< " streams: " << batched / n * 1e9 << " ns per stream" << endl;
+	return failures;
+}
+
+int main() {
+	TestRandom tr;
+	int failures = tr.Test();
+	if (failures) {
+		cout << "There are " << failures << " failures" << endl;
+		return EXIT_FAILURE;
+	}
+	cout << "All random number checks passed" << endl;
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,49 @@
+/***************************************************************************************************
+ * @brief Known answers, skipping ahead and independence of the counter-based random numbers
+ * @file TestRandom.h
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#ifndef TESTRANDOM_H_
+#define TESTRANDOM_H_
+
+/**
+ * Checks Philox against the known answers of its authors, and that the streams are reproducible:
+ * skipping ahead gives the same numbers as drawing, the batched streams give the same numbers as
+ * one generator per instance, and the numbers of an instance do not depend on the others.
+ */
+class TestRandom {
+public:
+	//! Returns the number of failed checks
+	int Test();
+protected:
+	//! Philox4x32-10 on the known answer tests of Random123
+	int KnownAnswers();
+
+	//! Skip ahead against drawing
+	int Skip();
+
+	//! Batched streams against a generator per instance, with a reseed in between
+	int Streams();
+
+	//! Rough checks on the distribution, and the time per number
+	int Uniformity();
+};
+
+#endif /* TESTRANDOM_H_ */
@@ -0,0 +1,89 @@
+/***************************************************************************************************
+ * @brief Policies for the recycling robots that follow from the Bellman equation
+ * @file RecyclingPlanner.cpp
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#include <RecyclingPlanner.h>
+
+#include <iostream>
+#include <limits>
+
+using namespace std;
+
+RecyclingPlanner::RecyclingPlanner() {
+	nof_robots = 0;
+	joint_value = value = 0;
+}
+
+size_t RecyclingPlanner::getStart() const {
+	size_t start = 0;
+	for (int i = 0; i < nof_robots; ++i) {
+		start = start * RRS_COUNT + RRS_BATTERY_HIGH;
+	}
+	return start;
+}
+
+/**
+ * A robot observes its battery level, so observation o corresponds to state o. The tables of all
+ * robots are counted through as one number, with the action of robot i for observation o as digit
+ * i * RRO_COUNT + o.
+ */
+bool RecyclingPlanner::Plan(const RecyclingRobotsBenchmark &benchmark, int nof_robots) {
+	if (nof_robots < 1 || nof_robots > MAX_JOINT_ROBOTS) {
+		cerr << "Planning is done for 1 to " << MAX_JOINT_ROBOTS << " robots, not for " << nof_robots
+				<< endl;
+		return false;
+	}
+	this->nof_robots = nof_robots;
+	if (!benchmark.GetJointTable(table, nof_robots)) return false;
+	solver.setDiscountFactor(benchmark.getDiscountFactor());
+	if (!solver.PolicyIteration(table)) return false;
+	joint_policy = solver.getPolicy();
+	joint_value = solver.getValues()[getStart()];
+
+	const size_t nof_digits = nof_robots * RRO_COUNT;
+	size_t nof_combinations = 1;
+	for (size_t d = 0; d < nof_digits; ++d) {
+		nof_combinations *= RRA_COUNT;
+	}
+	std::vector<RR_ACTION> candidate(nof_digits);
+	std::vector<uint32_t> policy(table.getNofStates());
+	std::vector<AP_TYPE> values;
+	value = -std::numeric_limits<AP_TYPE>::infinity();
+	for (size_t combination = 0; combination < nof_combinations; ++combination) {
+		for (size_t d = 0, c = combination; d < nof_digits; ++d, c /= RRA_COUNT) {
+			candidate[d] = (RR_ACTION)(c % RRA_COUNT);
+		}
+		for (size_t s = 0; s < policy.size(); ++s) {
+			size_t state = s, weight = 1;
+			policy[s] = 0;
+			for (int i = 0; i < nof_robots; ++i, state /= RRS_COUNT, weight *= RRA_COUNT) {
+				policy[s] += candidate[i * RRO_COUNT + state % RRS_COUNT] * weight;
+			}
+		}
+		solver.Evaluate(table, policy, values);
+		if (values[getStart()] > value + 1e-12) {
+			value = values[getStart()];
+			policies = candidate;
+			table_policy = policy;
+		}
+	}
+	return true;
+}
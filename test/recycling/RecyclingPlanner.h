@@ -0,0 +1,88 @@
+/***************************************************************************************************
+ * @brief Policies for the recycling robots that follow from the Bellman equation
+ * @file RecyclingPlanner.h
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#ifndef RECYCLINGPLANNER_H_
+#define RECYCLINGPLANNER_H_
+
+#include <MDPSolver.h>
+#include <RecyclingRobotsBenchmark.h>
+#include <RecyclingRobotsStructs.h>
+
+#include <vector>
+
+/**
+ * Solves the joint problem of the recycling robots, with the discount factor of the benchmark. The
+ * optimal joint policy picks the actions of all robots from the battery levels of all robots, but
+ * a robot only observes its own battery. So that policy is an upper bound, the value of a team
+ * that would share its observations. The policies the robots can execute are tables from their
+ * own observation to an action. All combinations of such tables are evaluated exactly on the
+ * joint problem, and the best one from the start (all batteries high) is kept.
+ */
+class RecyclingPlanner {
+public:
+	RecyclingPlanner();
+
+	//! Solve for a number of robots, there are (RRA_COUNT^RRO_COUNT)^n combinations of tables, so
+	//! returns false for more than MAX_JOINT_ROBOTS robots
+	bool Plan(const RecyclingRobotsBenchmark &benchmark, int nof_robots = NOF_SYSTEMS);
+
+	//! The expected discounted reward of the optimal joint policy from the start
+	inline AP_TYPE getJointValue() const { return joint_value; }
+
+	//! Per joint state the joint action, see RecyclingRobotsBenchmark::GetJointTable
+	inline const std::vector<uint32_t> & getJointPolicy() const { return joint_policy; }
+
+	//! The expected discounted reward of the best tables from the start
+	inline AP_TYPE getValue() const { return value; }
+
+	//! The table of a robot, to be given to RecyclingRobot::SetPolicy
+	inline const RR_ACTION * getPolicy(int robot) const { return &policies[robot * RRO_COUNT]; }
+
+	//! The tables of all robots as a joint policy, per joint state the joint action
+	inline const std::vector<uint32_t> & getTablePolicy() const { return table_policy; }
+
+	//! The joint state in which all robots have a high battery level
+	size_t getStart() const;
+
+	inline MDPSolver & getSolver() { return solver; }
+
+	inline const TransitionTable & getTable() const { return table; }
+private:
+	int nof_robots;
+
+	TransitionTable table;
+
+	MDPSolver solver;
+
+	AP_TYPE joint_value;
+
+	std::vector<uint32_t> joint_policy;
+
+	AP_TYPE value;
+
+	//! The table of every robot, one after the other
+	std::vector<RR_ACTION> policies;
+
+	std::vector<uint32_t> table_policy;
+};
+
+#endif /* RECYCLINGPLANNER_H_ */
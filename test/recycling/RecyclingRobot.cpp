@@ -36,6 +36,7 @@ RecyclingRobot::RecyclingRobot(std::string name) {
 	verbosity = LOG_INFO;
 	prev_act = RRA_SEARCH_BIG;
 	prev_rew = 0;
+	SetPolicy(NULL);
 }
 
 RecyclingRobot::~RecyclingRobot() {
@@ -49,6 +50,13 @@ void RecyclingRobot::Restart() {
 	prev_rew = 0;
 }
 
+void RecyclingRobot::SetPolicy(const RR_ACTION *policy) {
+	planned = (policy != NULL);
+	for (int o = 0; o < RRO_COUNT; ++o) {
+		this->policy[o] = planned ? policy[o] : RRA_SEARCH_BIG;
+	}
+}
+
 /**
  * Which action to execute given a certain local observation. That's the problem a robot encounters
  * in a DEC-POMDP problem.
@@ -68,26 +76,20 @@ void RecyclingRobot::Restart() {
  * We will also call StateActionAlgorithm::explore which should return a new action for us (this
  * will be returned in the given Action* parameter).
  */
-void RecyclingRobot::Tick(const Observation& observation, Action& action) {
-	assert (observation.size() <= 2);
-	assert (action.empty());
-
-	if (observation.size() < 1) {
-		cerr << "No observation or no reward!" << endl;
-		action.clear();
-		action.push_back(RRA_RECHARGE);
-		return;
-	}
+void RecyclingRobot::DiscreteTick(const SymbolObservation& observation, AP_TYPE reward,
+		SymbolAction& action) {
 	RR_OBSERVATION obs = (RR_OBSERVATION)observation[RROT_BATTERY_LEVEL];
 
-	RR_OBSERVATION reward = (RR_OBSERVATION)observation[RROT_INSTANTANEOUS_REWARD];
-
 	if (verbosity >= LOG_DEBUG)
 		cout << name << ": observation = " << RR_OBSERVATION_STR[obs] << endl;
-	action.clear();
 
-	// This function should actually be replaced by a real function using Bellman recursion etc.
-	ManualTweaking(obs, reward, action);
+	if (planned) {
+		action[RRAT_SEARCHING] = policy[obs];
+		prev_rew = reward;
+		prev_act = policy[obs];
+	} else {
+		ManualTweaking(obs, reward, action);
+	}
 
 	if (verbosity >= LOG_DEBUG) {
 		cout << name << ": action = " << RR_ACTION_STR[prev_act] << endl;
@@ -109,30 +111,14 @@ void RecyclingRobot::Tick(const Observation& observation, Action& action) {
  * a reward history of [ 4 5 .. .. ] with most recent first, means that a SEARCH_BIG action was followed by a SEARCH_SMALL and
  * both were successful... there is now a
  */
-void RecyclingRobot::ManualTweaking(const RR_OBSERVATION & obs, const RR_OBSERVATION reward, Action& action) {
-	switch(obs) {
-	case RRO_BATTERY_HIGH:
-		if (reward <= 0) { // after both recharged, it's safe to search for BIG
-			action.push_back(RRA_SEARCH_BIG);
+void RecyclingRobot::ManualTweaking(const RR_OBSERVATION & obs, const AP_TYPE reward, SymbolAction& action) {
+	// after both recharged (reward 0), it's safe to search for BIG
 #ifdef TRY_TO_USE_HISTORY
-		} else 	if ((reward == 4) && prev_rew == 5) {
-			action.push_back(RRA_SEARCH_BIG);
+	if ((reward == 4) && prev_rew == 5)
+		action[RRAT_SEARCHING] = RRA_SEARCH_BIG;
+	else
 #endif
-		} else {
-			action.push_back(RRA_SEARCH_SMALL);
-		}
-		break;
-	case RRO_BATTERY_LOW:
-#ifdef TRY_TO_USE_HISTORY
-		if ((reward == 4) && prev_rew == 5)
-			action.push_back(RRA_SEARCH_BIG);
-		else
-#endif
-			action.push_back(RRA_RECHARGE);
-		break;
-	default:
-		break;
-	}
+		action[RRAT_SEARCHING] = ManualAction(obs, reward);
 
 	// in case we want to use the action at t-1
 	prev_rew = reward;
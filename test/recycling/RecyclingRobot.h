@@ -29,10 +29,10 @@
 #include <RecyclingRobotsStructs.h>
 
 /**
- * The recycling robot should adapt itself to the observations (including reward) that it receives
- * and come up with a proper action that optimizes reward over the long-term.
+ * The recycling robot should adapt itself to the observations and reward that it receives and come
+ * up with a proper action that optimizes reward over the long-term.
  */
-class RecyclingRobot: public System {
+class RecyclingRobot: public DiscreteSystem<RecyclingRobot, RR_SYMBOL, RROT_COUNT, RRAT_COUNT> {
 public:
 	//! Give the robot a nice name
 	RecyclingRobot(std::string name);
@@ -40,18 +40,29 @@ public:
 	//! Kill it
 	~RecyclingRobot();
 
-	//! Main function to call, this will return an action given the observation (including reward)
-	void Tick(const Observation &observation, Action &action);
+	//! Main function to call, this will return an action given the observation and reward
+	void DiscreteTick(const SymbolObservation &observation, AP_TYPE reward, SymbolAction &action);
 
 	//! The robot can be restarted by the experimenter
 	void Restart();
 
 	//! Make it scream
 	inline void SetVerbosity(char verbosity) { this->verbosity = verbosity; }
+
+	//! The manual rules without history: with a high battery level search for a big item if the
+	//! last reward was not positive, else for a small one, and recharge otherwise
+	static inline RR_ACTION ManualAction(RR_OBSERVATION observation, AP_TYPE reward) {
+		if (observation != RRO_BATTERY_HIGH) return RRA_RECHARGE;
+		return (reward <= 0) ? RRA_SEARCH_BIG : RRA_SEARCH_SMALL;
+	}
+
+	//! Look up the action per observation (RRO_COUNT of them) instead of the manual rules, NULL to
+	//! use the rules again, see RecyclingPlanner for a policy that follows from the Bellman equation
+	void SetPolicy(const RR_ACTION *policy);
 protected:
 	//! Manual definition of action to check if their are no simple policies that can easily be
 	//! discovered
-	void ManualTweaking(const RR_OBSERVATION & obs, const RR_OBSERVATION reward, Action& action);
+	void ManualTweaking(const RR_OBSERVATION & obs, const AP_TYPE reward, SymbolAction& action);
 private:
 	std::string name;
 
@@ -60,6 +71,12 @@ private:
 	AP_TYPE prev_rew;
 
 	char verbosity;
+
+	//! If the policy is used
+	bool planned;
+
+	//! Action per observation
+	RR_ACTION policy[RRO_COUNT];
 };
 
 
@@ -0,0 +1,176 @@
+/***************************************************************************************************
+ * @brief Many instances of the recycling robots problem in structure-of-arrays form
+ * @file RecyclingRobotsBatch.cpp
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#include <RecyclingRobotsBatch.h>
+#include <RecyclingRobot.h>
+
+#include <algorithm>
+#include <assert.h>
+
+RecyclingRobotsBatch::RecyclingRobotsBatch() {
+	setBenchmark(RecyclingRobotsBenchmark());
+	seed = 38;
+	horizon = 100000;
+}
+
+RecyclingRobotsBatch::~RecyclingRobotsBatch() {
+}
+
+void RecyclingRobotsBatch::setBenchmark(const RecyclingRobotsBenchmark &benchmark) {
+	for (int s = 0; s < RRS_COUNT; ++s) {
+		for (int a = 0; a < RRA_COUNT; ++a) {
+			int index = s * RRA_COUNT + a;
+			thresholds[index] = benchmark.getHighThreshold(s, a);
+			for (int next = 0; next < RRS_COUNT; ++next) {
+				outcome_rewards[index * RRS_COUNT + next] = benchmark.getReward(s, a, next);
+				depleting[index * RRS_COUNT + next] = benchmark.isDepleting(s, a, next);
+				finding_big[index * RRS_COUNT + next] = benchmark.isFindingBig(s, a, next);
+			}
+		}
+	}
+	big_reward = benchmark.getBigReward();
+	discount_factor = benchmark.getDiscountFactor();
+}
+
+void RecyclingRobotsBatch::Init(size_t nof_instances, std::vector<Batch<RR_SYMBOL> > &observations) {
+	states.resize(nof_instances, observations.size());
+	random.Seed(nof_instances, seed);
+	draws.assign(nof_instances, 0);
+	instantaneous_rewards.assign(nof_instances, 0);
+	big_counts.assign(nof_instances, 0);
+	episode_times.assign(nof_instances, 0);
+	discounted_rewards.assign(nof_instances, 0);
+	discounted_reward_sums.assign(nof_instances, 0);
+	accumulated_rewards.assign(nof_instances, 0);
+	depletion_counts.assign(nof_instances, 0);
+	episode_counts.assign(nof_instances, 0);
+	for (size_t m = 0; m < nof_instances; ++m) {
+		Reset(m, observations);
+	}
+}
+
+void RecyclingRobotsBatch::Reset(size_t m, std::vector<Batch<RR_SYMBOL> > &observations) {
+	for (size_t i = 0; i < observations.size(); ++i) {
+		states(m, i) = RRS_BATTERY_HIGH;
+		observations[i](m, RROT_BATTERY_LEVEL) = RRS_BATTERY_HIGH;
+	}
+	episode_times[m] = 0;
+	discounted_rewards[m] = 0;
+}
+
+/**
+ * One robot in all instances. The next battery level is high if the draw is below the threshold of
+ * the battery level and action, like for the packed robots of the benchmark; a depleted robot is
+ * brought back with a high level. The reward and whether the robot was depleted or found a big item
+ * are looked up per outcome. The outcomes are random, so branches on them would be mispredicted
+ * half of the time, the lookups are not.
+ */
+static void StepRobot(const RR_SYMBOL *RESTRICT action, RR_SYMBOL *RESTRICT battery,
+		const uint32_t *RESTRICT draw, const uint64_t *threshold, const AP_TYPE *outcome_reward,
+		const int *depleting, const int *finding_big, AP_TYPE *RESTRICT reward,
+		int *RESTRICT big_count, int *RESTRICT depletions, size_t nof_instances) {
+	for (size_t m = 0; m < nof_instances; ++m) {
+		int index = battery[m] * RRA_COUNT + action[m];
+		int next = ((uint64_t)draw[m] < threshold[index]) ? RRS_BATTERY_HIGH : RRS_BATTERY_LOW;
+		int outcome = index * RRS_COUNT + next;
+		battery[m] = next;
+		reward[m] += outcome_reward[outcome];
+		big_count[m] += finding_big[outcome];
+		depletions[m] += depleting[outcome];
+	}
+}
+
+/**
+ * The bonus if all robots found a big item, and the bookkeeping per instance.
+ */
+static void AddRewards(int nof_robots, AP_TYPE *RESTRICT reward, const int *RESTRICT big_count,
+		AP_TYPE big_reward, AP_TYPE discount_factor, AP_TYPE *RESTRICT accumulated, AP_TYPE *RESTRICT discounted,
+		AP_TYPE *RESTRICT sums, int *RESTRICT times, int horizon, uint8_t *RESTRICT done,
+		size_t nof_instances) {
+	for (size_t m = 0; m < nof_instances; ++m) {
+		reward[m] += big_reward * (big_count[m] == nof_robots);
+		accumulated[m] += reward[m];
+		discounted[m] = reward[m] + discounted[m] * discount_factor;
+		sums[m] += discounted[m];
+		done[m] = (++times[m] >= horizon);
+	}
+}
+
+static void Export(const RR_SYMBOL *RESTRICT battery, const AP_TYPE *RESTRICT reward,
+		RR_SYMBOL *RESTRICT observation, AP_TYPE *RESTRICT robot_reward, size_t nof_instances) {
+	for (size_t m = 0; m < nof_instances; ++m) {
+		observation[m] = battery[m];
+		robot_reward[m] = reward[m];
+	}
+}
+
+/**
+ * Per robot and instance one number is drawn, also when recharging, so every instance consumes its
+ * stream at the same pace.
+ */
+void RecyclingRobotsBatch::Tick(const std::vector<Batch<RR_SYMBOL> > &actions,
+		std::vector<Batch<RR_SYMBOL> > &observations, Batch<AP_TYPE> &rewards, uint8_t *done) {
+	const size_t nof_instances = states.size();
+	const size_t nof_robots = actions.size();
+	assert (rewards.size() == nof_instances && rewards.getNofChannels() == nof_robots);
+	std::fill(instantaneous_rewards.begin(), instantaneous_rewards.end(), 0);
+	std::fill(big_counts.begin(), big_counts.end(), 0);
+
+	for (size_t i = 0; i < nof_robots; ++i) {
+		random.Bits(&draws[0]);
+		StepRobot(actions[i].channel(RRAT_SEARCHING), states.channel(i), &draws[0], thresholds,
+				outcome_rewards, depleting, finding_big, &instantaneous_rewards[0], &big_counts[0],
+				&depletion_counts[0], nof_instances);
+	}
+
+	AddRewards(nof_robots, &instantaneous_rewards[0], &big_counts[0], big_reward, discount_factor,
+			&accumulated_rewards[0], &discounted_rewards[0], &discounted_reward_sums[0],
+			&episode_times[0], horizon, done, nof_instances);
+
+	for (size_t i = 0; i < nof_robots; ++i) {
+		Export(states.channel(i), &instantaneous_rewards[0],
+				observations[i].channel(RROT_BATTERY_LEVEL), rewards.channel(i), nof_instances);
+	}
+
+	// a new episode starts without reward
+	for (size_t m = 0; m < nof_instances; ++m) {
+		if (!done[m]) continue;
+		Reset(m, observations);
+		++episode_counts[m];
+		for (size_t i = 0; i < nof_robots; ++i) {
+			rewards(m, i) = 0;
+		}
+	}
+}
+
+static void Act(const RR_SYMBOL *RESTRICT battery, const AP_TYPE *RESTRICT reward,
+		RR_SYMBOL *RESTRICT action, size_t nof_instances) {
+	for (size_t m = 0; m < nof_instances; ++m) {
+		action[m] = RecyclingRobot::ManualAction((RR_OBSERVATION)battery[m], reward[m]);
+	}
+}
+
+void RecyclingRobotBatch::Tick(const Batch<RR_SYMBOL> &observations, const AP_TYPE *rewards,
+		const uint8_t *done, Batch<RR_SYMBOL> &actions) {
+	Act(observations.channel(RROT_BATTERY_LEVEL), rewards, actions.channel(RRAT_SEARCHING),
+			observations.size());
+}
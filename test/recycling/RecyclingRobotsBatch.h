@@ -0,0 +1,135 @@
+/***************************************************************************************************
+ * @brief Many instances of the recycling robots problem in structure-of-arrays form
+ * @file RecyclingRobotsBatch.h
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#ifndef RECYCLINGROBOTSBATCH_H_
+#define RECYCLINGROBOTSBATCH_H_
+
+#include <BatchEmbodiment.h>
+#include <RandomStreams.h>
+#include <RecyclingRobotsStructs.h>
+#include <RecyclingRobotsBenchmark.h>
+
+/**
+ * The recycling robots problem of RecyclingRobotsBenchmark, for M instances at once. The chances and
+ * rewards are those of a benchmark, taken from the same tables as its packed robots use. The battery
+ * levels are stored robot after robot, per robot a byte for every instance. A tick is a loop over
+ * the instances per robot, without branches on the actions or states, followed by a loop over the
+ * instances for the (shared) reward. Every instance has its own random stream, of which the bits
+ * are compared with integer thresholds.
+ *
+ * An episode lasts "horizon" ticks, after which the instance is reset to high battery levels.
+ */
+class RecyclingRobotsBatch: public BatchEnvironment<RR_SYMBOL> {
+public:
+	//! With the tables of a default benchmark
+	RecyclingRobotsBatch();
+
+	~RecyclingRobotsBatch();
+
+	//! Take the chances, rewards and discount factor of a benchmark, used from the next tick on
+	void setBenchmark(const RecyclingRobotsBenchmark &benchmark);
+
+	inline size_t getObservationSize() const { return RROT_COUNT; }
+
+	inline size_t getActionSize() const { return RRAT_COUNT; }
+
+	void Init(size_t nof_instances, std::vector<Batch<RR_SYMBOL> > &observations);
+
+	void Tick(const std::vector<Batch<RR_SYMBOL> > &actions,
+			std::vector<Batch<RR_SYMBOL> > &observations, Batch<AP_TYPE> &rewards, uint8_t *done);
+
+	//! Seed for the random streams, instance m draws from stream m, used at the next Init
+	inline void SetSeed(uint32_t seed) { this->seed = seed; }
+
+	//! Number of ticks per episode
+	inline void setHorizon(int horizon) { this->horizon = horizon; }
+
+	//! Per instance the discounted reward in the current episode
+	inline const AP_TYPE * getDiscountedRewards() const { return &discounted_rewards[0]; }
+
+	//! Per instance the sum of the discounted reward over all ticks, of all episodes
+	inline const AP_TYPE * getDiscountedRewardSums() const { return &discounted_reward_sums[0]; }
+
+	//! Per instance the total reward, of all episodes
+	inline const AP_TYPE * getAccumulatedRewards() const { return &accumulated_rewards[0]; }
+
+	//! Per instance the number of times a robot has been totally depleted
+	inline const int * getDepletionCounts() const { return &depletion_counts[0]; }
+
+	//! Per instance the number of finished episodes
+	inline const int * getEpisodeCounts() const { return &episode_counts[0]; }
+protected:
+	//! Start a new episode in instance m
+	void Reset(size_t m, std::vector<Batch<RR_SYMBOL> > &observations);
+private:
+	//! Per battery level and action, indexed by battery * RRA_COUNT + action, 32 random bits are
+	//! below this with the chance on a high level
+	uint64_t thresholds[RRS_COUNT * RRA_COUNT];
+
+	//! Per outcome, indexed by (battery * RRA_COUNT + action) * RRS_COUNT + next level, the reward
+	//! of the robot, and if it got depleted or found a big item
+	AP_TYPE outcome_rewards[RRS_COUNT * RRA_COUNT * RRS_COUNT];
+	int depleting[RRS_COUNT * RRA_COUNT * RRS_COUNT];
+	int finding_big[RRS_COUNT * RRA_COUNT * RRS_COUNT];
+
+	//! The bonus if all robots found a big item
+	AP_TYPE big_reward;
+
+	AP_TYPE discount_factor;
+
+	uint32_t seed;
+
+	int horizon;
+
+	//! Battery level, a channel per robot
+	Batch<RR_SYMBOL> states;
+
+	RandomStreams random;
+
+	//! One draw per instance
+	std::vector<uint32_t> draws;
+
+	//! Per instance, reset every tick
+	std::vector<AP_TYPE> instantaneous_rewards;
+	std::vector<int> big_counts;
+
+	//! Per instance
+	std::vector<int> episode_times;
+	std::vector<AP_TYPE> discounted_rewards;
+	std::vector<AP_TYPE> discounted_reward_sums;
+	std::vector<AP_TYPE> accumulated_rewards;
+	std::vector<int> depletion_counts;
+	std::vector<int> episode_counts;
+};
+
+/**
+ * The policy of RecyclingRobot (without history) for all instances, see RecyclingRobot::ManualAction.
+ */
+class RecyclingRobotBatch: public BatchSystem<RR_SYMBOL> {
+public:
+	void Tick(const Batch<RR_SYMBOL> &observations, const AP_TYPE *rewards, const uint8_t *done,
+			Batch<RR_SYMBOL> &actions);
+
+	void Restart(size_t nof_instances) {}
+};
+
+#endif /* RECYCLINGROBOTSBATCH_H_ */
@@ -23,6 +23,7 @@
 #include <RecyclingRobotsBenchmark.h>
 #include <RecyclingRobotsStructs.h>
 
+#include <algorithm>
 #include <assert.h>
 #include <iostream>
 #include <stdlib.h>
@@ -50,9 +51,14 @@ RecyclingRobotsBenchmark::RecyclingRobotsBenchmark() {
 	// reward over time, namely 1/(1-d)*r_max (with d=0.9, r_max=5 it is 50).
 	discount_factor = 0.9;
 
+	small_reward = 2;
+	big_reward = 5;
+	depletion_reward = -10;
+	BuildTables();
+
 	depletion_count = 0;
-	int seed = 38;
-	srand48(seed);
+	nof_packed = 0;
+	SetSeed(38);
 }
 
 /**
@@ -61,164 +67,230 @@ RecyclingRobotsBenchmark::RecyclingRobotsBenchmark() {
 RecyclingRobotsBenchmark::~RecyclingRobotsBenchmark() {}
 
 
-void RecyclingRobotsBenchmark::SetSeed(int seed) {
+void RecyclingRobotsBenchmark::SetSeed(int seed, int instance) {
 	this->seed = seed;
-	srand48(seed);
+	this->instance = instance;
+	random.Seed(seed, instance);
 //	generator.seed(seed);
 }
 
 void RecyclingRobotsBenchmark::Restart() {
 	Clear();
 	depletion_count = 0;
-	SetSeed(seed);
+	SetSeed(seed, instance);
 }
 
-void RecyclingRobotsBenchmark::Init(AP_MAS_OBSERVATION& observations, AP_MAS_STATE& states) {
-	for (int i = 0; i < NOF_SYSTEMS; ++i) {
-		State &state = *states[i];
-		state.clear();
-		state.push_back(RRS_BATTERY_HIGH);
+void RecyclingRobotsBenchmark::DiscreteInit(std::vector<SymbolObservation> &observations,
+		std::vector<SymbolState> &states) {
+	for (size_t i = 0; i < states.size(); ++i) {
+		states[i][RRST_BATTERY_LEVEL] = RRS_BATTERY_HIGH;
 	}
 
 	// make from states observations
-	for (int i = 0; i < NOF_SYSTEMS; ++i) {
-		State *state = states[i];
-		if (state->empty()) {
-			cout << "State is empty, cannot be used as observation input!" << endl;
-			continue;
-		}
-		observations[i]->clear();
-		observations[i]->push_back(state->front());
-		observations[i]->push_back(instantaneous_reward);
+	for (size_t i = 0; i < observations.size(); ++i) {
+		observations[i][RROT_BATTERY_LEVEL] = states[i][RRST_BATTERY_LEVEL];
 	}
 }
 
 /**
- * Only implementation for 2 actors for now.
+ * From a high battery level a search keeps it high with chance alpha, else it gets low. From a low
+ * level a search depletes the battery with chance beta, after which the robot is brought back with a
+ * high level, else it stays low. Recharging always gives a high level. A search for a small item
+ * that does not end in depletion is rewarded directly, a big item only if all robots find one.
  */
-void RecyclingRobotsBenchmark::Tick(const AP_MAS_ACTION& actions,
-		AP_MAS_OBSERVATION& observations, AP_MAS_STATE& states) {
-	assert (actions.size() == NOF_SYSTEMS);
-	assert (observations.size() == NOF_SYSTEMS);
-	assert (states.size() == NOF_SYSTEMS);
-	int nr_bots = actions.size();
-
-	bool depleted[nr_bots];
-	for (int i = 0; i < nr_bots; ++i) {
-		depleted[i] = false;
+void RecyclingRobotsBenchmark::BuildTables() {
+	for (int s = 0; s < RRS_COUNT; ++s) {
+		for (int a = 0; a < RRA_COUNT; ++a) {
+			for (int next = 0; next < RRS_COUNT; ++next) {
+				bool search = (a != RRA_RECHARGE);
+				depleting[s][a][next] = search && s == RRS_BATTERY_LOW && next == RRS_BATTERY_HIGH;
+				finding_big[s][a][next] = (a == RRA_SEARCH_BIG) && !depleting[s][a][next];
+			}
+		}
 	}
 
-	// please, observe that the state of the robots are considered independent, although the MAS
-	// setting rewards cooperation between robots, it does not reward it in the sense that in the
-	// case that both robots try to lift a can, it does cost less energy
-	for (int i = 0; i < nr_bots; ++i) {
-		Action &action = *actions[i];
-		State &state = *states[i];
+	table.Resize(RRS_COUNT, RRA_COUNT);
+	AP_TYPE alpha[] = { alphaBig, alphaSmall }, beta[] = { betaBig, betaSmall };
+	AP_TYPE reward[] = { 0, small_reward };
+	for (int a = RRA_SEARCH_BIG; a <= RRA_SEARCH_SMALL; ++a) {
+		table.Add(RRS_BATTERY_HIGH, a, RRS_BATTERY_HIGH, alpha[a], reward[a]);
+		table.Add(RRS_BATTERY_HIGH, a, RRS_BATTERY_LOW, 1 - alpha[a], reward[a]);
+		table.Add(RRS_BATTERY_LOW, a, RRS_BATTERY_HIGH, beta[a], depletion_reward);
+		table.Add(RRS_BATTERY_LOW, a, RRS_BATTERY_LOW, 1 - beta[a], reward[a]);
+	}
+	table.Add(RRS_BATTERY_HIGH, RRA_RECHARGE, RRS_BATTERY_HIGH, 1, 0);
+	table.Add(RRS_BATTERY_LOW, RRA_RECHARGE, RRS_BATTERY_HIGH, 1, 0);
+	if (!table.Prepare()) {
+		cerr << "The probabilities of the recycling robots do not form a transition table" << endl;
+	}
 
-		if (action.empty()) {
-			cerr << "No action coming from robot " << i << endl;
-			continue;
-		}
-		if (state.empty()) {
-			cerr << "No state, did you call Init() for the first state initialisation?" << endl;
-			continue;
+	// for the packed robots, every next level occurs once in a row
+	for (int s = 0; s < RRS_COUNT; ++s) {
+		for (int a = 0; a < RRA_COUNT; ++a) {
+			PROB_TYPE high = 0;
+			for (int next = 0; next < RRS_COUNT; ++next) {
+				rewards[s][a][next] = 0;
+			}
+			for (const Transition *t = table.begin(s, a); t != table.end(s, a); ++t) {
+				rewards[s][a][t->next] = t->reward;
+				if (t->next == RRS_BATTERY_HIGH) high += t->probability;
+			}
+			high_thresholds[s][a] = (uint64_t)(high * 4294967296.0 + 0.5);
 		}
+	}
+}
 
-		switch ((RR_ACTION)action[RRAT_SEARCHING]) {
-		case RRA_SEARCH_BIG: {
-			if ((RR_STATE)state[RRST_BATTERY_LEVEL] == RRS_BATTERY_HIGH) {
-				if (drand48() < alphaBig) {
-					state[RRST_BATTERY_LEVEL] = RRS_BATTERY_HIGH; // same state
-				} else {
-					if (verbosity >= LOG_DEBUG)	cout << "to robot " << i << ": You're unlucky, battery is discharged for large part" << endl;
-					state[RRST_BATTERY_LEVEL] = RRS_BATTERY_LOW;
-				}
-			} else { // battery low
-				if (drand48() < betaBig) { // by default 3 upon 10 times we get really depleted
-					depleted[i] = true;
-					if (verbosity >= LOG_DEBUG) cout << "to robot " << i << ": Depleted, reset to high battery level" << endl;
-					state[RRST_BATTERY_LEVEL] = RRS_BATTERY_HIGH; // depleted, so reset
-				} else {
-					state[RRST_BATTERY_LEVEL] = RRS_BATTERY_LOW;
-				}
+/**
+ * The outcomes of all robots are enumerated for every joint state and action, like an odometer.
+ * There are RRS_COUNT^n states, RRA_COUNT^n actions and up to 2^n outcomes for each of them, so this
+ * is only feasible for a few robots: with 8 robots it would already be 4.3e8 transitions.
+ */
+bool RecyclingRobotsBenchmark::GetJointTable(TransitionTable &joint, int nof_robots) const {
+	if (nof_robots < 1 || nof_robots > MAX_JOINT_ROBOTS) {
+		cerr << "The joint table is generated for 1 to " << MAX_JOINT_ROBOTS << " robots, not for "
+				<< nof_robots << endl;
+		return false;
+	}
+	size_t nof_states = 1, nof_actions = 1;
+	for (int i = 0; i < nof_robots; ++i) {
+		nof_states *= RRS_COUNT;
+		nof_actions *= RRA_COUNT;
+	}
+	joint.Resize(nof_states, nof_actions);
+	std::vector<int> state(nof_robots), action(nof_robots);
+	std::vector<const Transition*> outcome(nof_robots);
+	for (size_t joint_state = 0; joint_state < nof_states; ++joint_state) {
+		for (size_t joint_action = 0; joint_action < nof_actions; ++joint_action) {
+			for (int i = 0, s = joint_state, a = joint_action; i < nof_robots; ++i) {
+				state[i] = s % RRS_COUNT;
+				action[i] = a % RRA_COUNT;
+				s /= RRS_COUNT;
+				a /= RRA_COUNT;
+				outcome[i] = table.begin(state[i], action[i]);
 			}
-			break;
-		}
-		case RRA_SEARCH_SMALL: {
-			if ((RR_STATE)state[RRST_BATTERY_LEVEL] == RRS_BATTERY_HIGH) {
-				if (drand48() <= alphaSmall) {
-					state[RRST_BATTERY_LEVEL] = RRS_BATTERY_HIGH; // same state
-				} else {
-					if (verbosity >= LOG_DEBUG) cout << "to robot " << i << ": You're unlucky, battery is discharged for large part (even though you searched for small item)" << endl;
-					state[RRST_BATTERY_LEVEL] = RRS_BATTERY_LOW;
+			for (int carry = 0; carry < nof_robots; ) {
+				PROB_TYPE probability = 1;
+				AP_TYPE reward = 0;
+				size_t next = 0;
+				int cooperating = 0;
+				for (int i = nof_robots - 1; i >= 0; --i) {
+					const Transition &t = *outcome[i];
+					probability *= t.probability;
+					reward += t.reward;
+					cooperating += finding_big[state[i]][action[i]][t.next];
+					next = next * RRS_COUNT + t.next;
 				}
-			} else { // battery low
-				if (drand48() <= betaSmall) { // by default 1 upon 5 times we get really depleted
-					depleted[i] = true;
-					if (verbosity >= LOG_DEBUG) cout << "to robot " << i << ": Depleted, reset to high battery level (even though you searched for small item)" << endl;
-					state[RRST_BATTERY_LEVEL] = RRS_BATTERY_HIGH; // depleted, so reset
-				} else {
-					state[RRST_BATTERY_LEVEL] = RRS_BATTERY_LOW;
+				if (cooperating == nof_robots) reward += big_reward;
+				joint.Add(joint_state, joint_action, next, probability, reward);
+				for (carry = 0; carry < nof_robots; ++carry) {
+					if (++outcome[carry] != table.end(state[carry], action[carry])) break;
+					outcome[carry] = table.begin(state[carry], action[carry]);
 				}
 			}
-			break;
-		}
-		case RRA_RECHARGE: {
-			state[RRST_BATTERY_LEVEL] = RRS_BATTERY_HIGH;
-			break;
-		}
-		default:
-			cerr << "Unknown state, error!" << endl;
-			break;
 		}
 	}
+	return joint.Prepare();
+}
 
-	// calculate reward
-	int count_big = 0;
-	for (int i = 0; i < nr_bots; ++i) {
-		Action &action = *actions[i];
-		if (action.empty()) continue;
-		if ((RR_ACTION)action[RRAT_SEARCHING] == RRA_SEARCH_BIG) {
-			if (!depleted[i])
-				++count_big;
-		}
-	}
+/**
+ * One pass over the robots: the next battery level and the reward of a robot are drawn from its
+ * row in the transition table, with one number. The robots are independent, although the MAS
+ * setting rewards cooperation between robots, it does not reward it in the sense that in the case
+ * that both robots try to lift a can, it does cost less energy.
+ */
+void RecyclingRobotsBenchmark::DiscreteTick(const std::vector<SymbolAction> &actions,
+		std::vector<SymbolObservation> &observations, std::vector<SymbolState> &states) {
+	assert (observations.size() == actions.size());
+	assert (states.size() == actions.size());
+	int nr_bots = actions.size();
 
-	int count_small = 0;
+	AP_TYPE reward = 0;
+	int cooperating = 0, depletions = 0;
 	for (int i = 0; i < nr_bots; ++i) {
-		Action &action = *actions[i];
-		if (action.empty()) continue;
-		if ((RR_ACTION)action[RRAT_SEARCHING] == RRA_SEARCH_SMALL) {
-			if (!depleted[i])
-				++count_small;
+		RR_SYMBOL action = actions[i][RRAT_SEARCHING];
+		RR_SYMBOL &battery = states[i][RRST_BATTERY_LEVEL];
+		assert (action < RRA_COUNT && battery < RRS_COUNT);
+		const Transition &t = table.Sample(battery, action, random.Uniform());
+		if (verbosity >= LOG_DEBUG && depleting[battery][action][t.next]) {
+			cout << "to robot " << i << ": Depleted, reset to high battery level" << endl;
 		}
+		depletions += depleting[battery][action][t.next];
+		cooperating += finding_big[battery][action][t.next];
+		reward += t.reward;
+		battery = t.next;
+		observations[i][RROT_BATTERY_LEVEL] = battery;
 	}
+	if (nr_bots > 0 && cooperating == nr_bots) reward += big_reward;
+	AddReward(reward, depletions);
+}
 
-
-	instantaneous_reward = 0;
-	if (count_big == nr_bots) instantaneous_reward+=5;
-	instantaneous_reward += count_small*2;
-
-	for (int i = 0; i < nr_bots; ++i) {
-		if (depleted[i])
-			instantaneous_reward -= 10;
-	}
+void RecyclingRobotsBenchmark::AddReward(AP_TYPE reward, int depletions) {
+	instantaneous_reward = reward;
 
 	accumulated_reward += instantaneous_reward;
 
 	discounted_reward = instantaneous_reward + discounted_reward * discount_factor;
 
-	for (int i = 0; i < nr_bots; ++i)
-		depletion_count += depleted[i];
+	depletion_count += depletions;
+}
 
-	// make from states observations
-	for (int i = 0; i < nr_bots; ++i) {
-		State *state = states[i];
-		if (state->empty()) {
-			cout << "State is empty, cannot be used as observation input!" << endl;
-			continue;
+void RecyclingRobotsBenchmark::PackedStart(size_t nof_robots) {
+	nof_packed = nof_robots;
+	batteries.assign((nof_robots + 63) / 64, 0);
+	for (size_t i = 0; i < nof_robots; ++i) {
+		batteries[i / 64] |= uint64_t(1) << (i % 64);
+	}
+}
+
+/**
+ * Per robot the index into the thresholds is battery * RRA_COUNT + action, with the action computed
+ * from the bits as RRA_RECHARGE - 2 * big - small, so the loop over the robots has no branches. The
+ * robots of a word are then counted per (state, action, next state) with masks, which is all it
+ * takes for the reward, also for the bonus that depends on all robots.
+ */
+void RecyclingRobotsBenchmark::PackedTick(const uint64_t *big, const uint64_t *small) {
+	const uint64_t *thresholds = &high_thresholds[0][0];
+	uint64_t counts[RRS_COUNT][RRA_COUNT][RRS_COUNT] = {};
+	for (size_t w = 0; w < batteries.size(); ++w) {
+		size_t n = std::min<size_t>(64, nof_packed - w * 64);
+		uint64_t valid = (n == 64) ? ~uint64_t(0) : (uint64_t(1) << n) - 1;
+		uint64_t high = batteries[w], next = 0;
+		assert (!(big[w] & small[w]) && !((big[w] | small[w]) & ~valid));
+		for (size_t j = 0; j < n; ++j) {
+			int action = RRA_RECHARGE - 2 * ((big[w] >> j) & 1) - ((small[w] >> j) & 1);
+			int index = ((high >> j) & 1) * RRA_COUNT + action;
+			next |= uint64_t((uint64_t)random.Bits() < thresholds[index]) << j;
+		}
+		batteries[w] = next;
+
+		uint64_t levels[RRS_COUNT], actions[RRA_COUNT], nexts[RRS_COUNT];
+		levels[RRS_BATTERY_LOW] = valid & ~high;
+		levels[RRS_BATTERY_HIGH] = high;
+		actions[RRA_SEARCH_BIG] = big[w];
+		actions[RRA_SEARCH_SMALL] = small[w];
+		actions[RRA_RECHARGE] = valid & ~big[w] & ~small[w];
+		nexts[RRS_BATTERY_LOW] = valid & ~next;
+		nexts[RRS_BATTERY_HIGH] = next;
+		for (int s = 0; s < RRS_COUNT; ++s) {
+			for (int a = 0; a < RRA_COUNT; ++a) {
+				for (int k = 0; k < RRS_COUNT; ++k) {
+					counts[s][a][k] += __builtin_popcountll(levels[s] & actions[a] & nexts[k]);
+				}
+			}
+		}
+	}
+
+	AP_TYPE reward = 0;
+	uint64_t cooperating = 0, depletions = 0;
+	for (int s = 0; s < RRS_COUNT; ++s) {
+		for (int a = 0; a < RRA_COUNT; ++a) {
+			for (int k = 0; k < RRS_COUNT; ++k) {
+				reward += counts[s][a][k] * rewards[s][a][k];
+				cooperating += counts[s][a][k] * finding_big[s][a][k];
+				depletions += counts[s][a][k] * depleting[s][a][k];
+			}
 		}
-		observations[i]->push_back(state->front());
-		observations[i]->push_back(instantaneous_reward);
 	}
+	if (nof_packed > 0 && cooperating == nof_packed) reward += big_reward;
+	AddReward(reward, depletions);
 }
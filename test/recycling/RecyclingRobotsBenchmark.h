@@ -26,27 +26,31 @@
 
 #include <Environment.h>
 #include <Structs.h>
+#include <CounterRandom.h>
+#include <TransitionTable.h>
+#include <RecyclingRobotsStructs.h>
 
 #include <boost/random/mersenne_twister.hpp>
 
-#define NOF_ROBOTS 2
+#include <vector>
+#include <stdint.h>
 
 /**
  * There are 2 states per robot (battery depleted and battery full). There are 3 actions, search for
  * big item, search for small item, and recharge. And there are 2 observations (battery depleted and
  * battery full).
  *
- * We will NOT make use of a transition table, because this is absolutely a monster when considering
- * more than 2 robots. Especially considering the fact that the probabilities are independent (the
- * battery depletion does only depend on the state of the given robot), there seems to be no point
- * in creating this table.
+ * The transition table is kept per robot: the battery depletion only depends on the state of the
+ * given robot, and a table over the joint states and actions is a monster when considering more
+ * than 2 robots. The shared bonus for big items is the only part of the reward that depends on all
+ * robots. For exact analysis of a few robots the joint table can be generated, see GetJointTable.
+ *
+ * The number of robots is the number of systems, or for many robots without a system each, the
+ * number given to PackedStart. Then the battery levels are bits, 64 robots in a word, and so are
+ * the actions. A tick is one pass over the words: per robot a draw is compared with the chance on
+ * a high level, the outcomes of a word are counted per (state, action, next state) with popcounts,
+ * and the rewards, depletions and big items follow from these counts and the tables.
  */
-//struct TransitionTable {
-//	AP_TYPE states[2*NOF_ROBOTS];
-//	AP_TYPE actions[3];
-//	AP_TYPE observations[2];
-//};
-
 /**
  * We follow the implementation as in:
  *   http://rbr.cs.umass.edu/~camato/decpomdp/down/ProblemData3Probs.java
@@ -55,7 +59,8 @@
  * transEach[0][2][0]=alphaBig.
  * See also: http://users.isr.ist.utl.pt/~mtjspaan/decpomdp/recycling.dpomdp
  */
-class RecyclingRobotsBenchmark: public Environment {
+class RecyclingRobotsBenchmark: public DiscreteEnvironment<RecyclingRobotsBenchmark, RR_SYMBOL,
+		RROT_COUNT, RRAT_COUNT, RRST_COUNT> {
 public:
 	//! Default constructor
 	RecyclingRobotsBenchmark();
@@ -66,23 +71,74 @@ public:
 	/**
 	 * Tick is the most important function. It will take a vector of actions and return a vector
 	 * of observations. The "recycling robot" problem expects three possible actions (where the
-	 * "waiting" state has been removed): search_big, search_small, and recharge.
+	 * "waiting" state has been removed): search_big, search_small, and recharge. The reward is
+	 * shared by the robots.
 	 */
-	void Tick(const AP_MAS_ACTION &actions, AP_MAS_OBSERVATION &observations, AP_MAS_STATE &states);
+	void DiscreteTick(const std::vector<SymbolAction> &actions,
+			std::vector<SymbolObservation> &observations, std::vector<SymbolState> &states);
 
 	//! Initial state
-	void Init(AP_MAS_OBSERVATION& observations, AP_MAS_STATE& states);
+	void DiscreteInit(std::vector<SymbolObservation> &observations, std::vector<SymbolState> &states);
 
 	//! Get number of times the robot has been totally depleted
 	inline int GetDepletionCount() { return depletion_count; }
 
-	//! Set seed for random number generated
-	void SetSeed(int seed);
+	//! Set seed for random number generated, benchmarks with the same seed but another instance
+	//! number draw other (independent) numbers
+	void SetSeed(int seed, int instance = 0);
 
 	//! Clear everything and restart (eventually with new seed)
 	void Restart();
 
+	//! The battery dynamics of one robot, with the reward of every outcome except the shared bonus
+	inline const TransitionTable & getTransitionTable() const { return table; }
+
+	//! The dynamics of a number of robots together, including the bonus. A joint state (or action)
+	//! is a number with base RRS_COUNT (or RRA_COUNT), with the state of robot 0 as lowest digit.
+	//! Returns false for more than MAX_JOINT_ROBOTS robots.
+	bool GetJointTable(TransitionTable &joint, int nof_robots = NOF_SYSTEMS) const;
+
+	inline AP_TYPE getDiscountFactor() const { return discount_factor; }
+
+	//! The bonus if all robots find a big item
+	inline AP_TYPE getBigReward() const { return big_reward; }
+
+	//! Per battery level and action, 32 random bits are below this with the chance on a high level
+	inline uint64_t getHighThreshold(int state, int action) const { return high_thresholds[state][action]; }
+
+	//! The reward of one robot for an outcome, from the transition table, without the bonus
+	inline AP_TYPE getReward(int state, int action, int next) const { return rewards[state][action][next]; }
+
+	//! If the outcome is a depletion
+	inline bool isDepleting(int state, int action, int next) const {
+		return depleting[state][action][next]; }
+
+	//! If the outcome counts for the bonus
+	inline bool isFindingBig(int state, int action, int next) const {
+		return finding_big[state][action][next]; }
+
+	//! Start with a number of robots without systems, all with a high battery level
+	void PackedStart(size_t nof_robots);
+
+	//! A robot searches for a big item if its bit in big is set, for a small item if its bit in
+	//! small is set, and recharges otherwise, the bits past the last robot should be zero
+	void PackedTick(const uint64_t *big, const uint64_t *small);
+
+	//! Battery levels, a set bit is a high level
+	inline const uint64_t * getPackedBatteries() const { return &batteries[0]; }
+
+	inline size_t getNofPackedRobots() const { return nof_packed; }
+
+	//! Number of words per mask, 64 robots per word
+	inline size_t getNofPackedWords() const { return batteries.size(); }
+
+protected:
+	//! Update the rewards and the depletion count after a tick
+	void AddReward(AP_TYPE reward, int depletions);
+
 private:
+	//! Fill the tables from the probabilities and the rewards
+	void BuildTables();
 
 	//! The chance of having a high energy level after a search_big action
 	AP_TYPE alphaBig;
@@ -99,12 +155,42 @@ private:
 	//! Factor that defines in how much past reward contributes to current reward
 	AP_TYPE discount_factor;
 
+	//! Reward for a small item, for a big item if all robots found one, and for being depleted
+	AP_TYPE small_reward, big_reward, depletion_reward;
+
+	//! Next battery level and reward of a robot, given its battery level and action
+	TransitionTable table;
+
+	//! Per battery level, action and next level if the robot got depleted
+	uint8_t depleting[RRS_COUNT][RRA_COUNT][RRS_COUNT];
+
+	//! The same for finding a big item, which is rewarded if all robots do
+	uint8_t finding_big[RRS_COUNT][RRA_COUNT][RRS_COUNT];
+
+	//! The rows of the transition table per next battery level
+	AP_TYPE rewards[RRS_COUNT][RRA_COUNT][RRS_COUNT];
+
+	//! Per battery level and action, 32 random bits are below this with the chance on a high level
+	uint64_t high_thresholds[RRS_COUNT][RRA_COUNT];
+
+	//! Number of robots without systems
+	size_t nof_packed;
+
+	//! Their battery levels, 64 robots per word
+	std::vector<uint64_t> batteries;
+
 	//! Number of total depletion events
 	int depletion_count;
 
 	//! Seed for random number generator
 	int seed;
 
+	//! Instance number for random number generator
+	int instance;
+
+	//! The random numbers of this benchmark, a snapshot of the benchmark includes them
+	CounterRandom random;
+
 //	boost::mt19937 generator();
 };
 
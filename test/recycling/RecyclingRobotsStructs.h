@@ -24,8 +24,14 @@
 #ifndef RECYCLINGROBOTSSTRUCTS_H_
 #define RECYCLINGROBOTSSTRUCTS_H_
 
+//! Number of robots in the experiments with a system per robot, the benchmark takes any number
 #define NOF_SYSTEMS 2
 
+//! Most robots for which the joint problem is generated and solved: 2^3 states, 3^3 actions
+#define MAX_JOINT_ROBOTS 3
+
+#include <Structs.h>
+
 #include <string>
 
 /**
@@ -51,11 +57,14 @@ enum RR_STATE { RRS_BATTERY_LOW, RRS_BATTERY_HIGH, RRS_COUNT };
 //! There is only one action type
 enum RR_ACTION_TYPE { RRAT_SEARCHING, RRAT_COUNT };
 
-//! There is only one observation type
-enum RR_OBSERVATION_TYPE { RROT_BATTERY_LEVEL, RROT_INSTANTANEOUS_REWARD, RROT_COUNT };
+//! There is only one observation type, the reward is not observed but comes on its own channel
+enum RR_OBSERVATION_TYPE { RROT_BATTERY_LEVEL, RROT_COUNT };
 
 //! There is only one state type per robot
 enum RR_STATE_TYPE { RRST_BATTERY_LEVEL, RRST_COUNT };
 
+//! All observations, actions and states are small enumerations, a byte per value is enough
+typedef SYMBOL8_TYPE RR_SYMBOL;
+
 
 #endif /* RECYCLINGROBOTSSTRUCTS_H_ */
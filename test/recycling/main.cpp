@@ -21,26 +21,37 @@
  * @case	Self-organised criticality
  */
 
-#include <Embodiment.h>
+#include <TypedEmbodiment.h>
 #include <Information.h>
 #include <RecyclingRobotsBenchmark.h>
 #include <RecyclingRobot.h>
 #include <RecyclingRobotsStructs.h>
+#include <RecyclingRobotsBatch.h>
+#include <RecyclingPlanner.h>
+#include <MarkovChain.h>
 
 #include <vector>
 #include <iostream>
 #include <sstream>
 #include <fstream>
 #include <assert.h>
+#include <math.h>
 #include <sys/syslog.h>
+#include <sys/time.h>
 
 using namespace std;
 
+static double now() {
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
 /**
  * Only undefined references left, which is true, I need to implement the methods.
  */
 int main() {
-	AP_SYSTEMS systems;
+	std::vector<RecyclingRobot*> systems;
 	for (int i = 0; i < NOF_SYSTEMS; ++i) {
 		std::stringstream ss;
 		ss << "robot " << i;
@@ -51,13 +62,24 @@ int main() {
 	RecyclingRobotsBenchmark env;
 //		env.SetVerbosity(LOG_DEBUG);
 
-	Information information;
-	Embodiment embodiment;
-	Coupling coupling;
+	// the information between an action and the battery level and reward that follow, per robot,
+	// the reward lies in [-20,10] and is shifted to a symbol in [0,30], with 31 bins every symbol
+	// has a bin of its own
+	std::vector<Information*> information;
+	for (int i = 0; i < NOF_SYSTEMS; ++i) {
+		Information *info = new Information();
+		info->setInfoType(IT_MUTUAL_INFORMATION);
+		info->setNofBins(31);
+		information.push_back(info);
+	}
+	AP_TYPE intrinsic_reward[NOF_SYSTEMS];
 
-	// think of how to do this neatly with multiple systems, each need other coupling parameters
-	// they might communicate with each other
-	embodiment.Couple(env, systems, coupling);
+	// the types of the environment and robots are known, so the loop can be inlined, with the
+	// Embodiment the results are the same (and the robots could communicate through the channels
+	// of a Coupling, see Coupling::Connect)
+	typedef TypedEmbodiment<RecyclingRobotsBenchmark, RecyclingRobot> RecyclingEmbodiment;
+	RecyclingEmbodiment embodiment;
+	embodiment.Couple(env, systems);
 
 	ofstream file;
 	file.open("rewards.txt");
@@ -87,10 +109,12 @@ int main() {
 //		seed = 1;
 		env.SetSeed(seed);
 		embodiment.Restart();
+		for (int i = 0; i < NOF_SYSTEMS; ++i) {
+			information[i]->Clear();
+		}
 
 //		avg = 0;
-		for (int t = 1; t < timespan+1; ++t) {
-			embodiment.Tick();
+		embodiment.Run(timespan, [&](const RecyclingEmbodiment &embodiment) {
 			AP_TYPE reward = env.GetDiscountedReward();
 //			file << (t-1) << " " << reward << endl;
 			reward_per_trial->push_back(reward);
@@ -100,8 +124,13 @@ int main() {
 //				file << (t-1)/window << " " << avg/window << endl;
 //				avg = 0;
 //			}
-			//		information.Calculate();
-		}
+			for (int i = 0; i < NOF_SYSTEMS; ++i) {
+				const RecyclingRobotsBenchmark::SymbolObservation &observation = embodiment.getObservations()[i];
+				RR_SYMBOL perceived[] = { observation[RROT_BATTERY_LEVEL], RR_SYMBOL(embodiment.GetReward(i) + 20) };
+				information[i]->AddSymbols(perceived, 2, embodiment.getActions()[i].data(), RRAT_COUNT);
+				intrinsic_reward[i] = information[i]->Calculate();
+			}
+		});
 		int print_reward = env.GetAccumulatedReward();
 		cout << "Accumulated reward " << print_reward << endl;
 
@@ -110,6 +139,11 @@ int main() {
 
 		int depletions = env.GetDepletionCount();
 		cout << "Total number of depletions " << depletions << endl;
+
+		for (int i = 0; i < NOF_SYSTEMS; ++i) {
+			cout << "Mutual information between action and observation of robot " << i << " is "
+					<< intrinsic_reward[i] << " bits" << endl;
+		}
 	}
 
 	// write to file
@@ -141,5 +175,153 @@ int main() {
 		rewards.pop_back();
 	}
 
+	// the same experiment with many more trials, as instances of a batch stepped in lockstep, each
+	// instance with its own random stream (so the rewards differ from the ones above)
+	int nof_batch_trials = 1024;
+	RecyclingRobotsBatch batch_env;
+	batch_env.setBenchmark(env);
+	batch_env.SetSeed(seeds[0]);
+	batch_env.setHorizon(timespan);
+	std::vector<BatchSystem<RR_SYMBOL>*> batch_robots;
+	for (int i = 0; i < NOF_SYSTEMS; ++i) {
+		batch_robots.push_back(new RecyclingRobotBatch());
+	}
+	BatchEmbodiment<RR_SYMBOL> batch;
+	batch.Couple(batch_env, batch_robots, nof_batch_trials);
+	for (int t = 0; t < timespan; ++t) {
+		batch.Tick();
+	}
+	avg = AP_TYPE(0);
+	for (int trial = 0; trial < nof_batch_trials; ++trial) {
+		avg += batch_env.getDiscountedRewardSums()[trial];
+	}
+	avg /= ((AP_TYPE)timespan * nof_batch_trials);
+	cout << "Averaged discounted reward over " << nof_batch_trials << " batched trials from t=0:"
+			<< timespan << " is " << avg << endl;
+	for (int i = 0; i < NOF_SYSTEMS; ++i) {
+		delete batch_robots[i];
+	}
+
+	// the policies that follow from the Bellman equation, a table per robot that maps its battery
+	// level to an action, instead of the manual rules
+	RecyclingPlanner planner;
+	if (planner.Plan(env)) {
+		cout << "Expected discounted reward from the start with shared observations is "
+				<< planner.getJointValue() << ", with a policy per robot it is " << planner.getValue()
+				<< endl;
+		for (int i = 0; i < NOF_SYSTEMS; ++i) {
+			systems[i]->SetPolicy(planner.getPolicy(i));
+			cout << "Policy of robot " << i << ":";
+			for (int o = 0; o < RRO_COUNT; ++o) {
+				cout << " " << RR_OBSERVATION_STR[o] << " -> " << RR_ACTION_STR[planner.getPolicy(i)[o]];
+			}
+			cout << endl;
+		}
+
+		// the tables are a fixed policy on the joint problem, so the expected reward of every tick
+		// follows from the Markov chain, instead of from trials
+		double start = now();
+		MarkovChain chain;
+		chain.Build(planner.getTable(), planner.getTablePolicy());
+		std::vector<PROB_TYPE> distribution(chain.size(), 0);
+		distribution[planner.getStart()] = 1;
+		std::vector<AP_TYPE> means, variances;
+		chain.RewardCurve(distribution, timespan, means, variances);
+		AP_TYPE discounted = 0;
+		avg = AP_TYPE(0);
+		for (int t = 0; t < timespan; ++t) {
+			discounted = means[t] + discounted * env.getDiscountFactor();
+			avg += discounted;
+		}
+		avg /= timespan;
+		std::vector<AP_TYPE> values, return_variances;
+		bool returned = chain.Return(env.getDiscountFactor(), values, return_variances);
+		bool stationary = chain.Stationary(distribution);
+		double time = now() - start;
+		cout << "Expected averaged discounted reward with the planned policy from t=0:" << timespan
+				<< " is " << avg << endl;
+		if (returned) {
+			cout << "The standard deviation of the discounted reward from the start is "
+					<< sqrt(return_variances[planner.getStart()]) << endl;
+		} else {
+			cerr << "The discounted reward of the planned policy did not converge" << endl;
+		}
+		if (stationary) {
+			cout << "In the long run the reward per tick is " << chain.Mean(distribution)
+					<< " with a standard deviation of " << sqrt(chain.Variance(distribution)) << endl;
+		} else {
+			cerr << "The stationary distribution of the planned policy did not converge" << endl;
+		}
+		cout << "Calculated in " << time * 1e3 << " ms" << endl;
+
+		// one trial as a check, the robots look up their actions in the tables
+		avg = AP_TYPE(0);
+		env.SetSeed(seeds[0]);
+		embodiment.Restart();
+		embodiment.Run(timespan, [&](const RecyclingEmbodiment &embodiment) {
+			avg += env.GetDiscountedReward();
+		});
+		avg /= timespan;
+		cout << "Averaged discounted reward of one trial with the planned policy from t=0:" << timespan
+				<< " is " << avg << endl;
+	}
+
+	// the bonus for big items in a team without a system per robot: with a high battery a robot
+	// searches for a big item with chance q, else for a small one, and with a low battery it
+	// recharges, so it is never depleted. A robot has a high battery with chance 1 / (2 - h), with h
+	// = 0.5 q + 0.7 (1 - q), and the bonus is given if all robots search for a big item, at a rate
+	// of (q / (2 - h))^n, the cooperative reward vanishes exponentially with the size of the team.
+	// The choices are drawn from another instance than the one of the team, so they are independent.
+	const AP_TYPE q = 0.9;
+	CounterRandom choices(seeds[0], 1);
+	for (size_t nof_robots = 1; nof_robots <= 16; nof_robots *= 2) {
+		RecyclingRobotsBenchmark team;
+		team.SetSeed(seeds[0]);
+		team.PackedStart(nof_robots);
+		uint64_t big, small;
+		int ticks = 1000000, bonuses = 0;
+		for (int t = 0; t < ticks; ++t) {
+			big = 0;
+			for (size_t i = 0; i < nof_robots; ++i) {
+				big |= uint64_t(choices.Uniform() < q) << i;
+			}
+			big &= team.getPackedBatteries()[0];
+			small = team.getPackedBatteries()[0] & ~big;
+			team.PackedTick(&big, &small);
+			// a small item gives 2, the rest of the reward is the bonus
+			bonuses += (team.GetInstantaneousReward() > 2 * __builtin_popcountll(small));
+		}
+		AP_TYPE high = 1 / (2 - (0.5 * q + 0.7 * (1 - q)));
+		cout << nof_robots << " robots: bonus in " << (AP_TYPE)bonuses / ticks << " of the ticks, "
+				<< "expected " << pow(q * high, (AP_TYPE)nof_robots) << endl;
+	}
+	// a team without robots gets no bonus, although none of its robots failed to search for one
+	RecyclingRobotsBenchmark nobody;
+	nobody.PackedStart(0);
+	nobody.PackedTick(NULL, NULL);
+	cout << "0 robots: reward " << nobody.GetInstantaneousReward() << ", expected 0" << endl;
+
+	// throughput with many robots, they search for a big item when their battery is high and else
+	// recharge, the bonus is only given at the first tick, when all batteries are high
+	for (size_t nof_robots = 1000; nof_robots <= 100000; nof_robots *= 10) {
+		RecyclingRobotsBenchmark swarm;
+		swarm.SetSeed(seeds[0]);
+		swarm.PackedStart(nof_robots);
+		std::vector<uint64_t> big(swarm.getNofPackedWords()), small(swarm.getNofPackedWords(), 0);
+		int ticks = 10000000 / nof_robots;
+		double start = now();
+		for (int t = 0; t < ticks; ++t) {
+			std::copy(swarm.getPackedBatteries(), swarm.getPackedBatteries() + big.size(), big.begin());
+			swarm.PackedTick(&big[0], &small[0]);
+		}
+		double time = now() - start;
+		cout << nof_robots << " robots: " << (double)nof_robots * ticks / time / 1e6
+				<< " million robot-steps per second" << endl;
+	}
+
+	for (int i = 0; i < NOF_SYSTEMS; ++i) {
+		delete information[i];
+	}
+
 	file.close();
 }
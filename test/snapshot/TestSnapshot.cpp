@@ -0,0 +1,306 @@
+/***************************************************************************************************
+ * @brief Rollouts from snapshots of embodiments, replayed, forked and copy-on-write
+ * @file TestSnapshot.cpp
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#include <TestSnapshot.h>
+#include <Embodiment.h>
+#include <TypedEmbodiment.h>
+
+#include <iostream>
+#include <stdlib.h>
+#include <sys/time.h>
+
+using namespace std;
+
+//! Ticks per rollout
+#define ROLLOUT_TICKS 20
+
+void WalkEnvironment::FixedInit(std::vector<FixedObservation> &observations,
+		std::vector<FixedState> &states) {
+	for (size_t i = 0; i < states.size(); ++i) {
+		states[i][0] = i % 5;
+		observations[i][0] = states[i][0];
+	}
+}
+
+void WalkEnvironment::FixedTick(const std::vector<FixedAction> &actions,
+		std::vector<FixedObservation> &observations, std::vector<FixedState> &states) {
+	instantaneous_reward = 0;
+	for (size_t i = 0; i < actions.size(); ++i) {
+		random ^= random << 13;
+		random ^= random >> 7;
+		random ^= random << 17;
+		states[i][0] += actions[i][0] + ((random & 1) ? 0.5 : -0.5);
+		observations[i][0] = states[i][0];
+		instantaneous_reward -= states[i][0] * states[i][0];
+	}
+	discounted_reward = instantaneous_reward + 0.9 * discounted_reward;
+}
+
+void AveragingSystem::FixedTick(const FixedObservation &observation, FixedAction &action) {
+	sum += observation[0];
+	++count;
+	action[0] = 0.5 * (sum / count - observation[0]);
+}
+
+void DynamicWalkEnvironment::FixedInit(std::vector<FixedObservation> &observations,
+		std::vector<FixedState> &states) {
+	for (size_t i = 0; i < states.size(); ++i) {
+		states[i].assign(1, i % 5);
+		observations[i].assign(1, states[i][0]);
+	}
+}
+
+void DynamicWalkEnvironment::FixedTick(const std::vector<FixedAction> &actions,
+		std::vector<FixedObservation> &observations, std::vector<FixedState> &states) {
+	instantaneous_reward = 0;
+	for (size_t i = 0; i < actions.size(); ++i) {
+		random ^= random << 13;
+		random ^= random >> 7;
+		random ^= random << 17;
+		states[i][0] += actions[i][0] + ((random & 1) ? 0.5 : -0.5);
+		observations[i][0] = states[i][0];
+		instantaneous_reward -= states[i][0] * states[i][0];
+	}
+	discounted_reward = instantaneous_reward + 0.9 * discounted_reward;
+}
+
+void DynamicAveragingSystem::FixedTick(const FixedObservation &observation, FixedAction &action) {
+	sum += observation[0];
+	++count;
+	action.assign(1, 0.5 * (sum / count - observation[0]));
+}
+
+static double now() {
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+int TestSnapshot::Test() {
+	int failures = 0;
+	failures += CopyOnWrites();
+	failures += Rollouts();
+	failures += TypedRollouts();
+	failures += DynamicSizes();
+	failures += WrongSizes();
+	return failures;
+}
+
+int TestSnapshot::CopyOnWrites() {
+	int failures = 0;
+	CopyOnWrite<std::vector<int> > value;
+	value.write().assign(1000, 1);
+	const int *before = value.read().data();
+	failures += value.isShared() + (value.write().data() != before);
+	CopyOnWrite<std::vector<int> > copy = value;
+	failures += !value.isShared() + (copy.read().data() != before);
+	value.write()[0] = 2;
+	failures += (value.read().data() == before) + (copy.read()[0] != 1) + copy.isShared();
+	return failures;
+}
+
+/**
+ * The rewards of a rollout are summed, they should be exactly the same from the same snapshot.
+ */
+int TestSnapshot::Rollouts() {
+	int failures = 0;
+	std::vector<AveragingSystem> walkers(4), fork_walkers(4);
+	AP_SYSTEMS systems, fork_systems;
+	for (size_t i = 0; i < walkers.size(); ++i) {
+		systems.push_back(&walkers[i]);
+		fork_systems.push_back(&fork_walkers[i]);
+	}
+	WalkEnvironment env, fork_env;
+	Embodiment embodiment, fork;
+	Coupling coupling, fork_coupling;
+	embodiment.Couple(env, systems, coupling);
+	fork.Couple(fork_env, fork_systems, fork_coupling);
+	embodiment.Restart();
+	for (int t = 0; t < 50; ++t) {
+		embodiment.Tick();
+	}
+	Snapshot snapshot = embodiment.Save();
+	failures += snapshot.empty();
+
+	AP_TYPE rollouts[3] = { 0, 0, 0 };
+	for (int r = 0; r < 3; ++r) {
+		Embodiment &branch = (r < 2) ? embodiment : fork;
+		WalkEnvironment &branch_env = (r < 2) ? env : fork_env;
+		failures += !branch.Restore(snapshot);
+		failures += (branch.GetTime() != 50);
+		for (int t = 0; t < ROLLOUT_TICKS; ++t) {
+			branch.Tick();
+			rollouts[r] += branch_env.GetInstantaneousReward();
+		}
+	}
+	if (rollouts[1] != rollouts[0] || rollouts[2] != rollouts[0]) {
+		cerr << "Rollouts differ: " << rollouts[0] << ", " << rollouts[1] << " and " << rollouts[2] << endl;
+		++failures;
+	}
+
+	// a snapshot of another type of embodiment is refused
+	TypedEmbodiment<WalkEnvironment, AveragingSystem> typed;
+	failures += embodiment.Restore(typed.Save());
+	return failures;
+}
+
+/**
+ * Many rollouts from one state of many systems: a rollout should cost about the ticks it simulates,
+ * the snapshot itself is shared.
+ */
+int TestSnapshot::TypedRollouts() {
+	int failures = 0;
+	size_t nof_systems = 10000;
+	int nof_rollouts = 200;
+	std::vector<AveragingSystem> walkers(nof_systems);
+	std::vector<AveragingSystem*> systems;
+	for (size_t i = 0; i < walkers.size(); ++i) {
+		systems.push_back(&walkers[i]);
+	}
+	WalkEnvironment env;
+	TypedEmbodiment<WalkEnvironment, AveragingSystem> embodiment;
+	embodiment.Couple(env, systems);
+	embodiment.Restart();
+	for (int t = 0; t < 10; ++t) {
+		embodiment.Tick();
+	}
+
+	double start = now();
+	Snapshot snapshot = embodiment.Save();
+	double save = now() - start;
+	AP_TYPE first = 0;
+	double restore = 0, ticks = 0;
+	for (int r = 0; r < nof_rollouts; ++r) {
+		start = now();
+		failures += !embodiment.Restore(snapshot);
+		restore += now() - start;
+		start = now();
+		AP_TYPE rollout = 0;
+		for (int t = 0; t < ROLLOUT_TICKS; ++t) {
+			embodiment.Tick();
+			rollout += env.GetInstantaneousReward();
+		}
+		ticks += now() - start;
+		if (!r) first = rollout;
+		failures += (rollout != first);
+	}
+	cout << nof_rollouts << " rollouts of " << ROLLOUT_TICKS << " ticks of " << nof_systems
+			<< " systems: save " << save * 1e6 << " us, restore " << restore / nof_rollouts * 1e6
+			<< " us, ticks " << ticks / nof_rollouts * 1e6 << " us per rollout" << endl;
+
+	// the same number of systems, but in groups of other sizes, is refused and changes nothing
+	std::vector<AveragingSystem*> four(systems.begin(), systems.begin() + 4);
+	std::vector<AveragingSystem*> six(systems.begin() + 4, systems.begin() + 10);
+	WalkEnvironment split_env, other_env;
+	TypedEmbodiment<WalkEnvironment, AveragingSystem, AveragingSystem> split, other;
+	split.Couple(split_env, four, six);
+	other.Couple(other_env, six, four);
+	split.Restart();
+	other.Restart();
+	split.Tick();
+	failures += other.Restore(split.Save());
+	failures += (other.GetTime() != 0);
+	failures += !split.Restore(split.Save());
+	return failures;
+}
+
+int TestSnapshot::DynamicSizes() {
+	int failures = 0;
+	size_t nof_systems = 4;
+	std::vector<AveragingSystem> walkers(nof_systems);
+	std::vector<DynamicAveragingSystem> dynamic_walkers(nof_systems);
+	AP_SYSTEMS systems, dynamic_systems;
+	for (size_t i = 0; i < nof_systems; ++i) {
+		systems.push_back(&walkers[i]);
+		dynamic_systems.push_back(&dynamic_walkers[i]);
+	}
+	WalkEnvironment env;
+	DynamicWalkEnvironment dynamic_env;
+	Embodiment embodiment, dynamic;
+	Coupling coupling, dynamic_coupling;
+	embodiment.Couple(env, systems, coupling);
+	dynamic.Couple(dynamic_env, dynamic_systems, dynamic_coupling);
+	embodiment.Restart();
+	dynamic.Restart();
+	for (int t = 0; t < ROLLOUT_TICKS; ++t) {
+		embodiment.Tick();
+		dynamic.Tick();
+		failures += (dynamic_env.GetInstantaneousReward() != env.GetInstantaneousReward());
+	}
+	for (size_t i = 0; i < nof_systems; ++i) {
+		failures += (dynamic.GetObservation(i).size() != 1) + (dynamic.GetAction(i).size() != 1);
+	}
+	if (failures) {
+		cerr << "The walk with dynamic sizes differs from the fixed one" << endl;
+	}
+	return failures;
+}
+
+/**
+ * The environment is ticked directly, as a user would, with actions that do not have the size of
+ * its fixed samples. The values that fit are used, the others are zero.
+ */
+int TestSnapshot::WrongSizes() {
+	int failures = 0;
+	std::array<AP_TYPE, 2> pair;
+	load(std::vector<AP_TYPE>{ 1, 2, 3, 4, 5 }, pair);
+	failures += (pair[0] != 1) + (pair[1] != 2);
+	load(std::vector<AP_TYPE>{ 7 }, pair);
+	failures += (pair[0] != 7) + (pair[1] != 0);
+	load(std::vector<AP_TYPE>(), pair);
+	failures += (pair[0] != 0) + (pair[1] != 0);
+
+	size_t nof_systems = 3;
+	std::vector<Observation> observation_values(nof_systems);
+	std::vector<State> state_values(nof_systems);
+	AP_MAS_OBSERVATION observations;
+	AP_MAS_STATE states;
+	for (size_t i = 0; i < nof_systems; ++i) {
+		observations.push_back(&observation_values[i]);
+		states.push_back(&state_values[i]);
+	}
+	WalkEnvironment env, reference;
+	env.Init(observations, states);
+	reference.Init(observations, states);
+	Action wide(64, 0.25), empty, single(1, 0.25), none(1, 0);
+	AP_MAS_ACTION wrong = { &wide, &empty }, right = { &single, &none, &none };
+	for (int t = 0; t < ROLLOUT_TICKS; ++t) {
+		env.Tick(wrong, observations, states);
+		reference.Tick(right, observations, states);
+		failures += (env.GetInstantaneousReward() != reference.GetInstantaneousReward());
+	}
+	if (failures) {
+		cerr << "Actions of the wrong size are not cut off or filled up" << endl;
+	}
+	return failures;
+}
+
+int main() {
+	TestSnapshot ts;
+	int failures = ts.Test();
+	if (failures) {
+		cout << "There are " << failures << " failures" << endl;
+		return EXIT_FAILURE;
+	}
+	cout << "All snapshot checks passed" << endl;
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,124 @@
+/***************************************************************************************************
+ * @brief Rollouts from snapshots of embodiments, replayed, forked and copy-on-write
+ * @file TestSnapshot.h
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#ifndef TESTSNAPSHOT_H_
+#define TESTSNAPSHOT_H_
+
+#include <System.h>
+#include <Environment.h>
+
+#include <stdint.h>
+
+/**
+ * Every system walks randomly on a line, and is pushed by its action. The random numbers come from
+ * a generator that is a member, so it is part of a snapshot.
+ */
+class WalkEnvironment: public FixedEnvironment<WalkEnvironment, 1, 1, 1> {
+public:
+	WalkEnvironment(): random(1) {}
+
+	void FixedInit(std::vector<FixedObservation> &observations, std::vector<FixedState> &states);
+
+	void FixedTick(const std::vector<FixedAction> &actions, std::vector<FixedObservation> &observations,
+			std::vector<FixedState> &states);
+
+	void Restart() { Clear(); random = 1; }
+private:
+	uint64_t random;
+};
+
+/**
+ * Pushes towards the average of what it has seen so far, so its internal state matters.
+ */
+class AveragingSystem: public FixedSystem<AveragingSystem, 1, 1> {
+public:
+	AveragingSystem() { Restart(); }
+
+	void FixedTick(const FixedObservation &observation, FixedAction &action);
+
+	void Restart() { sum = 0; count = 0; }
+private:
+	AP_TYPE sum;
+
+	long int count;
+};
+
+/**
+ * The same walk, with sizes that are only known at runtime.
+ */
+class DynamicWalkEnvironment: public FixedEnvironment<DynamicWalkEnvironment, DYNAMIC_SIZE,
+		DYNAMIC_SIZE, DYNAMIC_SIZE> {
+public:
+	DynamicWalkEnvironment(): random(1) {}
+
+	void FixedInit(std::vector<FixedObservation> &observations, std::vector<FixedState> &states);
+
+	void FixedTick(const std::vector<FixedAction> &actions, std::vector<FixedObservation> &observations,
+			std::vector<FixedState> &states);
+
+	void Restart() { Clear(); random = 1; }
+private:
+	uint64_t random;
+};
+
+/**
+ * The averaging system, with sizes that are only known at runtime.
+ */
+class DynamicAveragingSystem: public FixedSystem<DynamicAveragingSystem, DYNAMIC_SIZE, DYNAMIC_SIZE> {
+public:
+	DynamicAveragingSystem() { Restart(); }
+
+	void FixedTick(const FixedObservation &observation, FixedAction &action);
+
+	void Restart() { sum = 0; count = 0; }
+private:
+	AP_TYPE sum;
+
+	long int count;
+};
+
+/**
+ * Checks that a rollout from a snapshot is the same every time, also in another embodiment (a
+ * fork), and that a snapshot shares its values copy-on-write.
+ */
+class TestSnapshot {
+public:
+	//! Returns the number of failed checks
+	int Test();
+protected:
+	//! Values are shared till written
+	int CopyOnWrites();
+
+	//! Rollouts from a snapshot of an embodiment, in the same and in another embodiment
+	int Rollouts();
+
+	//! Rollouts from a snapshot of a typed embodiment with many systems, timed
+	int TypedRollouts();
+
+	//! The walk with sizes of DYNAMIC_SIZE, ticked by an embodiment, is the same as the fixed one
+	int DynamicSizes();
+
+	//! Actions of the wrong size or number are cut off or filled up with zeros
+	int WrongSizes();
+};
+
+#endif /* TESTSNAPSHOT_H_ */
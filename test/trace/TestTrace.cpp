@@ -0,0 +1,241 @@
+/***************************************************************************************************
+ * @brief Round trips, truncated and corrupted files of the trace format
+ * @file TestTrace.cpp
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#include <TestTrace.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include <unistd.h>
+#include <iostream>
+#include <math.h>
+
+#include <boost/random.hpp>
+
+using namespace std;
+using namespace boost;
+
+//! Samples per block in the files written here, small so there are many blocks
+#define TEST_BLOCK_SIZE 100
+
+TestTrace::TestTrace() {
+	filename = "TestTrace.trace";
+}
+
+TestTrace::~TestTrace() {
+	remove(filename.c_str());
+}
+
+int TestTrace::Test() {
+	int failures = 0;
+	failures += RoundTrips();
+	failures += Unclosed();
+	failures += Corrupted();
+	return failures;
+}
+
+/**
+ * Channel by channel: a small integer, an integer that is constant for long runs, a smooth sine, a
+ * sine read by a 12-bit converter, random bits, and doubles that are no integers although they look
+ * like it. The times mostly go up by one.
+ */
+void TestTrace::Generate(int observation_size, int action_size, size_t nof_samples,
+		ColumnarPath &path) {
+	boost::random::mt19937_64 rng(17);
+	path.setDimensions(observation_size, action_size);
+	std::vector<AP_TYPE> values(observation_size + action_size);
+	long int t = 0;
+	for (size_t i = 0; i < nof_samples; ++i) {
+		for (size_t c = 0; c < values.size(); ++c) {
+			switch (c % 6) {
+			case 0: values[c] = (i * 7 + c) % 5; break;
+			case 1: values[c] = (AP_TYPE)(i / 300) - 2; break;
+			case 2: values[c] = sin(i * 0.001 + c); break;
+			case 3: values[c] = round((sin(i * 0.01) + 1) * 2047) / 4095.0; break;
+			case 4: {
+				uint64_t bits = rng();
+				memcpy(&values[c], &bits, sizeof(bits));
+				break;
+			}
+			default: {
+				AP_TYPE special[] = { -0.0, NAN, INFINITY, 1e300, 0.5 };
+				values[c] = special[i % 5];
+			}
+			}
+		}
+		t += (i % 97) ? 1 : 3;
+		path.push_back(values.data(), values.data() + observation_size, t);
+	}
+}
+
+bool TestTrace::Equal(const ColumnarView &a, const ColumnarView &b) {
+	if (a.size() != b.size() || a.getObservationSize() != b.getObservationSize() ||
+			a.getActionSize() != b.getActionSize()) return false;
+	size_t n = a.size();
+	return !memcmp(a.getObservations(), b.getObservations(), n * a.getObservationSize() * sizeof(AP_TYPE)) &&
+			!memcmp(a.getActions(), b.getActions(), n * a.getActionSize() * sizeof(AP_TYPE)) &&
+			!memcmp(a.getTimes(), b.getTimes(), n * sizeof(long int));
+}
+
+bool TestTrace::Write(const ColumnarPath &path, TraceEncoding encoding) {
+	TraceWriter writer;
+	if (!writer.Open(filename, path.getObservationSize(), path.getActionSize(), TEST_BLOCK_SIZE,
+			encoding)) return false;
+	for (size_t i = 0; i < path.size(); ++i) {
+		writer.Write(path.getObservations() + i * path.getObservationSize(),
+				path.getActions() + i * path.getActionSize(), path.time(i));
+	}
+	return writer.Close();
+}
+
+int TestTrace::Read(const ColumnarPath &path) {
+	TraceReader reader;
+	if (!reader.Open(filename)) return 1;
+	int failures = 0;
+	failures += (reader.size() != path.size());
+	failures += (reader.getNofBlocks() != (path.size() + TEST_BLOCK_SIZE - 1) / TEST_BLOCK_SIZE);
+	int observation_size = path.getObservationSize(), action_size = path.getActionSize();
+	ColumnarPath buffer;
+	size_t first = 0;
+	for (size_t b = 0; b < reader.getNofBlocks(); ++b) {
+		ColumnarView block = reader.Load(b, buffer);
+		size_t n = (path.size() - first < TEST_BLOCK_SIZE) ? path.size() - first : TEST_BLOCK_SIZE;
+		ColumnarView expected(path.getObservations() + first * observation_size,
+				path.getActions() + first * action_size, path.getTimes() + first, n, observation_size,
+				action_size);
+		failures += !Equal(block, expected);
+		first += n;
+	}
+	return failures;
+}
+
+int TestTrace::RoundTrips() {
+	int failures = 0;
+	int sizes[][2] = { { 4, 3 }, { 6, 0 }, { 0, 2 } };
+	for (int s = 0; s < 3; ++s) {
+		ColumnarPath path;
+		Generate(sizes[s][0], sizes[s][1], 1050, path);
+		for (int encoding = 0; encoding < TE_COUNT; ++encoding) {
+			int f = !Write(path, (TraceEncoding)encoding);
+			f += Read(path);
+			cout << ((encoding == TE_RAW) ? "Raw" : "Compressed") << " trace of " << sizes[s][0]
+					<< " sensors and " << sizes[s][1] << " actuators "
+					<< (f ? "differs" : "is the same") << endl;
+			failures += f;
+		}
+	}
+	return failures;
+}
+
+int TestTrace::Unclosed() {
+	int failures = 0;
+	for (int encoding = 0; encoding < TE_COUNT; ++encoding) {
+		ColumnarPath path;
+		Generate(2, 1, 250, path);
+		TraceWriter writer;
+		failures += !writer.Open(filename, 2, 1, TEST_BLOCK_SIZE, (TraceEncoding)encoding);
+		TraceReader reader;
+		failures += !reader.Open(filename) + (reader.size() != 0);
+		for (size_t i = 0; i < path.size(); ++i) {
+			writer.Write(path.getObservations() + 2 * i, path.getActions() + i, path.time(i));
+		}
+		// two blocks are on disk, but the number of samples is not
+		failures += !reader.Open(filename) + (reader.size() != 0) + (reader.getNofBlocks() != 0);
+		reader.Close();
+		failures += !writer.Close();
+		failures += Read(path);
+	}
+	cout << "Traces that are still being written read as empty" << endl;
+	return failures;
+}
+
+void TestTrace::Corrupt(size_t position, uint8_t value) {
+	FILE *file = fopen(filename.c_str(), "r+b");
+	if (file == NULL) return;
+	fseek(file, position, SEEK_SET);
+	fwrite(&value, 1, 1, file);
+	fclose(file);
+}
+
+/**
+ * The reader should refuse a file it cannot read completely when it is opened. Blocks of a
+ * compressed file are only decoded on request, so a wrong block is found by Load.
+ */
+int TestTrace::Corrupted() {
+	int failures = 0;
+	ColumnarPath path;
+	Generate(4, 3, 1050, path);
+	TraceReader reader;
+	ColumnarPath buffer;
+
+	// cut short, in a block and in the index
+	for (int encoding = 0; encoding < TE_COUNT; ++encoding) {
+		Write(path, (TraceEncoding)encoding);
+		failures += !reader.Open(filename);
+		FILE *file = fopen(filename.c_str(), "rb");
+		fseek(file, 0, SEEK_END);
+		long int length = ftell(file);
+		fclose(file);
+		failures += (truncate(filename.c_str(), length - 20) != 0);
+		failures += reader.Open(filename);
+		failures += (truncate(filename.c_str(), sizeof(TraceHeader) / 2) != 0);
+		failures += reader.Open(filename);
+	}
+
+	// a wrong header
+	size_t magic = offsetof(TraceHeader, magic), version = offsetof(TraceHeader, version);
+	size_t encoding = offsetof(TraceHeader, encoding);
+	size_t positions[] = { magic, version, version, encoding };
+	uint8_t values[] = { 'X', TRACE_VERSION + 1, TRACE_VERSION - 1, TE_COUNT };
+	for (int p = 0; p < 4; ++p) {
+		Write(path, TE_COMPRESSED);
+		Corrupt(positions[p], values[p]);
+		failures += reader.Open(filename);
+	}
+
+	// a wrong channel encoding in the first block (after its three sizes), and a block that would
+	// start after its end
+	Write(path, TE_COMPRESSED);
+	failures += !reader.Open(filename);
+	uint64_t index_offset = reader.getHeader().index_offset;
+	reader.Close();
+	Corrupt(sizeof(TraceHeader) + 3, 0xff);
+	Corrupt(index_offset + 2 * sizeof(uint64_t) - 1, 0xff);
+	failures += !reader.Open(filename);
+	failures += (reader.Load(0, buffer).size() != 0) + (reader.Load(1, buffer).size() != 0);
+	failures += (reader.Load(2, buffer).size() != TEST_BLOCK_SIZE);
+	reader.Close();
+
+	cout << "Truncated and corrupted traces are refused" << endl;
+	return failures;
+}
+
+int main() {
+	TestTrace tt;
+	int failures = tt.Test();
+	if (failures) {
+		cout << "There are " << failures << " failures" << endl;
+		return EXIT_FAILURE;
+	}
+	cout << "All trace checks passed" << endl;
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,71 @@
+/***************************************************************************************************
+ * @brief Round trips, truncated and corrupted files of the trace format
+ * @file TestTrace.h
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#ifndef TESTTRACE_H_
+#define TESTTRACE_H_
+
+#include <TraceFile.h>
+
+#include <string>
+
+/**
+ * Writes traces to a file and reads them back, raw and compressed, and checks that every value
+ * comes back bit for bit. Files that were not closed, are cut short or have wrong bytes should be
+ * refused or read as empty, never read wrongly.
+ */
+class TestTrace {
+public:
+	TestTrace();
+
+	~TestTrace();
+
+	//! Returns the number of failed checks
+	int Test();
+protected:
+	//! Several blocks, with and without actions, raw and compressed
+	int RoundTrips();
+
+	//! A file that is still being written reads as empty
+	int Unclosed();
+
+	//! Files cut short, with a wrong header, index or block
+	int Corrupted();
+
+	//! Values that need all channel encodings: integers, runs, smooth, noisy and special doubles
+	void Generate(int observation_size, int action_size, size_t nof_samples, ColumnarPath &path);
+
+	//! Write a path to the file, with small blocks
+	bool Write(const ColumnarPath &path, TraceEncoding encoding);
+
+	//! Read the file back and compare it with the path
+	int Read(const ColumnarPath &path);
+
+	//! Change a byte of the file
+	void Corrupt(size_t position, uint8_t value);
+
+	//! Both matrices and the times are the same, bit for bit
+	static bool Equal(const ColumnarView &a, const ColumnarView &b);
+private:
+	std::string filename;
+};
+
+#endif /* TESTTRACE_H_ */
@@ -0,0 +1,154 @@
+/***************************************************************************************************
+ * @brief Alias sampling, reading and writing of transition tables
+ * @file TestTransition.cpp
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#include <TestTransition.h>
+#include <CounterRandom.h>
+
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <stdlib.h>
+#include <math.h>
+
+using namespace std;
+
+int TestTransition::Test() {
+	int failures = 0;
+	failures += Sampling();
+	failures += ReadWrite();
+	failures += Invalid();
+	return failures;
+}
+
+/**
+ * Row (s, a) has 1 + (s + a) % 8 outcomes, the first one with a small probability.
+ */
+void TestTransition::Generate(TransitionTable &table, size_t nof_states, size_t nof_actions) {
+	CounterRandom random(7);
+	table.Resize(nof_states, nof_actions);
+	for (size_t s = 0; s < nof_states; ++s) {
+		for (size_t a = 0; a < nof_actions; ++a) {
+			size_t n = 1 + (s + a) % 8;
+			std::vector<PROB_TYPE> weights(n);
+			PROB_TYPE sum = 0;
+			for (size_t k = 0; k < n; ++k) {
+				weights[k] = (k == 0 && n > 1) ? 0.001 : random.Uniform() + 0.01;
+				sum += weights[k];
+			}
+			for (size_t k = 0; k < n; ++k) {
+				table.Add(s, a, random.Bits() % nof_states, weights[k] / sum, (AP_TYPE)k - 2);
+			}
+		}
+	}
+}
+
+/**
+ * Per outcome the frequency should be within 5 standard deviations of its probability.
+ */
+int TestTransition::Sampling() {
+	int failures = 0;
+	TransitionTable table;
+	Generate(table, 5, 3);
+	failures += !table.Prepare();
+	CounterRandom random(11);
+	const int n = 200000;
+	for (size_t s = 0; s < table.getNofStates(); ++s) {
+		for (size_t a = 0; a < table.getNofActions(); ++a) {
+			const Transition *first = table.begin(s, a);
+			std::vector<int> counts(table.end(s, a) - first, 0);
+			AP_TYPE reward = 0;
+			for (int i = 0; i < n; ++i) {
+				const Transition &t = table.Sample(s, a, random.Uniform());
+				++counts[&t - first];
+				reward += t.reward;
+			}
+			for (size_t k = 0; k < counts.size(); ++k) {
+				PROB_TYPE p = first[k].probability;
+				failures += (fabs(counts[k] - n * p) > 5 * sqrt(n * p * (1 - p)) + 1);
+			}
+			failures += (fabs(reward / n - table.ExpectedReward(s, a)) > 0.05);
+		}
+	}
+	return failures;
+}
+
+int TestTransition::ReadWrite() {
+	int failures = 0;
+	TransitionTable table, copy;
+	Generate(table, 6, 4);
+	failures += !table.Prepare();
+	std::stringstream file;
+	file << "# a random table" << endl;
+	table.Write(file);
+	failures += !copy.Read(file);
+	failures += (copy.getNofStates() != 6) + (copy.getNofActions() != 4);
+	for (size_t s = 0; s < 6; ++s) {
+		for (size_t a = 0; a < 4; ++a) {
+			failures += (copy.end(s, a) - copy.begin(s, a) != table.end(s, a) - table.begin(s, a));
+			for (const Transition *t = table.begin(s, a), *u = copy.begin(s, a);
+					t != table.end(s, a) && u != copy.end(s, a); ++t, ++u) {
+				failures += (t->next != u->next) + (t->probability != u->probability) +
+						(t->reward != u->reward);
+			}
+			// the same numbers give the same draws
+			for (AP_TYPE x = 0; x < 1; x += 0.01) {
+				failures += (table.Sample(s, a, x).next != copy.Sample(s, a, x).next);
+			}
+		}
+	}
+	return failures;
+}
+
+/**
+ * These print messages on purpose.
+ */
+int TestTransition::Invalid() {
+	int failures = 0;
+	TransitionTable table(2, 1);
+	table.Add(0, 0, 1, 1, 0);
+	table.Add(1, 0, 0, 0.5, 0);
+	failures += table.Prepare();
+	table.Add(1, 0, 1, 0.5, 0);
+	failures += !table.Prepare();
+	failures += table.Add(2, 0, 0, 0.5, 0) + table.Add(0, 1, 0, 0.5, 0) + table.Add(0, 0, 2, 0.5, 0);
+	failures += table.Add(0, 0, 1, -0.5, 0) + table.Add(0, 0, 1, NAN, 0);
+	failures += !table.Prepare();
+
+	const char *malformed[] = { "states: 2\nactions: 1\nT: 0 : 2 : 0 1 0\n",
+			"states: 2\nactions: 1\nT: 0 : 0 : 0 1\n", "states: 1\nactions: 1\nR: 0 : 0 : 0 1\n" };
+	for (int i = 0; i < 3; ++i) {
+		std::istringstream file(malformed[i]);
+		failures += table.Read(file);
+	}
+	return failures;
+}
+
+int main() {
+	TestTransition tt;
+	int failures = tt.Test();
+	if (failures) {
+		cout << "There are " << failures << " failures" << endl;
+		return EXIT_FAILURE;
+	}
+	cout << "All transition table checks passed" << endl;
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,51 @@
+/***************************************************************************************************
+ * @brief Alias sampling, reading and writing of transition tables
+ * @file TestTransition.h
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#ifndef TESTTRANSITION_H_
+#define TESTTRANSITION_H_
+
+#include <TransitionTable.h>
+
+/**
+ * A random table of which the rows have from one to many outcomes, some of them with tiny
+ * probabilities. The draws of every row should follow its distribution, a table that is written
+ * and read back should be the same, and a table of which a row does not sum to one is refused.
+ */
+class TestTransition {
+public:
+	//! Returns the number of failed checks
+	int Test();
+protected:
+	//! Fill the table with random rows
+	void Generate(TransitionTable &table, size_t nof_states, size_t nof_actions);
+
+	//! Frequencies of the draws against the probabilities
+	int Sampling();
+
+	//! Write, read and compare
+	int ReadWrite();
+
+	//! Rows that do not sum to one, outcomes outside of the table, and malformed files
+	int Invalid();
+};
+
+#endif /* TESTTRANSITION_H_ */
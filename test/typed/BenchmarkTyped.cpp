@@ -0,0 +1,141 @@
+/***************************************************************************************************
+ * @brief Ticks per second of an embodiment through virtual calls and of a typed embodiment
+ * @file BenchmarkTyped.cpp
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#include <BenchmarkTyped.h>
+#include <Embodiment.h>
+#include <TypedEmbodiment.h>
+
+#include <iostream>
+#include <iomanip>
+#include <sys/time.h>
+
+using namespace std;
+
+//! The ways to tick: Embodiment, Step and TypedEmbodiment
+#define NOF_TYPED_RUNS 3
+
+void BanditEnvironment::DiscreteInit(std::vector<SymbolObservation> &observations,
+		std::vector<SymbolState> &states) {
+	for (size_t i = 0; i < states.size(); ++i) {
+		states[i][0] = i % 2;
+		observations[i][0] = 0;
+	}
+}
+
+static double now() {
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+/**
+ * Half of the systems is greedy and half is stubborn. Step can only tick systems of one type, so it
+ * gets all of them as greedy systems and its result is not compared.
+ */
+void BenchmarkTyped::Measure(size_t nof_systems, long int nof_ticks, double *durations,
+		AP_TYPE *results) {
+	std::vector<GreedySystem> greedy(nof_systems);
+	std::vector<StubbornSystem> stubborn(nof_systems / 2);
+	std::vector<GreedySystem*> greedy_group, all_greedy;
+	std::vector<StubbornSystem*> stubborn_group;
+	AP_SYSTEMS systems;
+	for (size_t i = 0; i < nof_systems - nof_systems / 2; ++i) {
+		greedy_group.push_back(&greedy[i]);
+		systems.push_back(&greedy[i]);
+	}
+	for (size_t i = 0; i < nof_systems / 2; ++i) {
+		stubborn_group.push_back(&stubborn[i]);
+		systems.push_back(&stubborn[i]);
+	}
+	for (size_t i = 0; i < nof_systems; ++i) {
+		all_greedy.push_back(&greedy[i]);
+	}
+	BanditEnvironment env;
+	double start;
+
+	Embodiment embodiment;
+	Coupling coupling;
+	embodiment.Couple(env, systems, coupling);
+	embodiment.Restart();
+	results[0] = 0;
+	start = now();
+	for (long int t = 0; t < nof_ticks; ++t) {
+		embodiment.Tick();
+		results[0] += env.GetDiscountedReward();
+	}
+	durations[0] = now() - start;
+
+	env.Restart();
+	env.Start(nof_systems);
+	results[1] = 0;
+	start = now();
+	for (long int t = 0; t < nof_ticks; ++t) {
+		env.Step(all_greedy);
+		results[1] += env.GetDiscountedReward();
+	}
+	durations[1] = now() - start;
+
+	TypedEmbodiment<BanditEnvironment, GreedySystem, StubbornSystem> typed;
+	typed.Couple(env, greedy_group, stubborn_group);
+	typed.Restart();
+	results[2] = 0;
+	start = now();
+	typed.Run(nof_ticks, [&](TypedEmbodiment<BanditEnvironment, GreedySystem, StubbornSystem> &) {
+		results[2] += env.GetDiscountedReward();
+	});
+	durations[2] = now() - start;
+}
+
+/**
+ * The systems and the environment are about as cheap as they get, so what is measured is mostly
+ * the overhead of the embodiment itself.
+ */
+int BenchmarkTyped::Run() {
+	int failures = 0;
+	size_t system_counts[] = { 2, 8, 64 };
+	cout << setw(8) << "systems" << setw(14) << "Embodiment" << setw(14) << "Step" << setw(14)
+			<< "Typed" << setw(10) << "speed-up" << endl;
+	for (int s = 0; s < 3; ++s) {
+		size_t nof_systems = system_counts[s];
+		long int nof_ticks = 20000000 / nof_systems;
+		double durations[NOF_TYPED_RUNS];
+		AP_TYPE results[NOF_TYPED_RUNS];
+		Measure(nof_systems, nof_ticks, durations, results);
+		cout << setw(8) << nof_systems;
+		for (int r = 0; r < NOF_TYPED_RUNS; ++r) {
+			cout << setw(14) << (long int)(nof_ticks / durations[r]);
+		}
+		cout << setw(10) << setprecision(3) << durations[0] / durations[2] << endl;
+		if (results[2] != results[0]) {
+			cerr << "Typed result differs: " << results[2] << " instead of " << results[0] << endl;
+			++failures;
+		}
+	}
+	return failures;
+}
+
+int main() {
+	BenchmarkTyped benchmark;
+	int failures = benchmark.Run();
+	cout << (failures ? "FAILED" : "OK") << endl;
+	return failures;
+}
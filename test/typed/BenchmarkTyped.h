@@ -0,0 +1,104 @@
+/***************************************************************************************************
+ * @brief Ticks per second of an embodiment through virtual calls and of a typed embodiment
+ * @file BenchmarkTyped.h
+ *
+ * This file is created at Almende B.V. It is open-source software and part of the Common Hybrid
+ * Agent Platform (CHAP). A toolbox with a lot of open-source tools, ranging from thread pools and
+ * TCP/IP components to control architectures and learning algorithms. This software is published
+ * under the GNU Lesser General Public license (LGPL).
+ *
+ * It is not possible to add usage restrictions to an open-source license. Nevertheless, we
+ * personally strongly object against this software used by the military, in the bio-industry, for
+ * animal experimentation, or anything that violates the Universal Declaration of Human Rights.
+ *
+ * Copyright © 2012 Anne van Rossum <anne@almende.com>
+ ***************************************************************************************************
+ * @author 	Anne C. van Rossum
+ * @date	Oct 18, 2026
+ * @project	Replicator FP7
+ * @company	Almende B.V. & Distributed Organisms B.V.
+ * @case	Self-organised criticality
+ **************************************************************************************************/
+
+#ifndef BENCHMARKTYPED_H_
+#define BENCHMARKTYPED_H_
+
+#include <System.h>
+#include <Environment.h>
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * A bandit with two arms per system, the arm that pays changes now and then. The observation is
+ * the arm that paid last. The random numbers are drawn from its own xorshift generator, so runs
+ * with the same seed are the same.
+ */
+class BanditEnvironment: public DiscreteEnvironment<BanditEnvironment, SYMBOL8_TYPE, 1, 1, 1> {
+public:
+	BanditEnvironment(): random(1) {}
+
+	void DiscreteInit(std::vector<SymbolObservation> &observations, std::vector<SymbolState> &states);
+
+	inline void DiscreteTick(const std::vector<SymbolAction> &actions,
+			std::vector<SymbolObservation> &observations, std::vector<SymbolState> &states) {
+		instantaneous_reward = 0;
+		for (size_t i = 0; i < actions.size(); ++i) {
+			random ^= random << 13;
+			random ^= random >> 7;
+			random ^= random << 17;
+			states[i][0] ^= ((random & 63) == 0);
+			AP_TYPE reward = (actions[i][0] == states[i][0]);
+			observations[i][0] = reward ? actions[i][0] : 1 - actions[i][0];
+			instantaneous_reward += reward;
+		}
+		discounted_reward = instantaneous_reward + 0.9 * discounted_reward;
+	}
+
+	void Restart() { Clear(); random = 1; }
+private:
+	uint64_t random;
+};
+
+//! Pulls the arm that paid last
+class GreedySystem: public DiscreteSystem<GreedySystem, SYMBOL8_TYPE, 1, 1> {
+public:
+	inline void DiscreteTick(const SymbolObservation &observation, AP_TYPE reward,
+			SymbolAction &action) {
+		action[0] = observation[0];
+	}
+
+	void Restart() {}
+};
+
+//! Keeps pulling the same arm as long as it pays
+class StubbornSystem: public DiscreteSystem<StubbornSystem, SYMBOL8_TYPE, 1, 1> {
+public:
+	StubbornSystem(): arm(0) {}
+
+	inline void DiscreteTick(const SymbolObservation &observation, AP_TYPE reward,
+			SymbolAction &action) {
+		if (reward == 0) arm = 1 - arm;
+		action[0] = arm;
+	}
+
+	void Restart() { arm = 0; }
+private:
+	SYMBOL8_TYPE arm;
+};
+
+/**
+ * Measures ticks per second of the same experiment through an Embodiment, which makes a virtual
+ * call per system and copies all values to vectors, through DiscreteEnvironment::Step, and through
+ * a TypedEmbodiment.
+ */
+class BenchmarkTyped {
+public:
+	//! Returns the number of runs of which the result differs from the one of the Embodiment
+	int Run();
+protected:
+	//! Times in seconds, the sums of the discounted rewards are the results
+	void Measure(size_t nof_systems, long int nof_ticks, double *durations, AP_TYPE *results);
+};
+
+#endif /* BENCHMARKTYPED_H_ */